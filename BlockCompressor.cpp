@@ -0,0 +1,221 @@
+/*
+* Licensed to the Apache Software Foundation (ASF) under one or more
+* contributor license agreements.  See the NOTICE file distributed with
+* this work for additional information regarding copyright ownership.
+* The ASF licenses this file to You under the Apache License, Version 2.0
+* (the "License"); you may not use this file except in compliance with
+* the License.  You may obtain a copy of the License at
+*
+*    http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+/**
+ * @file	BlockCompressor.cpp
+ * @author	Jichan (development@jc-lab.net / http://ablog.jc-lab.net/ )
+ * @date	2026/10/18
+ * @copyright Copyright (C) 2026 jichan.\n
+ *            This software may be modified and distributed under the terms
+ *            of the Apache License 2.0.  See the LICENSE file for details.
+ */
+
+#include "BlockCompressor.h"
+
+#include <string.h>
+
+namespace JsRPC {
+	namespace internal {
+
+		enum {
+			HASH_BITS = 12,
+			MIN_MATCH = 4,
+			// The last bytes of a block are always literals
+			LAST_LITERALS = 5,
+			// No match may start within this many bytes of the end
+			MATCH_FIND_LIMIT = 12
+		};
+
+		static inline uint32_t read32(const unsigned char *p)
+		{
+			uint32_t value;
+			memcpy(&value, p, 4);
+			return value;
+		}
+
+		static inline uint32_t hashSequence(uint32_t sequence)
+		{
+			return (sequence * 2654435761U) >> (32 - HASH_BITS);
+		}
+
+		static inline unsigned char *writeLength(unsigned char *op, size_t length)
+		{
+			while (length >= 255)
+			{
+				*op++ = 255;
+				length -= 255;
+			}
+			*op++ = (unsigned char)length;
+			return op;
+		}
+
+		static unsigned char *writeSequence(unsigned char *op, unsigned char *oend, const unsigned char *literals, size_t literalLength, size_t offset, size_t matchLength, bool last)
+		{
+			unsigned char *token;
+			size_t need = 1 + literalLength / 255 + 1 + literalLength + (last ? 0 : (2 + matchLength / 255 + 1));
+			if ((size_t)(oend - op) < need)
+				return NULL;
+
+			token = op++;
+			if (literalLength >= 15)
+			{
+				*token = 15 << 4;
+				op = writeLength(op, literalLength - 15);
+			}
+			else
+			{
+				*token = (unsigned char)(literalLength << 4);
+			}
+			memcpy(op, literals, literalLength);
+			op += literalLength;
+			if (last)
+				return op;
+
+			*op++ = (unsigned char)offset;
+			*op++ = (unsigned char)(offset >> 8);
+			if (matchLength >= 15)
+			{
+				*token |= 15;
+				op = writeLength(op, matchLength - 15);
+			}
+			else
+			{
+				*token |= (unsigned char)matchLength;
+			}
+			return op;
+		}
+
+		size_t BlockCompressor::compress(const unsigned char *src, size_t size, unsigned char *dst, size_t capacity)
+		{
+			uint16_t table[1 << HASH_BITS];
+			const unsigned char *ip = src;
+			const unsigned char *anchor = src;
+			const unsigned char *end = src + size;
+			unsigned char *op = dst;
+			unsigned char *oend = dst + capacity;
+
+			if (size > MAX_BLOCK_SIZE)
+				return 0;
+
+			if (size > MATCH_FIND_LIMIT)
+			{
+				const unsigned char *matchLimit = end - LAST_LITERALS;
+				const unsigned char *findLimit = end - MATCH_FIND_LIMIT;
+				memset(table, 0, sizeof(table));
+				ip++;
+				while (ip < findLimit)
+				{
+					uint32_t sequence = read32(ip);
+					uint32_t h = hashSequence(sequence);
+					const unsigned char *ref = src + table[h];
+					table[h] = (uint16_t)(ip - src);
+					if ((ref < ip) && (read32(ref) == sequence))
+					{
+						const unsigned char *mp = ip + MIN_MATCH;
+						const unsigned char *rp = ref + MIN_MATCH;
+						while ((mp < matchLimit) && (*mp == *rp))
+						{
+							mp++;
+							rp++;
+						}
+						op = writeSequence(op, oend, anchor, ip - anchor, ip - ref, mp - ip - MIN_MATCH, false);
+						if (!op)
+							return 0;
+						ip = mp;
+						anchor = ip;
+						continue;
+					}
+					ip++;
+				}
+			}
+
+			op = writeSequence(op, oend, anchor, end - anchor, 0, 0, true);
+			if (!op)
+				return 0;
+			return op - dst;
+		}
+
+		bool BlockCompressor::decompress(const unsigned char *src, size_t srcSize, unsigned char *dst, size_t size)
+		{
+			const unsigned char *ip = src;
+			const unsigned char *iend = src + srcSize;
+			unsigned char *op = dst;
+			unsigned char *oend = dst + size;
+
+			while (ip < iend)
+			{
+				unsigned char token = *ip++;
+				size_t literalLength = token >> 4;
+				size_t matchLength;
+				size_t offset;
+				unsigned char b;
+
+				if (literalLength == 15)
+				{
+					do {
+						if (ip >= iend)
+							return false;
+						b = *ip++;
+						literalLength += b;
+					} while (b == 255);
+				}
+				if ((literalLength > (size_t)(iend - ip)) || (literalLength > (size_t)(oend - op)))
+					return false;
+				memcpy(op, ip, literalLength);
+				op += literalLength;
+				ip += literalLength;
+				if (ip == iend)
+					break;
+
+				if (iend - ip < 2)
+					return false;
+				offset = (size_t)ip[0] | ((size_t)ip[1] << 8);
+				ip += 2;
+				if ((offset == 0) || (offset > (size_t)(op - dst)))
+					return false;
+
+				matchLength = token & 15;
+				if (matchLength == 15)
+				{
+					do {
+						if (ip >= iend)
+							return false;
+						b = *ip++;
+						matchLength += b;
+					} while (b == 255);
+				}
+				matchLength += MIN_MATCH;
+				if (matchLength > (size_t)(oend - op))
+					return false;
+
+				if (offset >= matchLength)
+				{
+					memcpy(op, op - offset, matchLength);
+					op += matchLength;
+				}
+				else
+				{
+					// Overlapping copy repeats the last offset bytes
+					const unsigned char *mp = op - offset;
+					while (matchLength--)
+						*op++ = *mp++;
+				}
+			}
+			return op == oend;
+		}
+
+	}
+}
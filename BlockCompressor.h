@@ -0,0 +1,58 @@
+/*
+* Licensed to the Apache Software Foundation (ASF) under one or more
+* contributor license agreements.  See the NOTICE file distributed with
+* this work for additional information regarding copyright ownership.
+* The ASF licenses this file to You under the Apache License, Version 2.0
+* (the "License"); you may not use this file except in compliance with
+* the License.  You may obtain a copy of the License at
+*
+*    http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+/**
+ * @file	BlockCompressor.h
+ * @author	Jichan (development@jc-lab.net / http://ablog.jc-lab.net/ )
+ * @date	2026/10/18
+ * @copyright Copyright (C) 2026 jichan.\n
+ *            This software may be modified and distributed under the terms
+ *            of the Apache License 2.0.  See the LICENSE file for details.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace JsRPC {
+	namespace internal {
+
+		// Byte-oriented LZ77 codec using the LZ4 block layout: token (literal
+		// length << 4 | match length - 4), extended lengths, literals, u16 offset.
+		// Greedy single-probe matching favours speed over ratio.
+		class BlockCompressor
+		{
+		public:
+			enum {
+				// Largest input compress() accepts; keeps offsets within 16 bits
+				MAX_BLOCK_SIZE = 65536
+			};
+
+			// Worst case output size for size bytes of input
+			static size_t bound(size_t size)
+			{
+				return size + size / 255 + 16;
+			}
+
+			// Returns the compressed size, or 0 if it does not fit in capacity
+			static size_t compress(const unsigned char *src, size_t size, unsigned char *dst, size_t capacity);
+			// Returns false unless src decodes to exactly size bytes
+			static bool decompress(const unsigned char *src, size_t srcSize, unsigned char *dst, size_t size);
+		};
+
+	}
+}
@@ -0,0 +1,203 @@
+/*
+* Licensed to the Apache Software Foundation (ASF) under one or more
+* contributor license agreements.  See the NOTICE file distributed with
+* this work for additional information regarding copyright ownership.
+* The ASF licenses this file to You under the Apache License, Version 2.0
+* (the "License"); you may not use this file except in compliance with
+* the License.  You may obtain a copy of the License at
+*
+*    http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+/**
+ * @file	Crc32c.cpp
+ * @author	Jichan (development@jc-lab.net / http://ablog.jc-lab.net/ )
+ * @date	2026/10/18
+ * @copyright Copyright (C) 2026 jichan.\n
+ *            This software may be modified and distributed under the terms
+ *            of the Apache License 2.0.  See the LICENSE file for details.
+ */
+
+#include "Crc32c.h"
+
+#include <string.h>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define JSRPC_CRC32C_X86 1
+#include <nmmintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+#define JSRPC_CRC32C_ARM 1
+#include <arm_acle.h>
+#endif
+
+namespace JsRPC {
+	namespace internal {
+
+		typedef uint32_t (*Crc32cUpdate)(uint32_t crc, const unsigned char *p, size_t size);
+
+		struct Crc32cTable
+		{
+			uint32_t t[8][256];
+
+			Crc32cTable()
+			{
+				uint32_t i;
+				int j;
+				for (i = 0; i < 256; i++)
+				{
+					uint32_t crc = i;
+					for (j = 0; j < 8; j++)
+						crc = (crc >> 1) ^ ((crc & 1) ? 0x82F63B78U : 0);
+					t[0][i] = crc;
+				}
+				for (i = 0; i < 256; i++)
+				{
+					for (j = 1; j < 8; j++)
+						t[j][i] = (t[j - 1][i] >> 8) ^ t[0][t[j - 1][i] & 0xFF];
+				}
+			}
+		};
+
+		static uint32_t updateTable(uint32_t crc, const unsigned char *p, size_t size)
+		{
+			static const Crc32cTable table;
+			const uint32_t (*t)[256] = table.t;
+			while (size && ((uintptr_t)p & 7))
+			{
+				crc = (crc >> 8) ^ t[0][(crc ^ *p++) & 0xFF];
+				size--;
+			}
+			while (size >= 8)
+			{
+				uint32_t lo;
+				uint32_t hi;
+				memcpy(&lo, p, 4);
+				memcpy(&hi, p + 4, 4);
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+				lo = __builtin_bswap32(lo);
+				hi = __builtin_bswap32(hi);
+#endif
+				lo ^= crc;
+				crc = t[7][lo & 0xFF] ^ t[6][(lo >> 8) & 0xFF] ^ t[5][(lo >> 16) & 0xFF] ^ t[4][lo >> 24]
+					^ t[3][hi & 0xFF] ^ t[2][(hi >> 8) & 0xFF] ^ t[1][(hi >> 16) & 0xFF] ^ t[0][hi >> 24];
+				p += 8;
+				size -= 8;
+			}
+			while (size--)
+				crc = (crc >> 8) ^ t[0][(crc ^ *p++) & 0xFF];
+			return crc;
+		}
+
+#if defined(JSRPC_CRC32C_X86)
+#if defined(__GNUC__)
+		__attribute__((target("sse4.2")))
+#endif
+		static uint32_t updateHardware(uint32_t crc, const unsigned char *p, size_t size)
+		{
+			while (size && ((uintptr_t)p & 7))
+			{
+				crc = _mm_crc32_u8(crc, *p++);
+				size--;
+			}
+#if defined(__x86_64__) || defined(_M_X64)
+			{
+				uint64_t crc64 = crc;
+				while (size >= 8)
+				{
+					uint64_t value;
+					memcpy(&value, p, 8);
+					crc64 = _mm_crc32_u64(crc64, value);
+					p += 8;
+					size -= 8;
+				}
+				crc = (uint32_t)crc64;
+			}
+#else
+			while (size >= 4)
+			{
+				uint32_t value;
+				memcpy(&value, p, 4);
+				crc = _mm_crc32_u32(crc, value);
+				p += 4;
+				size -= 4;
+			}
+#endif
+			while (size--)
+				crc = _mm_crc32_u8(crc, *p++);
+			return crc;
+		}
+
+		static bool detectHardware()
+		{
+#if defined(_MSC_VER)
+			int info[4];
+			__cpuid(info, 1);
+			return (info[2] & (1 << 20)) != 0;
+#elif defined(__GNUC__)
+			return __builtin_cpu_supports("sse4.2") != 0;
+#else
+			return false;
+#endif
+		}
+#elif defined(JSRPC_CRC32C_ARM)
+		static uint32_t updateHardware(uint32_t crc, const unsigned char *p, size_t size)
+		{
+			while (size && ((uintptr_t)p & 7))
+			{
+				crc = __crc32cb(crc, *p++);
+				size--;
+			}
+			while (size >= 8)
+			{
+				uint64_t value;
+				memcpy(&value, p, 8);
+				crc = __crc32cd(crc, value);
+				p += 8;
+				size -= 8;
+			}
+			while (size--)
+				crc = __crc32cb(crc, *p++);
+			return crc;
+		}
+
+		static bool detectHardware()
+		{
+			return true;
+		}
+#endif
+
+		static Crc32cUpdate selectUpdate()
+		{
+#if defined(JSRPC_CRC32C_X86) || defined(JSRPC_CRC32C_ARM)
+			if (detectHardware())
+				return updateHardware;
+#endif
+			return updateTable;
+		}
+
+		static Crc32cUpdate currentUpdate()
+		{
+			static const Crc32cUpdate update = selectUpdate();
+			return update;
+		}
+
+		uint32_t Crc32c::compute(const void *data, size_t size, uint32_t crc)
+		{
+			return ~currentUpdate()(~crc, (const unsigned char*)data, size);
+		}
+
+		bool Crc32c::hardwareAccelerated()
+		{
+			return currentUpdate() != updateTable;
+		}
+
+	}
+}
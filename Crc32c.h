@@ -0,0 +1,47 @@
+/*
+* Licensed to the Apache Software Foundation (ASF) under one or more
+* contributor license agreements.  See the NOTICE file distributed with
+* this work for additional information regarding copyright ownership.
+* The ASF licenses this file to You under the Apache License, Version 2.0
+* (the "License"); you may not use this file except in compliance with
+* the License.  You may obtain a copy of the License at
+*
+*    http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+/**
+ * @file	Crc32c.h
+ * @author	Jichan (development@jc-lab.net / http://ablog.jc-lab.net/ )
+ * @date	2026/10/18
+ * @copyright Copyright (C) 2026 jichan.\n
+ *            This software may be modified and distributed under the terms
+ *            of the Apache License 2.0.  See the LICENSE file for details.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace JsRPC {
+	namespace internal {
+
+		// CRC-32C (Castagnoli, reflected polynomial 0x82F63B78). Uses the SSE4.2
+		// crc32 instruction when the CPU has it and the ARMv8 CRC instructions
+		// when the target enables them; otherwise a slicing-by-8 table.
+		class Crc32c
+		{
+		public:
+			// Extends crc, the result of an earlier call (0 to start), over data
+			static uint32_t compute(const void *data, size_t size, uint32_t crc = 0);
+			// True if compute() runs on crc instructions
+			static bool hardwareAccelerated();
+		};
+
+	}
+}
@@ -0,0 +1,307 @@
+/*
+* Licensed to the Apache Software Foundation (ASF) under one or more
+* contributor license agreements.  See the NOTICE file distributed with
+* this work for additional information regarding copyright ownership.
+* The ASF licenses this file to You under the Apache License, Version 2.0
+* (the "License"); you may not use this file except in compliance with
+* the License.  You may obtain a copy of the License at
+*
+*    http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+/**
+ * @file	RPCCoroutine.h
+ * @author	Jichan (development@jc-lab.net / http://ablog.jc-lab.net/ )
+ * @date	2026/10/18
+ * @copyright Copyright (C) 2026 jichan.\n
+ *            This software may be modified and distributed under the terms
+ *            of the Apache License 2.0.  See the LICENSE file for details.
+ */
+
+#pragma once
+
+#include "Serializable.h"
+
+#if defined(__cpp_impl_coroutine) && (__cpp_impl_coroutine >= 201902L)
+
+#include <stddef.h>
+
+#include <coroutine>
+#include <exception>
+#include <optional>
+
+namespace JsRPC {
+
+	// Non-blocking byte stream driven by the caller's event loop
+	class RPCAsyncStream
+	{
+	public:
+		class ClosedException : public std::exception
+		{ };
+		// The payload does not fit the u32 length prefix
+		class MessageTooLargeException : public std::exception
+		{ };
+
+		virtual ~RPCAsyncStream() {}
+
+		// Return the number of bytes transferred, 0 if the call would block,
+		// or -1 once the stream is closed.
+		virtual ptrdiff_t readSome(unsigned char *data, size_t size) = 0;
+		virtual ptrdiff_t writeSome(const unsigned char *data, size_t size) = 0;
+
+		// Resume handle once readSome()/writeSome() can make progress (or the stream closes)
+		virtual void waitReadable(std::coroutine_handle<> handle) = 0;
+		virtual void waitWritable(std::coroutine_handle<> handle) = 0;
+	};
+
+	template<typename T = void>
+	class RPCTask;
+
+	namespace internal {
+		class RPCTaskPromiseBase
+		{
+		public:
+			struct FinalAwaiter {
+				bool await_ready() noexcept {
+					return false;
+				}
+				template<class TPromise>
+				std::coroutine_handle<> await_suspend(std::coroutine_handle<TPromise> handle) noexcept {
+					std::coroutine_handle<> continuation = handle.promise().continuation;
+					return continuation ? continuation : std::noop_coroutine();
+				}
+				void await_resume() noexcept {}
+			};
+
+			std::coroutine_handle<> continuation;
+			std::exception_ptr exception;
+
+			std::suspend_always initial_suspend() noexcept {
+				return std::suspend_always();
+			}
+			FinalAwaiter final_suspend() noexcept {
+				return FinalAwaiter();
+			}
+			void unhandled_exception() {
+				exception = std::current_exception();
+			}
+			void rethrowIfFailed() {
+				if (exception)
+					std::rethrow_exception(exception);
+			}
+		};
+
+		template<typename T>
+		class RPCTaskPromise : public RPCTaskPromiseBase
+		{
+		public:
+			std::optional<T> value;
+
+			RPCTask<T> get_return_object();
+			void return_value(T result) {
+				value.emplace(std::move(result));
+			}
+			T result() {
+				rethrowIfFailed();
+				return std::move(*value);
+			}
+		};
+
+		template<>
+		class RPCTaskPromise<void> : public RPCTaskPromiseBase
+		{
+		public:
+			RPCTask<void> get_return_object();
+			void return_void() {}
+			void result() {
+				rethrowIfFailed();
+			}
+		};
+
+		struct RPCReadableAwaiter {
+			RPCAsyncStream &stream;
+			bool await_ready() {
+				return false;
+			}
+			void await_suspend(std::coroutine_handle<> handle) {
+				stream.waitReadable(handle);
+			}
+			void await_resume() {}
+		};
+
+		struct RPCWritableAwaiter {
+			RPCAsyncStream &stream;
+			bool await_ready() {
+				return false;
+			}
+			void await_suspend(std::coroutine_handle<> handle) {
+				stream.waitWritable(handle);
+			}
+			void await_resume() {}
+		};
+	}
+
+	// Lazily started coroutine. co_await it from another coroutine, or call
+	// start() on the outermost task and poll done()/result() from the event loop.
+	template<typename T>
+	class RPCTask
+	{
+	public:
+		typedef internal::RPCTaskPromise<T> promise_type;
+
+	private:
+		std::coroutine_handle<promise_type> m_handle;
+
+		RPCTask(const RPCTask &obj);
+		RPCTask& operator=(const RPCTask &obj);
+
+	public:
+		explicit RPCTask(std::coroutine_handle<promise_type> handle) :
+			m_handle(handle)
+		{ }
+		RPCTask(RPCTask&& obj) noexcept :
+			m_handle(obj.m_handle)
+		{
+			obj.m_handle = nullptr;
+		}
+		~RPCTask() {
+			if (m_handle)
+				m_handle.destroy();
+		}
+
+		void start() {
+			if (m_handle && !m_handle.done())
+				m_handle.resume();
+		}
+		bool done() const {
+			return !m_handle || m_handle.done();
+		}
+		// Rethrows the exception the coroutine exited with
+		T result() {
+			return m_handle.promise().result();
+		}
+
+		struct Awaiter {
+			std::coroutine_handle<promise_type> handle;
+			bool await_ready() {
+				return handle.done();
+			}
+			std::coroutine_handle<> await_suspend(std::coroutine_handle<> continuation) {
+				handle.promise().continuation = continuation;
+				return handle;
+			}
+			T await_resume() {
+				return handle.promise().result();
+			}
+		};
+		Awaiter operator co_await() && {
+			return Awaiter{ m_handle };
+		}
+	};
+
+	template<typename T>
+	inline RPCTask<T> internal::RPCTaskPromise<T>::get_return_object() {
+		return RPCTask<T>(std::coroutine_handle< RPCTaskPromise<T> >::from_promise(*this));
+	}
+	inline RPCTask<void> internal::RPCTaskPromise<void>::get_return_object() {
+		return RPCTask<void>(std::coroutine_handle< RPCTaskPromise<void> >::from_promise(*this));
+	}
+
+	// Messages on the stream are framed as a u32 little endian length followed by
+	// the Serializable payload. The payload is read straight into a buffer of its
+	// final size as bytes arrive and decoded once complete; frames longer than
+	// maxSize are rejected with Serializable::ParseException before allocating.
+	// The whole payload is held in memory on both sides, so a frame is limited
+	// to what the u32 prefix can describe.
+	inline RPCTask<void> readMessage(RPCAsyncStream &stream, Serializable &message, size_t maxSize = 64 * 1024 * 1024)
+	{
+		unsigned char prefix[4];
+		std::vector<unsigned char> payload;
+		size_t length;
+		size_t pos = 0;
+		ptrdiff_t n;
+
+		while (pos < sizeof(prefix))
+		{
+			n = stream.readSome(prefix + pos, sizeof(prefix) - pos);
+			if (n < 0)
+				throw RPCAsyncStream::ClosedException();
+			if (n == 0)
+				co_await internal::RPCReadableAwaiter{ stream };
+			pos += (size_t)n;
+		}
+		length = (size_t)prefix[0] | ((size_t)prefix[1] << 8) | ((size_t)prefix[2] << 16) | ((size_t)prefix[3] << 24);
+		if (length > maxSize)
+			throw Serializable::ParseException();
+
+		payload.resize(length);
+		pos = 0;
+		while (pos < length)
+		{
+			n = stream.readSome(&payload[pos], length - pos);
+			if (n < 0)
+				throw RPCAsyncStream::ClosedException();
+			if (n == 0)
+				co_await internal::RPCReadableAwaiter{ stream };
+			pos += (size_t)n;
+		}
+		message.deserialize(payload.empty() ? NULL : &payload[0], payload.size());
+	}
+
+	template<class T>
+	RPCTask<T> readMessage(RPCAsyncStream &stream, size_t maxSize = 64 * 1024 * 1024)
+	{
+		T message;
+		co_await readMessage(stream, message, maxSize);
+		co_return std::move(message);
+	}
+
+	// Writes from the bytes freeze() returns, so a message with the encoded cache
+	// enabled goes out without being encoded or copied again. message must stay
+	// unchanged until the task completes. Payloads of 4 GiB or more cannot be
+	// framed and are rejected with MessageTooLargeException before anything is
+	// written.
+	inline RPCTask<void> writeMessage(RPCAsyncStream &stream, const Serializable &message)
+	{
+		SerializedPayload payload = message.freeze();
+		unsigned char prefix[4];
+		size_t length = payload.size();
+		size_t pos = 0;
+		ptrdiff_t n;
+
+		if ((uint64_t)length > 0xFFFFFFFFULL)
+			throw RPCAsyncStream::MessageTooLargeException();
+		prefix[0] = (unsigned char)length;
+		prefix[1] = (unsigned char)(length >> 8);
+		prefix[2] = (unsigned char)(length >> 16);
+		prefix[3] = (unsigned char)(length >> 24);
+		while (pos < sizeof(prefix))
+		{
+			n = stream.writeSome(prefix + pos, sizeof(prefix) - pos);
+			if (n < 0)
+				throw RPCAsyncStream::ClosedException();
+			if (n == 0)
+				co_await internal::RPCWritableAwaiter{ stream };
+			pos += (size_t)n;
+		}
+
+		pos = 0;
+		while (pos < length)
+		{
+			n = stream.writeSome(payload.data() + pos, length - pos);
+			if (n < 0)
+				throw RPCAsyncStream::ClosedException();
+			if (n == 0)
+				co_await internal::RPCWritableAwaiter{ stream };
+			pos += (size_t)n;
+		}
+	}
+
+}
+
+#endif
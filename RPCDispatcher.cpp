@@ -0,0 +1,238 @@
+/*
+* Licensed to the Apache Software Foundation (ASF) under one or more
+* contributor license agreements.  See the NOTICE file distributed with
+* this work for additional information regarding copyright ownership.
+* The ASF licenses this file to You under the Apache License, Version 2.0
+* (the "License"); you may not use this file except in compliance with
+* the License.  You may obtain a copy of the License at
+*
+*    http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+/**
+ * @file	RPCDispatcher.cpp
+ * @author	Jichan (development@jc-lab.net / http://ablog.jc-lab.net/ )
+ * @date	2026/10/18
+ * @copyright Copyright (C) 2026 jichan.\n
+ *            This software may be modified and distributed under the terms
+ *            of the Apache License 2.0.  See the LICENSE file for details.
+ */
+
+#include "RPCDispatcher.h"
+
+#include <string.h>
+
+namespace JsRPC {
+
+	namespace internal {
+		RPCRoute::RPCRoute(const Serializable &prototype) :
+			name(prototype.serializableGetName()),
+			serialVersionUID(prototype.serializableGetSerialVersionUID()),
+			hash(0)
+		{
+		}
+
+		RPCRoute::~RPCRoute()
+		{
+			for (std::vector<Serializable*>::iterator iter = m_requestPool.begin(); iter != m_requestPool.end(); iter++)
+				delete *iter;
+			for (std::vector<Serializable*>::iterator iter = m_responsePool.begin(); iter != m_responsePool.end(); iter++)
+				delete *iter;
+		}
+
+		Serializable *RPCRoute::acquireRequest()
+		{
+			{
+				std::unique_lock<std::mutex> lock(m_poolMutex);
+				if (!m_requestPool.empty())
+				{
+					Serializable *obj = m_requestPool.back();
+					m_requestPool.pop_back();
+					return obj;
+				}
+			}
+			return createRequest();
+		}
+
+		Serializable *RPCRoute::acquireResponse()
+		{
+			{
+				std::unique_lock<std::mutex> lock(m_poolMutex);
+				if (!m_responsePool.empty())
+				{
+					Serializable *obj = m_responsePool.back();
+					m_responsePool.pop_back();
+					return obj;
+				}
+			}
+			return createResponse();
+		}
+
+		void RPCRoute::release(Serializable *request, Serializable *response)
+		{
+			std::unique_lock<std::mutex> lock(m_poolMutex);
+			if (request)
+				m_requestPool.push_back(request);
+			if (response)
+				m_responsePool.push_back(response);
+		}
+
+		// Hands pooled objects back to the route even if the handler throws
+		class RPCRouteLease
+		{
+		private:
+			RPCRoute *m_route;
+
+		public:
+			Serializable *request;
+			Serializable *response;
+
+			RPCRouteLease(RPCRoute *route) :
+				m_route(route), request(NULL), response(NULL)
+			{
+				request = route->acquireRequest();
+				response = route->acquireResponse();
+			}
+			~RPCRouteLease()
+			{
+				m_route->release(request, response);
+			}
+		};
+	}
+
+	RPCDispatcher::RPCDispatcher() :
+		m_mask(0)
+	{
+	}
+
+	RPCDispatcher::~RPCDispatcher()
+	{
+		for (std::vector<internal::RPCRoute*>::iterator iter = m_routes.begin(); iter != m_routes.end(); iter++)
+			delete *iter;
+	}
+
+	uint32_t RPCDispatcher::routeHash(const char *name, size_t length, int64_t serialVersionUID)
+	{
+		uint32_t h = internal::MemberNameTable::hash(name, length);
+		h ^= (uint32_t)serialVersionUID ^ (uint32_t)((uint64_t)serialVersionUID >> 32);
+		// Spread the UID bits over the low bits used as the slot index
+		h ^= h >> 16;
+		h *= 0x85EBCA6BU;
+		h ^= h >> 13;
+		return h;
+	}
+
+	bool RPCDispatcher::addRoute(internal::RPCRoute *route)
+	{
+		if (findRoute(route->name.c_str(), route->name.length(), route->serialVersionUID))
+		{
+			delete route;
+			return false;
+		}
+		route->hash = routeHash(route->name.c_str(), route->name.length(), route->serialVersionUID);
+		m_routes.push_back(route);
+
+		// Keep the load factor at or below 1/2
+		size_t capacity = 8;
+		while (capacity < m_routes.size() * 2)
+			capacity <<= 1;
+		m_slots.assign(capacity, NULL);
+		m_mask = (uint32_t)(capacity - 1);
+		for (std::vector<internal::RPCRoute*>::const_iterator iter = m_routes.begin(); iter != m_routes.end(); iter++)
+		{
+			uint32_t slot = (*iter)->hash & m_mask;
+			while (m_slots[slot])
+				slot = (slot + 1) & m_mask;
+			m_slots[slot] = *iter;
+		}
+		return true;
+	}
+
+	internal::RPCRoute *RPCDispatcher::findRoute(const char *name, size_t length, int64_t serialVersionUID) const
+	{
+		if (m_slots.empty())
+			return NULL;
+		uint32_t h = routeHash(name, length, serialVersionUID);
+		uint32_t slot = h & m_mask;
+		internal::RPCRoute *route;
+		while ((route = m_slots[slot]) != NULL)
+		{
+			if ((route->hash == h) && (route->serialVersionUID == serialVersionUID) && (route->name.length() == length) && !memcmp(route->name.c_str(), name, length))
+				return route;
+			slot = (slot + 1) & m_mask;
+		}
+		return NULL;
+	}
+
+	bool RPCDispatcher::dispatch(const unsigned char *payload, size_t size, std::vector<unsigned char> &response) const JSRPC_THROWS(Serializable::ParseException, Serializable::UnavailableTypeException, HandlerNotFoundException)
+	{
+		response.clear();
+		return dispatchAppend(payload, size, response);
+	}
+
+	bool RPCDispatcher::dispatchEnvelope(const unsigned char *frame, size_t size, std::vector<unsigned char> &response) const JSRPC_THROWS(Serializable::ParseException)
+	{
+		RPCEnvelope envelope;
+		size_t headerPos;
+		bool oneway;
+		bool failed;
+
+		response.clear();
+
+		if (!RPCEnvelope::parse(frame, size, envelope) || (envelope.flags & RPCEnvelope::FLAG_RESPONSE))
+			throw Serializable::ParseException();
+		oneway = (envelope.flags & RPCEnvelope::FLAG_ONEWAY) != 0;
+
+		headerPos = RPCEnvelope::beginFrame(response, envelope.requestId, RPCEnvelope::FLAG_RESPONSE);
+		try {
+			// A one-way handler has nothing to answer a caller that waits for a response
+			failed = !dispatchAppend(envelope.payload, envelope.payloadSize, response);
+		} catch (...) {
+			failed = true;
+		}
+		// A failed one-way request has nobody to report to
+		if (oneway)
+		{
+			response.clear();
+			return false;
+		}
+		if (failed)
+		{
+			response.clear();
+			headerPos = RPCEnvelope::beginFrame(response, envelope.requestId, RPCEnvelope::FLAG_RESPONSE | RPCEnvelope::FLAG_ERROR);
+		}
+		RPCEnvelope::finishFrame(response, headerPos);
+		return true;
+	}
+
+	bool RPCDispatcher::dispatchAppend(const unsigned char *payload, size_t size, std::vector<unsigned char> &response) const
+	{
+		const char *name;
+		size_t nameLength;
+		int64_t serialVersionUID;
+		size_t headerSize;
+		internal::RPCRoute *route;
+
+		if (!Serializable::serializablePeekHeader(payload, size, &name, &nameLength, &serialVersionUID, &headerSize))
+			throw Serializable::ParseException();
+		route = findRoute(name, nameLength, serialVersionUID);
+		if (!route)
+			throw HandlerNotFoundException();
+
+		internal::RPCRouteLease lease(route);
+		lease.request->deserialize(payload, size);
+		if (lease.response)
+			lease.response->serializableClearObjects();
+		route->invoke(*lease.request, lease.response);
+		if (!lease.response)
+			return false;
+		lease.response->serializeAppend(response);
+		return true;
+	}
+
+}
@@ -0,0 +1,184 @@
+/*
+* Licensed to the Apache Software Foundation (ASF) under one or more
+* contributor license agreements.  See the NOTICE file distributed with
+* this work for additional information regarding copyright ownership.
+* The ASF licenses this file to You under the Apache License, Version 2.0
+* (the "License"); you may not use this file except in compliance with
+* the License.  You may obtain a copy of the License at
+*
+*    http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+/**
+ * @file	RPCDispatcher.h
+ * @author	Jichan (development@jc-lab.net / http://ablog.jc-lab.net/ )
+ * @date	2026/10/18
+ * @copyright Copyright (C) 2026 jichan.\n
+ *            This software may be modified and distributed under the terms
+ *            of the Apache License 2.0.  See the LICENSE file for details.
+ */
+
+#pragma once
+
+#include "Serializable.h"
+#include "RPCTransport.h"
+
+#include <functional>
+
+namespace JsRPC {
+
+	namespace internal {
+		// One registered request type. Request/response objects are pooled per
+		// route and reused across calls.
+		class RPCRoute
+		{
+		public:
+			std::string name;
+			int64_t serialVersionUID;
+			uint32_t hash;
+
+		private:
+			std::mutex m_poolMutex;
+			std::vector<Serializable*> m_requestPool;
+			std::vector<Serializable*> m_responsePool;
+
+			RPCRoute(const RPCRoute &obj);
+			RPCRoute& operator=(const RPCRoute &obj);
+
+		public:
+			RPCRoute(const Serializable &prototype);
+			virtual ~RPCRoute();
+
+			Serializable *acquireRequest();
+			Serializable *acquireResponse();
+			void release(Serializable *request, Serializable *response);
+
+			// response is NULL for one-way requests
+			virtual void invoke(Serializable &request, Serializable *response) = 0;
+
+		protected:
+			virtual Serializable *createRequest() = 0;
+			virtual Serializable *createResponse() = 0;
+		};
+
+		template<class TRequest, class TResponse>
+		class RPCRouteImpl : public RPCRoute
+		{
+		private:
+			std::function<void(const TRequest&, TResponse&)> m_handler;
+
+		public:
+			RPCRouteImpl(const TRequest &prototype, const std::function<void(const TRequest&, TResponse&)> &handler) :
+				RPCRoute(prototype), m_handler(handler)
+			{ }
+
+			void invoke(Serializable &request, Serializable *response) override {
+				m_handler(static_cast<const TRequest&>(request), *static_cast<TResponse*>(response));
+			}
+
+		protected:
+			Serializable *createRequest() override {
+				return new TRequest();
+			}
+			Serializable *createResponse() override {
+				return new TResponse();
+			}
+		};
+
+		template<class TRequest>
+		class RPCRouteImpl<TRequest, void> : public RPCRoute
+		{
+		private:
+			std::function<void(const TRequest&)> m_handler;
+
+		public:
+			RPCRouteImpl(const TRequest &prototype, const std::function<void(const TRequest&)> &handler) :
+				RPCRoute(prototype), m_handler(handler)
+			{ }
+
+			void invoke(Serializable &request, Serializable *response) override {
+				m_handler(static_cast<const TRequest&>(request));
+			}
+
+		protected:
+			Serializable *createRequest() override {
+				return new TRequest();
+			}
+			Serializable *createResponse() override {
+				return NULL;
+			}
+		};
+	}
+
+	// Routes encoded request payloads to handlers by class name/serialVersionUID.
+	// The header is hashed straight out of the frame and looked up in an open
+	// addressing table, so dispatch cost does not grow with the number of types.
+	// Register every handler before the dispatcher is shared between threads;
+	// after that dispatch() may run concurrently.
+	class RPCDispatcher
+	{
+	public:
+		class HandlerNotFoundException : public std::exception
+		{ };
+
+	private:
+		std::vector<internal::RPCRoute*> m_routes;
+		std::vector<internal::RPCRoute*> m_slots;
+		uint32_t m_mask;
+
+		RPCDispatcher(const RPCDispatcher &obj);
+		RPCDispatcher& operator=(const RPCDispatcher &obj);
+
+	public:
+		RPCDispatcher();
+		~RPCDispatcher();
+
+		// Returns false if a handler for this request type is already registered
+		template<class TRequest, class TResponse>
+		bool registerHandler(const std::function<void(const TRequest&, TResponse&)> &handler)
+		{
+			TRequest prototype;
+			return addRoute(new internal::RPCRouteImpl<TRequest, TResponse>(prototype, handler));
+		}
+		// One-way request: dispatch() produces an empty response
+		template<class TRequest>
+		bool registerHandler(const std::function<void(const TRequest&)> &handler)
+		{
+			TRequest prototype;
+			return addRoute(new internal::RPCRouteImpl<TRequest, void>(prototype, handler));
+		}
+
+		bool hasHandler(const char *name, size_t length, int64_t serialVersionUID) const {
+			return findRoute(name, length, serialVersionUID) != NULL;
+		}
+
+		// Decodes the request, runs its handler and encodes the response into
+		// response. response is cleared first but keeps its capacity, so keep one
+		// buffer per connection and pass it to every call.
+		// Returns false for one-way requests (response is left empty).
+		bool dispatch(const unsigned char *payload, size_t size, std::vector<unsigned char> &response) const JSRPC_THROWS(Serializable::ParseException, Serializable::UnavailableTypeException, HandlerNotFoundException);
+		bool dispatch(const std::vector<unsigned char> &payload, std::vector<unsigned char> &response) const JSRPC_THROWS(Serializable::ParseException, Serializable::UnavailableTypeException, HandlerNotFoundException) {
+			return dispatch(payload.empty() ? NULL : &payload[0], payload.size(), response);
+		}
+
+		// Server side of RPCPipeline: frame is an RPCEnvelope. response receives the
+		// response envelope carrying the same request id; a request this dispatcher
+		// cannot decode or has no handler for, whose handler throws, or that expects
+		// a response from a one-way handler, is answered with FLAG_ERROR. Only a
+		// malformed envelope throws.
+		// Returns false if nothing is to be sent back (one-way request).
+		bool dispatchEnvelope(const unsigned char *frame, size_t size, std::vector<unsigned char> &response) const JSRPC_THROWS(Serializable::ParseException);
+
+	private:
+		bool dispatchAppend(const unsigned char *payload, size_t size, std::vector<unsigned char> &response) const;
+		bool addRoute(internal::RPCRoute *route);
+		internal::RPCRoute *findRoute(const char *name, size_t length, int64_t serialVersionUID) const;
+		static uint32_t routeHash(const char *name, size_t length, int64_t serialVersionUID);
+	};
+
+}
@@ -0,0 +1,135 @@
+/*
+* Licensed to the Apache Software Foundation (ASF) under one or more
+* contributor license agreements.  See the NOTICE file distributed with
+* this work for additional information regarding copyright ownership.
+* The ASF licenses this file to You under the Apache License, Version 2.0
+* (the "License"); you may not use this file except in compliance with
+* the License.  You may obtain a copy of the License at
+*
+*    http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+/**
+ * @file	RPCPipeline.cpp
+ * @author	Jichan (development@jc-lab.net / http://ablog.jc-lab.net/ )
+ * @date	2026/10/18
+ * @copyright Copyright (C) 2026 jichan.\n
+ *            This software may be modified and distributed under the terms
+ *            of the Apache License 2.0.  See the LICENSE file for details.
+ */
+
+#include "RPCPipeline.h"
+
+namespace JsRPC {
+
+	RPCPipeline::RPCPipeline(RPCTransport &transport) :
+		m_transport(transport), m_nextRequestId(1), m_closed(false)
+	{
+	}
+
+	RPCPipeline::~RPCPipeline()
+	{
+		close();
+	}
+
+	void RPCPipeline::sendFrame(const Serializable &request, uint64_t requestId, uint8_t flags)
+	{
+		static thread_local std::vector<unsigned char> frame;
+		size_t headerPos;
+		frame.clear();
+		headerPos = RPCEnvelope::beginFrame(frame, requestId, flags);
+		request.serializeAppend(frame);
+		RPCEnvelope::finishFrame(frame, headerPos);
+		if (!m_transport.sendFrame(&frame[0], frame.size()))
+			throw ConnectionClosedException();
+	}
+
+	uint64_t RPCPipeline::send(const Serializable &request, const ResponseCallback &callback) JSRPC_THROWS(Serializable::UnavailableTypeException, ConnectionClosedException)
+	{
+		uint64_t requestId = m_nextRequestId++;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			if (m_closed)
+				throw ConnectionClosedException();
+			// Registered before sending so a fast response cannot miss it
+			m_pending[requestId] = callback;
+		}
+		try {
+			sendFrame(request, requestId, 0);
+		} catch (...) {
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_pending.erase(requestId);
+			throw;
+		}
+		return requestId;
+	}
+
+	void RPCPipeline::notify(const Serializable &request) JSRPC_THROWS(Serializable::UnavailableTypeException, ConnectionClosedException)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			if (m_closed)
+				throw ConnectionClosedException();
+		}
+		sendFrame(request, m_nextRequestId++, RPCEnvelope::FLAG_ONEWAY);
+	}
+
+	bool RPCPipeline::receive()
+	{
+		if (!m_transport.receiveFrame(m_receiveBuffer))
+		{
+			close();
+			return false;
+		}
+		if (!m_receiveBuffer.empty())
+			onFrame(&m_receiveBuffer[0], m_receiveBuffer.size());
+		return true;
+	}
+
+	bool RPCPipeline::onFrame(const unsigned char *frame, size_t size)
+	{
+		RPCEnvelope envelope;
+		ResponseCallback callback;
+		if (!RPCEnvelope::parse(frame, size, envelope))
+			return false;
+		if (!(envelope.flags & RPCEnvelope::FLAG_RESPONSE))
+			return false;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			std::map<uint64_t, ResponseCallback>::iterator iter = m_pending.find(envelope.requestId);
+			if (iter == m_pending.end())
+				return false;
+			callback.swap(iter->second);
+			m_pending.erase(iter);
+		}
+		if (envelope.flags & RPCEnvelope::FLAG_ERROR)
+			callback(STATUS_REMOTE_ERROR, NULL, 0);
+		else
+			callback(STATUS_OK, envelope.payload, envelope.payloadSize);
+		return true;
+	}
+
+	void RPCPipeline::close()
+	{
+		std::map<uint64_t, ResponseCallback> pending;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_closed = true;
+			pending.swap(m_pending);
+		}
+		for (std::map<uint64_t, ResponseCallback>::iterator iter = pending.begin(); iter != pending.end(); iter++)
+			iter->second(STATUS_CLOSED, NULL, 0);
+	}
+
+	size_t RPCPipeline::pendingCount() const
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		return m_pending.size();
+	}
+
+}
@@ -0,0 +1,123 @@
+/*
+* Licensed to the Apache Software Foundation (ASF) under one or more
+* contributor license agreements.  See the NOTICE file distributed with
+* this work for additional information regarding copyright ownership.
+* The ASF licenses this file to You under the Apache License, Version 2.0
+* (the "License"); you may not use this file except in compliance with
+* the License.  You may obtain a copy of the License at
+*
+*    http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+/**
+ * @file	RPCPipeline.h
+ * @author	Jichan (development@jc-lab.net / http://ablog.jc-lab.net/ )
+ * @date	2026/10/18
+ * @copyright Copyright (C) 2026 jichan.\n
+ *            This software may be modified and distributed under the terms
+ *            of the Apache License 2.0.  See the LICENSE file for details.
+ */
+
+#pragma once
+
+#include "Serializable.h"
+#include "RPCTransport.h"
+
+#include <functional>
+#include <future>
+#include <map>
+
+namespace JsRPC {
+
+	// Client side of a pipelined connection: any number of requests may be in
+	// flight, and responses complete them in whatever order they arrive.
+	// Responses are read by calling receive() (typically from one reader thread)
+	// or by handing frames to onFrame(); send()/call() may be used from any thread.
+	class RPCPipeline
+	{
+	public:
+		class RemoteErrorException : public std::exception
+		{ };
+		class ConnectionClosedException : public std::exception
+		{ };
+
+		enum Status {
+			STATUS_OK = 0,
+			STATUS_REMOTE_ERROR,
+			STATUS_CLOSED
+		};
+
+		// payload is NULL unless status is STATUS_OK. It is only valid during the call.
+		typedef std::function<void(Status status, const unsigned char *payload, size_t size)> ResponseCallback;
+
+	private:
+		RPCTransport &m_transport;
+		std::atomic<uint64_t> m_nextRequestId;
+		mutable std::mutex m_mutex;
+		std::map<uint64_t, ResponseCallback> m_pending;
+		bool m_closed;
+		std::vector<unsigned char> m_receiveBuffer;
+
+		RPCPipeline(const RPCPipeline &obj);
+		RPCPipeline& operator=(const RPCPipeline &obj);
+
+	public:
+		explicit RPCPipeline(RPCTransport &transport);
+		// Pending requests complete with STATUS_CLOSED
+		~RPCPipeline();
+
+		// Returns the request id. The callback runs on the thread that reads the response.
+		uint64_t send(const Serializable &request, const ResponseCallback &callback) JSRPC_THROWS(Serializable::UnavailableTypeException, ConnectionClosedException);
+		void notify(const Serializable &request) JSRPC_THROWS(Serializable::UnavailableTypeException, ConnectionClosedException);
+
+		// The future throws RemoteErrorException, ConnectionClosedException or
+		// Serializable::ParseException if no valid response arrives.
+		template<class TResponse>
+		std::future< std::shared_ptr<TResponse> > call(const Serializable &request) JSRPC_THROWS(Serializable::UnavailableTypeException, ConnectionClosedException)
+		{
+			std::shared_ptr< std::promise< std::shared_ptr<TResponse> > > promise = std::make_shared< std::promise< std::shared_ptr<TResponse> > >();
+			std::future< std::shared_ptr<TResponse> > future = promise->get_future();
+			send(request, [promise](Status status, const unsigned char *payload, size_t size) {
+				switch (status)
+				{
+				case STATUS_OK:
+					try {
+						std::shared_ptr<TResponse> response = std::make_shared<TResponse>();
+						response->deserialize(payload, size);
+						promise->set_value(response);
+					} catch (...) {
+						promise->set_exception(std::current_exception());
+					}
+					break;
+				case STATUS_REMOTE_ERROR:
+					promise->set_exception(std::make_exception_ptr(RemoteErrorException()));
+					break;
+				case STATUS_CLOSED:
+					promise->set_exception(std::make_exception_ptr(ConnectionClosedException()));
+					break;
+				}
+			});
+			return future;
+		}
+
+		// Reads one frame from the transport and completes its request.
+		// Returns false once the transport is closed; pending requests are failed then.
+		bool receive();
+		// Returns false if frame is not a response to a pending request
+		bool onFrame(const unsigned char *frame, size_t size);
+
+		// Fails every pending request with STATUS_CLOSED and rejects new ones
+		void close();
+
+		size_t pendingCount() const;
+
+	private:
+		void sendFrame(const Serializable &request, uint64_t requestId, uint8_t flags);
+	};
+
+}
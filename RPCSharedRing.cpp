@@ -0,0 +1,365 @@
+/*
+* Licensed to the Apache Software Foundation (ASF) under one or more
+* contributor license agreements.  See the NOTICE file distributed with
+* this work for additional information regarding copyright ownership.
+* The ASF licenses this file to You under the Apache License, Version 2.0
+* (the "License"); you may not use this file except in compliance with
+* the License.  You may obtain a copy of the License at
+*
+*    http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+/**
+ * @file	RPCSharedRing.cpp
+ * @author	Jichan (development@jc-lab.net / http://ablog.jc-lab.net/ )
+ * @date	2026/10/18
+ * @copyright Copyright (C) 2026 jichan.\n
+ *            This software may be modified and distributed under the terms
+ *            of the Apache License 2.0.  See the LICENSE file for details.
+ */
+
+#include "RPCSharedRing.h"
+
+#include <string.h>
+
+#include <new>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace JsRPC {
+
+	RPCSharedMemory::RPCSharedMemory() :
+		m_address(NULL), m_size(0)
+#if defined(_WIN32)
+		, m_handle(NULL)
+#endif
+	{
+	}
+
+	RPCSharedMemory::~RPCSharedMemory()
+	{
+		close();
+	}
+
+#if defined(_WIN32)
+	void RPCSharedMemory::create(const char *name, size_t size) JSRPC_THROWS(OpenFailedException)
+	{
+		MEMORY_BASIC_INFORMATION info;
+		SYSTEM_INFO system;
+		size_t pageMask;
+		bool existed;
+		close();
+		m_handle = ::CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, (DWORD)((uint64_t)size >> 32), (DWORD)size, name);
+		if (!m_handle)
+			throw OpenFailedException();
+		existed = (::GetLastError() == ERROR_ALREADY_EXISTS);
+		// An existing mapping keeps its size; map all of it to check that it matches
+		m_address = ::MapViewOfFile(m_handle, FILE_MAP_ALL_ACCESS, 0, 0, existed ? 0 : size);
+		if (!m_address)
+		{
+			close();
+			throw OpenFailedException();
+		}
+		if (existed)
+		{
+			::GetSystemInfo(&system);
+			pageMask = system.dwPageSize - 1;
+			if (!::VirtualQuery(m_address, &info, sizeof(info)) || (info.RegionSize != ((size + pageMask) & ~pageMask)))
+			{
+				close();
+				throw OpenFailedException();
+			}
+		}
+		m_size = size;
+	}
+
+	void RPCSharedMemory::open(const char *name) JSRPC_THROWS(OpenFailedException)
+	{
+		MEMORY_BASIC_INFORMATION info;
+		close();
+		m_handle = ::OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, name);
+		if (!m_handle)
+			throw OpenFailedException();
+		m_address = ::MapViewOfFile(m_handle, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+		if (!m_address || !::VirtualQuery(m_address, &info, sizeof(info)))
+		{
+			close();
+			throw OpenFailedException();
+		}
+		m_size = info.RegionSize;
+	}
+
+	void RPCSharedMemory::close()
+	{
+		if (m_address)
+			::UnmapViewOfFile(m_address);
+		if (m_handle)
+			::CloseHandle(m_handle);
+		m_address = NULL;
+		m_handle = NULL;
+		m_size = 0;
+	}
+
+	void RPCSharedMemory::unlink(const char *name)
+	{
+	}
+#else
+	void RPCSharedMemory::create(const char *name, size_t size) JSRPC_THROWS(OpenFailedException)
+	{
+		struct stat st;
+		int fd;
+		close();
+		fd = ::shm_open(name, O_RDWR | O_CREAT, 0600);
+		if (fd < 0)
+			throw OpenFailedException();
+		// A region that already exists keeps its size: resizing memory a peer
+		// has mapped would fault the peer
+		if ((::fstat(fd, &st) != 0) || ((st.st_size == 0) ? (::ftruncate(fd, (off_t)size) != 0) : (st.st_size != (off_t)size)))
+		{
+			::close(fd);
+			throw OpenFailedException();
+		}
+		m_address = ::mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+		::close(fd);
+		if (m_address == MAP_FAILED)
+		{
+			m_address = NULL;
+			throw OpenFailedException();
+		}
+		m_size = size;
+	}
+
+	void RPCSharedMemory::open(const char *name) JSRPC_THROWS(OpenFailedException)
+	{
+		struct stat st;
+		int fd;
+		close();
+		fd = ::shm_open(name, O_RDWR, 0600);
+		if (fd < 0)
+			throw OpenFailedException();
+		if ((::fstat(fd, &st) != 0) || (st.st_size <= 0))
+		{
+			::close(fd);
+			throw OpenFailedException();
+		}
+		m_address = ::mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+		::close(fd);
+		if (m_address == MAP_FAILED)
+		{
+			m_address = NULL;
+			throw OpenFailedException();
+		}
+		m_size = (size_t)st.st_size;
+	}
+
+	void RPCSharedMemory::close()
+	{
+		if (m_address)
+			::munmap(m_address, m_size);
+		m_address = NULL;
+		m_size = 0;
+	}
+
+	void RPCSharedMemory::unlink(const char *name)
+	{
+		::shm_unlink(name);
+	}
+#endif
+
+	namespace internal {
+		// Lives at the start of the shared memory. The atomics must be lock-free
+		// to work across processes, which they are for 64-bit values on every
+		// platform this library targets.
+		struct SharedRingHeader {
+			std::atomic<uint32_t> magic;
+			uint32_t version;
+			uint64_t capacity;
+			alignas(64) std::atomic<uint64_t> head;
+			alignas(64) std::atomic<uint64_t> tail;
+		};
+
+		static const uint32_t SHARED_RING_MAGIC = 0x474E524AU; // "JRNG"
+		static const uint32_t SHARED_RING_VERSION = 1;
+		// Length of a record that only skips to the start of the ring
+		static const uint32_t SHARED_RING_PADDING = 0xFFFFFFFFU;
+
+		static inline uint64_t alignRecord(uint64_t size)
+		{
+			return (size + 7) & ~(uint64_t)7;
+		}
+
+		static inline size_t ringDataOffset()
+		{
+			return (sizeof(SharedRingHeader) + 63) & ~(size_t)63;
+		}
+	}
+
+	size_t RPCSharedRing::requiredSize(size_t capacity)
+	{
+		return internal::ringDataOffset() + capacity;
+	}
+
+	RPCSharedRing::RPCSharedRing(void *memory, size_t size, bool initialize) JSRPC_THROWS(Serializable::ParseException) :
+		m_header((internal::SharedRingHeader*)memory),
+		m_data((unsigned char*)memory + internal::ringDataOffset()),
+		m_capacity(0), m_writePos(0), m_writeReserved(0), m_writeOpen(false), m_readPos(0), m_readRecordSize(0)
+	{
+		if (size < internal::ringDataOffset() + 64)
+			throw Serializable::ParseException();
+		if (initialize)
+		{
+			uint64_t capacity = 64;
+			while (capacity * 2 <= size - internal::ringDataOffset())
+				capacity *= 2;
+			new (m_header) internal::SharedRingHeader();
+			m_header->version = internal::SHARED_RING_VERSION;
+			m_header->capacity = capacity;
+			m_header->head.store(0, std::memory_order_relaxed);
+			m_header->tail.store(0, std::memory_order_relaxed);
+			m_header->magic.store(internal::SHARED_RING_MAGIC, std::memory_order_release);
+		}
+		else
+		{
+			// The creator may not have finished initializing; the caller retries
+			if ((m_header->magic.load(std::memory_order_acquire) != internal::SHARED_RING_MAGIC) || (m_header->version != internal::SHARED_RING_VERSION))
+				throw Serializable::ParseException();
+			if ((m_header->capacity & (m_header->capacity - 1)) || (m_header->capacity > size - internal::ringDataOffset()))
+				throw Serializable::ParseException();
+		}
+		m_capacity = m_header->capacity;
+		m_writePos = m_header->head.load(std::memory_order_acquire);
+		m_readPos = m_header->tail.load(std::memory_order_acquire);
+	}
+
+	size_t RPCSharedRing::maxMessageSize() const
+	{
+		return (size_t)(m_capacity - 8);
+	}
+
+	unsigned char *RPCSharedRing::beginWrite(size_t maxSize) JSRPC_THROWS(MessageTooLargeException)
+	{
+		uint64_t recordSize = internal::alignRecord(4 + (uint64_t)maxSize);
+		uint64_t head = m_header->head.load(std::memory_order_relaxed);
+		uint64_t tail = m_header->tail.load(std::memory_order_acquire);
+		uint64_t offset = head & (m_capacity - 1);
+		uint64_t contiguous = m_capacity - offset;
+		uint32_t length;
+
+		if (recordSize > m_capacity)
+			throw MessageTooLargeException();
+
+		if (contiguous < recordSize)
+		{
+			// Skip the tail end of the ring. The padding is published on its own so
+			// a record longer than the free space before the wrap can still go in
+			// once the consumer has caught up.
+			if (head + contiguous - tail > m_capacity)
+				return NULL;
+			length = internal::SHARED_RING_PADDING;
+			memcpy(m_data + offset, &length, 4);
+			head += contiguous;
+			m_header->head.store(head, std::memory_order_release);
+			offset = 0;
+		}
+		if (head + recordSize - tail > m_capacity)
+			return NULL;
+		m_writePos = head;
+		m_writeReserved = maxSize;
+		m_writeOpen = true;
+		return m_data + offset + 4;
+	}
+
+	void RPCSharedRing::commitWrite(size_t size) JSRPC_THROWS(MessageTooLargeException)
+	{
+		uint32_t length = (uint32_t)size;
+		// A longer record would run over space beginWrite() never checked
+		if (!m_writeOpen || (size > m_writeReserved))
+			throw MessageTooLargeException();
+		m_writeOpen = false;
+		memcpy(m_data + (m_writePos & (m_capacity - 1)), &length, 4);
+		m_header->head.store(m_writePos + internal::alignRecord(4 + (uint64_t)size), std::memory_order_release);
+	}
+
+	bool RPCSharedRing::tryWrite(const Serializable &message) JSRPC_THROWS(Serializable::UnavailableTypeException, MessageTooLargeException)
+	{
+		static thread_local std::vector<unsigned char> buffer;
+		unsigned char *slot;
+		message.serialize(buffer);
+		slot = beginWrite(buffer.size());
+		if (!slot)
+			return false;
+		if (!buffer.empty())
+			memcpy(slot, &buffer[0], buffer.size());
+		commitWrite(buffer.size());
+		return true;
+	}
+
+	const unsigned char *RPCSharedRing::peek(size_t *size) JSRPC_THROWS(Serializable::ParseException)
+	{
+		uint64_t tail = m_header->tail.load(std::memory_order_relaxed);
+		uint64_t head = m_header->head.load(std::memory_order_acquire);
+		while (tail != head)
+		{
+			uint64_t offset = tail & (m_capacity - 1);
+			uint64_t used = head - tail;
+			uint64_t recordSize;
+			uint32_t length;
+			// head and the record lengths come from the other process; nothing
+			// outside [tail, head) or past the end of the ring may be handed out
+			if ((used > m_capacity) || (used < 8) || (offset + 4 > m_capacity))
+				throw Serializable::ParseException();
+			memcpy(&length, m_data + offset, 4);
+			if (length == internal::SHARED_RING_PADDING)
+			{
+				if (m_capacity - offset > used)
+					throw Serializable::ParseException();
+				tail += m_capacity - offset;
+				m_header->tail.store(tail, std::memory_order_release);
+				continue;
+			}
+			recordSize = internal::alignRecord(4 + (uint64_t)length);
+			if ((recordSize > used) || (offset + 4 + (uint64_t)length > m_capacity))
+				throw Serializable::ParseException();
+			m_readPos = tail;
+			m_readRecordSize = (size_t)recordSize;
+			*size = length;
+			return m_data + offset + 4;
+		}
+		return NULL;
+	}
+
+	void RPCSharedRing::release()
+	{
+		m_header->tail.store(m_readPos + m_readRecordSize, std::memory_order_release);
+		m_readRecordSize = 0;
+	}
+
+	bool RPCSharedRing::tryRead(Serializable &message) JSRPC_THROWS(Serializable::ParseException)
+	{
+		size_t size;
+		const unsigned char *payload = peek(&size);
+		if (!payload)
+			return false;
+		try {
+			message.deserialize(payload, size);
+		} catch (...) {
+			release();
+			throw;
+		}
+		release();
+		return true;
+	}
+
+}
@@ -0,0 +1,138 @@
+/*
+* Licensed to the Apache Software Foundation (ASF) under one or more
+* contributor license agreements.  See the NOTICE file distributed with
+* this work for additional information regarding copyright ownership.
+* The ASF licenses this file to You under the Apache License, Version 2.0
+* (the "License"); you may not use this file except in compliance with
+* the License.  You may obtain a copy of the License at
+*
+*    http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+/**
+ * @file	RPCSharedRing.h
+ * @author	Jichan (development@jc-lab.net / http://ablog.jc-lab.net/ )
+ * @date	2026/10/18
+ * @copyright Copyright (C) 2026 jichan.\n
+ *            This software may be modified and distributed under the terms
+ *            of the Apache License 2.0.  See the LICENSE file for details.
+ */
+
+#pragma once
+
+#include "Serializable.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+
+namespace JsRPC {
+
+	// Named shared memory region (POSIX shm_open / Win32 file mapping)
+	class RPCSharedMemory
+	{
+	public:
+		class OpenFailedException : public std::exception
+		{ };
+
+	private:
+		void *m_address;
+		size_t m_size;
+#if defined(_WIN32)
+		void *m_handle;
+#endif
+
+		RPCSharedMemory(const RPCSharedMemory &obj);
+		RPCSharedMemory& operator=(const RPCSharedMemory &obj);
+
+	public:
+		RPCSharedMemory();
+		~RPCSharedMemory();
+
+		// Creates the region or opens it if it already exists. An existing region
+		// is never resized; a size mismatch throws OpenFailedException.
+		void create(const char *name, size_t size) JSRPC_THROWS(OpenFailedException);
+		// Opens a region another process created
+		void open(const char *name) JSRPC_THROWS(OpenFailedException);
+		void close();
+		// Removes the name; mappings stay valid until closed (no-op on Windows)
+		static void unlink(const char *name);
+
+		void *address() const {
+			return m_address;
+		}
+		size_t size() const {
+			return m_size;
+		}
+	};
+
+	namespace internal {
+		struct SharedRingHeader;
+	}
+
+	// Single-producer/single-consumer ring of length-framed payloads laid out in
+	// caller-provided memory, typically an RPCSharedMemory mapped by two processes.
+	// head and tail are monotonic 64-bit byte positions on separate cache lines;
+	// the producer only stores head and the consumer only stores tail, so neither
+	// side takes a lock. Exactly one thread may write and one may read.
+	class RPCSharedRing
+	{
+	public:
+		class MessageTooLargeException : public std::exception
+		{ };
+
+	private:
+		internal::SharedRingHeader *m_header;
+		unsigned char *m_data;
+		uint64_t m_capacity;
+		uint64_t m_writePos;
+		size_t m_writeReserved;
+		bool m_writeOpen;
+		uint64_t m_readPos;
+		size_t m_readRecordSize;
+
+		RPCSharedRing(const RPCSharedRing &obj);
+		RPCSharedRing& operator=(const RPCSharedRing &obj);
+
+	public:
+		// Bytes of memory needed for capacity bytes of ring (capacity is a power of two)
+		static size_t requiredSize(size_t capacity);
+
+		// The creating side passes initialize = true before the peer attaches
+		RPCSharedRing(void *memory, size_t size, bool initialize) JSRPC_THROWS(Serializable::ParseException);
+
+		// Producer.
+		// Encodes message and copies it into the ring in one step. Returns false
+		// if the ring does not have room right now.
+		bool tryWrite(const Serializable &message) JSRPC_THROWS(Serializable::UnavailableTypeException, MessageTooLargeException);
+		// Reserves maxSize bytes of contiguous ring memory, or returns NULL if
+		// the ring is full. Nothing is visible to the consumer until commitWrite(),
+		// which throws if size exceeds what beginWrite() reserved or nothing is
+		// reserved.
+		unsigned char *beginWrite(size_t maxSize) JSRPC_THROWS(MessageTooLargeException);
+		void commitWrite(size_t size) JSRPC_THROWS(MessageTooLargeException);
+
+		// Consumer.
+		// Decodes the next message straight from ring memory. Returns false if the
+		// ring is empty. The record is consumed even if decoding throws.
+		bool tryRead(Serializable &message) JSRPC_THROWS(Serializable::ParseException);
+		// Returns the next payload in place, or NULL if the ring is empty.
+		// It stays valid until release(). Throws if the producer left a length
+		// or position that does not fit the ring.
+		const unsigned char *peek(size_t *size) JSRPC_THROWS(Serializable::ParseException);
+		void release();
+
+		size_t capacity() const {
+			return (size_t)m_capacity;
+		}
+		// Largest payload beginWrite() accepts
+		size_t maxMessageSize() const;
+	};
+
+}
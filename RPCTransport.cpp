@@ -0,0 +1,124 @@
+/*
+* Licensed to the Apache Software Foundation (ASF) under one or more
+* contributor license agreements.  See the NOTICE file distributed with
+* this work for additional information regarding copyright ownership.
+* The ASF licenses this file to You under the Apache License, Version 2.0
+* (the "License"); you may not use this file except in compliance with
+* the License.  You may obtain a copy of the License at
+*
+*    http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+/**
+ * @file	RPCTransport.cpp
+ * @author	Jichan (development@jc-lab.net / http://ablog.jc-lab.net/ )
+ * @date	2026/10/18
+ * @copyright Copyright (C) 2026 jichan.\n
+ *            This software may be modified and distributed under the terms
+ *            of the Apache License 2.0.  See the LICENSE file for details.
+ */
+
+#include "RPCTransport.h"
+
+namespace JsRPC {
+
+	size_t RPCEnvelope::beginFrame(std::vector<unsigned char> &frame, uint64_t requestId, uint8_t flags)
+	{
+		size_t headerPos = frame.size();
+		int i;
+		frame.push_back('J');
+		frame.push_back('E');
+		frame.push_back(flags);
+		frame.push_back(VERSION);
+		for (i = 0; i < 8; i++)
+			frame.push_back((unsigned char)(requestId >> (i * 8)));
+		for (i = 0; i < 4; i++)
+			frame.push_back(0);
+		return headerPos;
+	}
+
+	void RPCEnvelope::finishFrame(std::vector<unsigned char> &frame, size_t headerPos)
+	{
+		uint32_t payloadSize = (uint32_t)(frame.size() - headerPos - HEADER_SIZE);
+		for (int i = 0; i < 4; i++)
+			frame[headerPos + 12 + i] = (unsigned char)(payloadSize >> (i * 8));
+	}
+
+	bool RPCEnvelope::parse(const unsigned char *frame, size_t size, RPCEnvelope &envelope)
+	{
+		uint32_t payloadSize = 0;
+		int i;
+		if (size < HEADER_SIZE)
+			return false;
+		if ((frame[0] != 'J') || (frame[1] != 'E') || (frame[3] != VERSION))
+			return false;
+		envelope.flags = frame[2];
+		envelope.requestId = 0;
+		for (i = 0; i < 8; i++)
+			envelope.requestId |= ((uint64_t)frame[4 + i]) << (i * 8);
+		for (i = 0; i < 4; i++)
+			payloadSize |= ((uint32_t)frame[12 + i]) << (i * 8);
+		if (payloadSize > size - HEADER_SIZE)
+			return false;
+		envelope.payload = frame + HEADER_SIZE;
+		envelope.payloadSize = payloadSize;
+		return true;
+	}
+
+	RPCMemoryTransport::RPCMemoryTransport() :
+		m_inbound(std::make_shared<Queue>())
+	{
+	}
+
+	void RPCMemoryTransport::connect(RPCMemoryTransport &peer)
+	{
+		m_outbound = peer.m_inbound;
+		peer.m_outbound = m_inbound;
+	}
+
+	bool RPCMemoryTransport::sendFrame(const unsigned char *data, size_t size)
+	{
+		std::shared_ptr<Queue> queue = m_outbound;
+		if (!queue)
+			return false;
+		std::unique_lock<std::mutex> lock(queue->mutex);
+		if (queue->closed)
+			return false;
+		queue->frames.push_back(std::vector<unsigned char>(data, data + size));
+		queue->cond.notify_one();
+		return true;
+	}
+
+	bool RPCMemoryTransport::receiveFrame(std::vector<unsigned char> &frame)
+	{
+		std::unique_lock<std::mutex> lock(m_inbound->mutex);
+		while (m_inbound->frames.empty() && !m_inbound->closed)
+			m_inbound->cond.wait(lock);
+		if (m_inbound->frames.empty())
+			return false;
+		frame.swap(m_inbound->frames.front());
+		m_inbound->frames.pop_front();
+		return true;
+	}
+
+	void RPCMemoryTransport::close()
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_inbound->mutex);
+			m_inbound->closed = true;
+			m_inbound->cond.notify_all();
+		}
+		if (m_outbound)
+		{
+			std::unique_lock<std::mutex> lock(m_outbound->mutex);
+			m_outbound->closed = true;
+			m_outbound->cond.notify_all();
+		}
+	}
+
+}
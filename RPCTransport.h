@@ -0,0 +1,118 @@
+/*
+* Licensed to the Apache Software Foundation (ASF) under one or more
+* contributor license agreements.  See the NOTICE file distributed with
+* this work for additional information regarding copyright ownership.
+* The ASF licenses this file to You under the Apache License, Version 2.0
+* (the "License"); you may not use this file except in compliance with
+* the License.  You may obtain a copy of the License at
+*
+*    http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+/**
+ * @file	RPCTransport.h
+ * @author	Jichan (development@jc-lab.net / http://ablog.jc-lab.net/ )
+ * @date	2026/10/18
+ * @copyright Copyright (C) 2026 jichan.\n
+ *            This software may be modified and distributed under the terms
+ *            of the Apache License 2.0.  See the LICENSE file for details.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <memory>
+
+namespace JsRPC {
+
+	// Optional wrapper around a Serializable payload that lets several requests
+	// share one connection:
+	//   'J' 'E' flags version, u64 requestId, u32 payloadSize (little endian), payload
+	class RPCEnvelope
+	{
+	public:
+		enum {
+			HEADER_SIZE = 16,
+			VERSION = 1
+		};
+		enum Flags {
+			FLAG_RESPONSE = 0x01,
+			// No response is expected
+			FLAG_ONEWAY = 0x02,
+			// Response only: the request could not be handled, payload is empty
+			FLAG_ERROR = 0x04
+		};
+
+		uint64_t requestId;
+		uint8_t flags;
+		const unsigned char *payload;
+		size_t payloadSize;
+
+		RPCEnvelope() :
+			requestId(0), flags(0), payload(NULL), payloadSize(0)
+		{ }
+
+		// Appends a header whose payloadSize is filled in by finishFrame()
+		static size_t beginFrame(std::vector<unsigned char> &frame, uint64_t requestId, uint8_t flags);
+		static void finishFrame(std::vector<unsigned char> &frame, size_t headerPos);
+
+		// payload points into frame. Returns false if frame is not an envelope.
+		static bool parse(const unsigned char *frame, size_t size, RPCEnvelope &envelope);
+	};
+
+	// Message-oriented connection. Frames are delivered whole and in order.
+	// sendFrame() may be called from several threads at once.
+	class RPCTransport
+	{
+	public:
+		virtual ~RPCTransport() {}
+
+		// Returns false once the connection is closed
+		virtual bool sendFrame(const unsigned char *data, size_t size) = 0;
+		// Blocks until a frame arrives. Returns false once the connection is closed.
+		virtual bool receiveFrame(std::vector<unsigned char> &frame) = 0;
+		virtual void close() = 0;
+	};
+
+	// In-process transport; connect() two instances to get both ends of a connection
+	class RPCMemoryTransport : public RPCTransport
+	{
+	private:
+		struct Queue {
+			std::mutex mutex;
+			std::condition_variable cond;
+			std::deque< std::vector<unsigned char> > frames;
+			bool closed;
+
+			Queue() : closed(false) {}
+		};
+
+		std::shared_ptr<Queue> m_inbound;
+		std::shared_ptr<Queue> m_outbound;
+
+		RPCMemoryTransport(const RPCMemoryTransport &obj);
+		RPCMemoryTransport& operator=(const RPCMemoryTransport &obj);
+
+	public:
+		RPCMemoryTransport();
+
+		void connect(RPCMemoryTransport &peer);
+
+		bool sendFrame(const unsigned char *data, size_t size) override;
+		bool receiveFrame(std::vector<unsigned char> &frame) override;
+		// Closes both directions; the peer drains queued frames and then sees the close
+		void close() override;
+	};
+
+}
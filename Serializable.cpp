@@ -24,20 +24,298 @@
  */
  
 #include "Serializable.h"
+#include "BlockCompressor.h"
+#include "Crc32c.h"
+#include "StringInterner.h"
+
+#include <new>
+#include <cstddef>
+#include <map>
+#include <typeinfo>
+#include <typeindex>
 
 namespace JsRPC {
 
+	namespace internal {
+		class ArenaState
+		{
+		private:
+			std::atomic<long> m_refs;
+			size_t m_chunkSize;
+			std::vector<unsigned char*> m_chunks;
+			unsigned char *m_cur;
+			size_t m_remain;
+			size_t m_reserved;
+
+		public:
+			explicit ArenaState(size_t chunkSize) :
+				m_refs(1), m_chunkSize(chunkSize), m_cur(NULL), m_remain(0), m_reserved(0)
+			{
+			}
+			~ArenaState()
+			{
+				for (std::vector<unsigned char*>::iterator iter = m_chunks.begin(); iter != m_chunks.end(); iter++)
+					::operator delete(*iter);
+			}
+
+			void *allocate(size_t size)
+			{
+				const size_t align = alignof(std::max_align_t);
+				void *ptr;
+				size = (size + align - 1) & ~(align - 1);
+				if (size > m_remain)
+				{
+					size_t chunkSize = (size > m_chunkSize) ? size : m_chunkSize;
+					m_cur = (unsigned char*)::operator new(chunkSize);
+					m_chunks.push_back(m_cur);
+					m_remain = chunkSize;
+					m_reserved += chunkSize;
+				}
+				ptr = m_cur;
+				m_cur += size;
+				m_remain -= size;
+				return ptr;
+			}
+			size_t reserved() const {
+				return m_reserved;
+			}
+
+			void addRef() {
+				m_refs.fetch_add(1, std::memory_order_relaxed);
+			}
+			void release() {
+				if (m_refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+					delete this;
+			}
+		};
+
+		static thread_local ArenaState *currentArena = NULL;
+
+		// Every Serializable allocation is prefixed with the arena it came from
+		// (NULL for the global heap).
+		static const size_t allocTagSize = alignof(std::max_align_t);
+	}
+
+	SerializableArena::SerializableArena(size_t chunkSize) :
+		m_state(new internal::ArenaState(chunkSize))
+	{
+	}
+
+	SerializableArena::~SerializableArena()
+	{
+		m_state->release();
+	}
+
+	size_t SerializableArena::bytesReserved() const
+	{
+		return m_state->reserved();
+	}
+
+	SerializableArena::Scope::Scope(SerializableArena &arena) :
+		m_prev(internal::currentArena)
+	{
+		internal::currentArena = arena.m_state;
+	}
+
+	SerializableArena::Scope::~Scope()
+	{
+		internal::currentArena = m_prev;
+	}
+
+	void *Serializable::operator new(size_t size)
+	{
+		internal::ArenaState *arena = internal::currentArena;
+		unsigned char *block;
+		if (arena)
+		{
+			block = (unsigned char*)arena->allocate(internal::allocTagSize + size);
+			arena->addRef();
+		}
+		else
+		{
+			block = (unsigned char*)::operator new(internal::allocTagSize + size);
+		}
+		*(internal::ArenaState**)block = arena;
+		return block + internal::allocTagSize;
+	}
+
+	void Serializable::operator delete(void *ptr)
+	{
+		unsigned char *block;
+		internal::ArenaState *arena;
+		if (!ptr)
+			return;
+		block = (unsigned char*)ptr - internal::allocTagSize;
+		arena = *(internal::ArenaState**)block;
+		if (arena)
+			arena->release();
+		else
+			::operator delete(block);
+	}
+
 	const unsigned char Serializable::header[] = { 'J', 0x18, 'R', 'S', 0x00, 0x01 };
 
-	Serializable::Serializable(const char *name, int64_t serialVersionUID)
+	namespace internal {
+		enum {
+			HEADER_FLAGS_POS = 4,
+			HEADER_KNOWN_FLAGS = Serializable::HEADER_FLAG_COMPRESSED | Serializable::HEADER_FLAG_STRING_TABLE | Serializable::HEADER_FLAG_CHECKSUM,
+			COMPRESS_BLOCK_SIZE = BlockCompressor::MAX_BLOCK_SIZE,
+			CHECKSUM_SIZE = 4,
+			// Larger decompression buffers are not kept for the next payload
+			DECOMPRESS_RETAIN_SIZE = 4 * COMPRESS_BLOCK_SIZE
+		};
+		// Set in a compressed block's size word when the block is stored as is
+		static const uint32_t COMPRESS_BLOCK_STORED = 0x80000000U;
+
+		// Like memcmp against Serializable::header, but byte 4 may carry known flags
+		static bool matchHeader(const unsigned char *payload, const unsigned char *header, size_t length)
+		{
+			for (size_t i = 0; i < length; i++)
+			{
+				if (i == HEADER_FLAGS_POS)
+				{
+					if (payload[i] & ~HEADER_KNOWN_FLAGS)
+						return false;
+				}
+				else if (payload[i] != header[i])
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+
+		// Sets the checksum flag of the payload that starts at start and appends
+		// the CRC-32C of everything from start on
+		static void appendChecksum(std::vector<unsigned char>& payload, size_t start)
+		{
+			uint32_t crc;
+			payload[start + HEADER_FLAGS_POS] |= Serializable::HEADER_FLAG_CHECKSUM;
+			crc = Crc32c::compute(&payload[start], payload.size() - start);
+			payload.resize(payload.size() + CHECKSUM_SIZE);
+			memcpy(&payload[payload.size() - CHECKSUM_SIZE], &crc, CHECKSUM_SIZE);
+		}
+
+		static bool verifyChecksum(const unsigned char *payload, size_t size)
+		{
+			uint32_t crc;
+			memcpy(&crc, &payload[size - CHECKSUM_SIZE], CHECKSUM_SIZE);
+			return Crc32c::compute(payload, size - CHECKSUM_SIZE) == crc;
+		}
+
+		// Set while SerializeOptions::checksumNested encodes on this thread
+		static thread_local bool checksumNested = false;
+
+		class ChecksumNestedScope
+		{
+		private:
+			bool m_prev;
+
+		public:
+			explicit ChecksumNestedScope(bool enable) :
+				m_prev(checksumNested)
+			{
+				checksumNested = enable;
+			}
+			~ChecksumNestedScope()
+			{
+				checksumNested = m_prev;
+			}
+		};
+
+		static thread_local const DeserializeOptions *currentDeserializeOptions = NULL;
+		static thread_local unsigned int deserializeDepth = 0;
+
+		class DeserializeOptionsScope
+		{
+		private:
+			const DeserializeOptions *m_prevOptions;
+			unsigned int m_prevDepth;
+
+		public:
+			explicit DeserializeOptionsScope(const DeserializeOptions &options) :
+				m_prevOptions(currentDeserializeOptions), m_prevDepth(deserializeDepth)
+			{
+				currentDeserializeOptions = &options;
+				deserializeDepth = 0;
+			}
+			~DeserializeOptionsScope()
+			{
+				currentDeserializeOptions = m_prevOptions;
+				deserializeDepth = m_prevDepth;
+			}
+		};
+
+		// One deserialize() call; the first on the thread decodes the outer frame
+		class DeserializeFrame
+		{
+		private:
+			bool m_outer;
+
+		public:
+			DeserializeFrame() :
+				m_outer(deserializeDepth == 0)
+			{
+				deserializeDepth++;
+			}
+			~DeserializeFrame()
+			{
+				deserializeDepth--;
+			}
+
+			bool verifyChecksum() const {
+				return m_outer || !currentDeserializeOptions || currentDeserializeOptions->verifyNestedChecksums;
+			}
+			bool requireChecksum() const {
+				return m_outer && currentDeserializeOptions && currentDeserializeOptions->requireChecksum;
+			}
+		};
+	}
+
+	Serializable::Serializable(const char *name, int64_t serialVersionUID) :
+		m_cacheParent(NULL)
+		, m_cacheEnabled(false)
+		, m_cacheable(true)
+		, m_generation(0)
+		, m_cacheGeneration(0)
+		, m_membersMissing(0)
+		, m_nameTable(NULL)
 	{
 		m_name = name;
 		m_serialVersionUID = serialVersionUID;
 	}
 
-	Serializable::~Serializable()
+	Serializable::Serializable(const Serializable &obj) :
+		m_name(obj.m_name)
+		, m_serialVersionUID(obj.m_serialVersionUID)
+		, m_cacheParent(NULL)
+		, m_cacheEnabled(obj.m_cacheEnabled.load(std::memory_order_relaxed))
+		, m_cacheable(true)
+		, m_generation(0)
+		, m_cacheGeneration(0)
+		, m_membersMissing(obj.m_members.size() + obj.m_membersMissing)
+		, m_nameTable(obj.m_nameTable.load(std::memory_order_acquire))
+	{
+	}
+
+#if (__cplusplus >= 201103) || (__cplusplus == 199711) || (defined(HAS_MOVE_SEMANTICS) && HAS_MOVE_SEMANTICS == 1)
+	Serializable::Serializable(Serializable&& obj) :
+		m_name(obj.m_name)
+		, m_serialVersionUID(obj.m_serialVersionUID)
+		, m_cacheParent(NULL)
+		, m_cacheEnabled(obj.m_cacheEnabled.load(std::memory_order_relaxed))
+		, m_cacheable(true)
+		, m_generation(0)
+		, m_cacheGeneration(0)
+		, m_membersMissing(obj.m_members.size() + obj.m_membersMissing)
+		, m_nameTable(obj.m_nameTable.load(std::memory_order_acquire))
 	{
+		obj.serializableInvalidateCache();
+	}
+#endif
 
+	Serializable::~Serializable()
+	{
 	}
 
 	template<typename T>
@@ -58,8 +336,29 @@ namespace JsRPC {
 		}
 	}
 
+	// Read-only window on an encoded payload. Nested objects are decoded straight
+	// out of the parent's buffer instead of a copied sub-vector.
+	class PayloadView
+	{
+	private:
+		const unsigned char *m_data;
+		size_t m_size;
+
+	public:
+		PayloadView(const unsigned char *data, size_t size) :
+			m_data(data), m_size(size)
+		{
+		}
+		size_t size() const {
+			return m_size;
+		}
+		const unsigned char &operator[](size_t index) const {
+			return m_data[index];
+		}
+	};
+
 	template<typename T>
-	static T readFromPayload(const std::vector<unsigned char>& payload, uint32_t *pos)
+	static T readFromPayload(const PayloadView& payload, uint32_t *pos)
 	{
 		size_t ds = sizeof(T);
 		size_t remainsize = payload.size() - *pos;
@@ -74,7 +373,7 @@ namespace JsRPC {
 		return value;
 	}
 
-	static void readFromPayload(const std::vector<unsigned char>& payload, uint32_t *pos, void *ptr, uint32_t length)
+	static void readFromPayload(const PayloadView& payload, uint32_t *pos, void *ptr, uint32_t length)
 	{
 		size_t ds = length;
 		size_t remainsize = payload.size() - *pos;
@@ -97,38 +396,71 @@ namespace JsRPC {
 		writePtrToPayload(payload, data, sizeof(T));
 	}
 	static void writeElementToPayload(std::vector<unsigned char>& payload, const bool *data) {
-		payload.push_back((unsigned char)(data ? 1 : 0));
+		payload.push_back((unsigned char)(*data ? 1 : 0));
 	}
 	static void writeElementToPayload(std::vector<unsigned char>& payload, const Serializable *data) {
 		if (data) {
-			std::vector<unsigned char> subpayload;
-			data->serialize(subpayload);
-			writeArrayElementSize(payload, subpayload.size());
-			payload.insert(payload.end(), subpayload.begin(), subpayload.end());
+			// Encode the sub-payload in place and patch its size afterwards
+			size_t sizePos = payload.size();
+			uint32_t size;
+			writeArrayElementSize(payload, 0);
+			data->serializeAppend(payload);
+			if (internal::checksumNested)
+				internal::appendChecksum(payload, sizePos + sizeof(size));
+			size = (uint32_t)(payload.size() - sizePos - sizeof(size));
+			memcpy(&payload[sizePos], &size, sizeof(size));
 		} else {
 			writeArrayElementSize(payload, 0);
 		}
 	}
 
 	template<typename T>
-	static void readElementFromPayload(const std::vector<unsigned char>& payload, uint32_t *pos, T *data) {
+	static void readElementFromPayload(const PayloadView& payload, uint32_t *pos, T *data) {
 		*data = readFromPayload<T>(payload, pos);
 	}
 	template<>
-	static void readElementFromPayload<bool>(const std::vector<unsigned char>& payload, uint32_t *pos, bool *data) {
+	static void readElementFromPayload<bool>(const PayloadView& payload, uint32_t *pos, bool *data) {
 		*data = readFromPayload<unsigned char>(payload, pos) ? true : false;
 	}
 	template<>
-	static void readElementFromPayload<Serializable>(const std::vector<unsigned char>& payload, uint32_t *pos, Serializable *data) {
-		std::vector<unsigned char> subpayload;
+	static void readElementFromPayload<Serializable>(const PayloadView& payload, uint32_t *pos, Serializable *data) {
 		uint32_t size = readFromPayload<uint32_t>(payload, pos);
-		const unsigned char *endptr = (const unsigned char*)&payload[*pos];
-		endptr += size;
-		subpayload.insert(subpayload.end(), (const unsigned char*)&payload[*pos], endptr);
-		data->deserialize(subpayload);
+		size_t remainsize = payload.size() - *pos;
+		if (remainsize < size)
+			throw Serializable::ParseException();
+		data->deserialize(&payload[*pos], size);
 		*pos += size;
 	}
 
+	// Object for the nested payload at *pos, made by createFactory or, if the
+	// member has none, by the registered factory for the nested header.
+	// An empty nested payload gives NULL.
+	static JsCPPUtils::SmartPointer<Serializable> readNestedFromPayload(const PayloadView& payload, uint32_t *pos, SerializableCreateFactory *createFactory)
+	{
+		uint32_t size;
+		uint32_t peekPos = *pos;
+		size = readFromPayload<uint32_t>(payload, &peekPos);
+		if (size == 0)
+		{
+			*pos = peekPos;
+			return JsCPPUtils::SmartPointer<Serializable>();
+		}
+		if (!createFactory)
+		{
+			const char *name;
+			size_t nameLength;
+			int64_t serialVersionUID;
+			if ((payload.size() - peekPos < size) || !Serializable::serializablePeekHeader(&payload[peekPos], size, &name, &nameLength, &serialVersionUID, NULL))
+				throw Serializable::ParseException();
+			createFactory = SerializableTypeRegistry::find(name, nameLength, serialVersionUID);
+			if (!createFactory)
+				throw Serializable::UnavailableTypeException();
+		}
+		JsCPPUtils::SmartPointer<Serializable> obj = createFactory->create();
+		readElementFromPayload(payload, pos, obj.getPtr());
+		return obj;
+	}
+
 	template <typename T>
 	static void writeElementArrayToPayload(std::vector<unsigned char>& payload, const T* data, size_t length)
 	{
@@ -137,7 +469,7 @@ namespace JsRPC {
 	}
 
 	template <typename T>
-	static void readElementArrayFromPayload(const std::vector<unsigned char>& payload, uint32_t *pos, T* data, size_t length)
+	static void readElementArrayFromPayload(const PayloadView& payload, uint32_t *pos, T* data, size_t length)
 	{
 		uint32_t size = readFromPayload<uint32_t>(payload, pos);
 		if (length != size)
@@ -145,7 +477,7 @@ namespace JsRPC {
 		readFromPayload(payload, pos, data, size * sizeof(T));
 	}
 	template <>
-	static void readElementArrayFromPayload<bool>(const std::vector<unsigned char>& payload, uint32_t *pos, bool* data, size_t length)
+	static void readElementArrayFromPayload<bool>(const PayloadView& payload, uint32_t *pos, bool* data, size_t length)
 	{
 		uint32_t size = readFromPayload<uint32_t>(payload, pos);
 		size_t ds = length;
@@ -159,7 +491,7 @@ namespace JsRPC {
 			uint32_t i;
 			for (i = 0; i < size; i++)
 			{
-				data[i] = payload[*(pos++)] ? true : false;
+				data[i] = payload[(*pos)++] ? true : false;
 			}
 		}
 	}
@@ -171,7 +503,7 @@ namespace JsRPC {
 		writePtrToPayload(payload, (const T*)data->c_str(), sizeof(T) * size);
 	}
 	template <typename T>
-	static void readElementFromPayload(const std::vector<unsigned char>& payload, uint32_t *pos, std::basic_string<T> *data) {
+	static void readElementFromPayload(const PayloadView& payload, uint32_t *pos, std::basic_string<T> *data) {
 		uint32_t size = readFromPayload<uint32_t>(payload, pos);
 		size_t remainsize = payload.size() - *pos;
 		size_t datasize = size * sizeof(T);
@@ -202,7 +534,7 @@ namespace JsRPC {
 		}
 	}
 	template <typename T>
-	static void readStdVectorFromPayload(const std::vector<unsigned char>& payload, uint32_t *pos, std::vector<T> *data) {
+	static void readStdVectorFromPayload(const PayloadView& payload, uint32_t *pos, std::vector<T> *data) {
 		uint32_t size = readFromPayload<uint32_t>(payload, pos);
 		size_t remainsize = payload.size() - *pos;
 		size_t datasize = size * sizeof(T);
@@ -218,7 +550,7 @@ namespace JsRPC {
 		}
 	}
 	template <>
-	static void readStdVectorFromPayload<bool>(const std::vector<unsigned char>& payload, uint32_t *pos, std::vector<bool> *data) {
+	static void readStdVectorFromPayload<bool>(const PayloadView& payload, uint32_t *pos, std::vector<bool> *data) {
 		uint32_t size = readFromPayload<uint32_t>(payload, pos);
 		size_t remainsize = payload.size() - *pos;
 		size_t datasize = size * sizeof(bool);
@@ -226,7 +558,7 @@ namespace JsRPC {
 		if (remainsize < datasize)
 			throw Serializable::ParseException();
 		for (uint32_t i = 0; i < size; i++)
-			data->push_back(&payload[*pos++] ? true : false);
+			data->push_back(payload[(*pos)++] ? true : false);
 	}
 
 	template <class T>
@@ -253,38 +585,204 @@ namespace JsRPC {
 	}
 
 	template <class T>
-	static void readStdListFromPayload(const std::vector<unsigned char>& payload, uint32_t *pos, std::list<T> *data);
+	static void readStdListFromPayload(const PayloadView& payload, uint32_t *pos, std::list<T> *data);
 	template <typename T>
-	static void readStdListFromPayload(const std::vector<unsigned char>& payload, uint32_t *pos, std::list< std::basic_string<T> > *data)
+	static void readStdListFromPayload(const PayloadView& payload, uint32_t *pos, std::list< std::basic_string<T> > *data)
 	{
 		uint32_t i;
 		uint32_t size = readFromPayload<uint32_t>(payload, pos);
 		data->clear();
 		for (i = 0; i < size; i++)
 		{
-			std::basic_string<T> element;
-			readElementFromPayload(payload, pos, &element);
-			data->push_back(element);
+			data->push_back(std::basic_string<T>());
+			readElementFromPayload(payload, pos, &data->back());
 		}
 	}
 	template <typename T>
-	static void readStdListFromPayload(const std::vector<unsigned char>& payload, uint32_t *pos, std::list< std::vector<T> > *data)
+	static void readStdListFromPayload(const PayloadView& payload, uint32_t *pos, std::list< std::vector<T> > *data)
 	{
 		uint32_t i;
 		uint32_t size = readFromPayload<uint32_t>(payload, pos);
 		data->clear();
 		for (i = 0; i < size; i++)
 		{
-			std::vector<T> element;
-			readStdVectorFromPayload(payload, pos, &element);
-			data->push_back(element);
+			data->push_back(std::vector<T>());
+			readStdVectorFromPayload(payload, pos, &data->back());
+		}
+	}
+
+	internal::MemberNameTable::MemberNameTable(const std::list<STypeCommon*> &members)
+	{
+		reserve(members.size());
+		for (std::list<STypeCommon*>::const_iterator iter = members.begin(); iter != members.end(); iter++)
+			insert((*iter)->_memberInfo.name);
+	}
+
+	internal::MemberNameTable::MemberNameTable(const std::vector<std::string> &names)
+	{
+		reserve(names.size());
+		for (std::vector<std::string>::const_iterator iter = names.begin(); iter != names.end(); iter++)
+			insert(*iter);
+	}
+
+	void internal::MemberNameTable::reserve(size_t count)
+	{
+		uint32_t capacity = 8;
+		while (capacity < count * 2)
+			capacity <<= 1;
+		m_mask = capacity - 1;
+		m_slots.assign(capacity, -1);
+	}
+
+	void internal::MemberNameTable::insert(const std::string &name)
+	{
+		int32_t ordinal = (int32_t)m_names.size();
+		uint32_t h = hash(name.c_str(), name.length());
+		uint32_t slot = h & m_mask;
+		m_names.push_back(name);
+		m_hashes.push_back(h);
+		while (m_slots[slot] >= 0)
+			slot = (slot + 1) & m_mask;
+		m_slots[slot] = ordinal;
+	}
+
+	int32_t internal::MemberNameTable::find(const char *name, size_t length) const
+	{
+		uint32_t h = hash(name, length);
+		uint32_t slot = h & m_mask;
+		int32_t ordinal;
+		while ((ordinal = m_slots[slot]) >= 0)
+		{
+			if ((m_hashes[ordinal] == h) && (m_names[ordinal].length() == length) && !memcmp(m_names[ordinal].c_str(), name, length))
+				return ordinal;
+			slot = (slot + 1) & m_mask;
+		}
+		return -1;
+	}
+
+	uint32_t internal::MemberNameTable::hash(const char *name, size_t length)
+	{
+		// FNV-1a
+		uint32_t h = 2166136261U;
+		for (size_t i = 0; i < length; i++)
+		{
+			h ^= (unsigned char)name[i];
+			h *= 16777619U;
+		}
+		return h;
+	}
+
+	namespace internal {
+		// Key of SerializableTypeRegistry
+		struct RegisteredType
+		{
+			std::string name;
+			int64_t serialVersionUID;
+		};
+
+		struct SameRegisteredType
+		{
+			const char *name;
+			size_t length;
+			int64_t serialVersionUID;
+
+			bool operator()(const RegisteredType &key) const {
+				return (key.serialVersionUID == serialVersionUID) && (key.name.length() == length) && !memcmp(key.name.c_str(), name, length);
+			}
+		};
+
+		// A function-local static, so types may be registered from static
+		// initializers in other translation units
+		static AppendOnlyTable<RegisteredType, SerializableCreateFactory*> &typeRegistry()
+		{
+			static AppendOnlyTable<RegisteredType, SerializableCreateFactory*> table;
+			return table;
+		}
+
+		// Name tables live for the whole process, one per class
+		static const MemberNameTable *classNameTable(std::type_index type, const std::list<STypeCommon*> &members)
+		{
+			static AppendOnlyTable<std::type_index, MemberNameTable> tables;
+			SameClass match(type);
+			const MemberNameTable *table = tables.find(match.hash(), match);
+			bool inserted;
+			if (!table)
+				table = tables.insert(match.hash(), match, type, MemberNameTable(members), &inserted);
+			return table;
+		}
+	}
+
+	bool SerializableTypeRegistry::registerType(const char *name, int64_t serialVersionUID, SerializableCreateFactory *factory)
+	{
+		internal::SameRegisteredType match = { name, strlen(name), serialVersionUID };
+		internal::RegisteredType key;
+		bool inserted;
+		key.name.assign(name, match.length);
+		key.serialVersionUID = serialVersionUID;
+		internal::typeRegistry().insert(internal::MemberNameTable::hash(name, match.length), match, key, factory, &inserted);
+		return inserted;
+	}
+
+	SerializableCreateFactory *SerializableTypeRegistry::find(const char *name, size_t length, int64_t serialVersionUID)
+	{
+		internal::SameRegisteredType match = { name, length, serialVersionUID };
+		SerializableCreateFactory *const *factory = internal::typeRegistry().find(internal::MemberNameTable::hash(name, length), match);
+		return factory ? *factory : NULL;
+	}
+
+	internal::STypeCommon *Serializable::serializableFindMember(const char *name, size_t length) const
+	{
+		const internal::MemberNameTable *table = m_nameTable.load(std::memory_order_acquire);
+		int32_t ordinal;
+		if (!table)
+		{
+			table = internal::classNameTable(std::type_index(typeid(*this)), m_members);
+			m_nameTable.store(table, std::memory_order_release);
+		}
+		ordinal = table->find(name, length);
+		if ((ordinal >= 0) && ((size_t)ordinal < m_memberIndex.size()))
+		{
+			internal::STypeCommon *member = m_memberIndex[ordinal];
+			if ((member->_memberInfo.name.length() == length) && !memcmp(member->_memberInfo.name.c_str(), name, length))
+				return member;
 		}
+		// This instance mapped its members differently from the rest of its class
+		for (std::vector<internal::STypeCommon*>::const_iterator iter = m_memberIndex.begin(); iter != m_memberIndex.end(); iter++)
+		{
+			if (((*iter)->_memberInfo.name.length() == length) && !memcmp((*iter)->_memberInfo.name.c_str(), name, length))
+				return *iter;
+		}
+		return NULL;
 	}
 
 	internal::STypeCommon &Serializable::serializableMapMember(const char *name, internal::STypeCommon &object)
 	{
 		object._memberInfo.name = name;
+		return serializableRebindMember(object);
+	}
+
+	internal::STypeCommon &Serializable::serializableRebindMember(internal::STypeCommon &object)
+	{
+		object._owner = this;
 		m_members.push_back(&object);
+		m_memberIndex.push_back(&object);
+
+		if (object._memberInfo.byReference)
+			m_cacheable = false;
+		for (std::list<internal::SerializableMemberInfo::EncapType>::const_iterator iter = object._memberInfo.encaps.begin(); iter != object._memberInfo.encaps.end(); iter++)
+		{
+			if (*iter == internal::SerializableMemberInfo::EncapType::ETYPE_SMARTPOINTER)
+				m_cacheable = false;
+		}
+		if (object._memberInfo.encaps.front() == internal::SerializableMemberInfo::EncapType::ETYPE_SUBPAYLOAD)
+		{
+			Serializable *nested = (Serializable*)object._memberInfo.ptr;
+			nested->m_cacheParent = this;
+			if (!nested->m_cacheable)
+				m_cacheable = false;
+		}
+		if (m_membersMissing)
+			m_membersMissing--;
 		return object;
 	}
 
@@ -294,6 +792,80 @@ namespace JsRPC {
 		{
 			(*iter)->clear();
 		}
+		serializableInvalidateCache();
+	}
+
+	void Serializable::serializableCopyFrom(const Serializable &src) JSRPC_THROWS(UnavailableTypeException)
+	{
+		std::list<internal::STypeCommon*>::const_iterator iterDest = m_members.begin();
+		std::list<internal::STypeCommon*>::const_iterator iterSrc = src.m_members.begin();
+
+		if (this == &src)
+			return;
+		if (m_membersMissing || src.m_membersMissing)
+			throw UnavailableTypeException();
+		if ((m_members.size() != src.m_members.size()) || (m_name != src.m_name) || (m_serialVersionUID != src.m_serialVersionUID))
+			throw UnavailableTypeException();
+
+		for (; iterDest != m_members.end(); iterDest++, iterSrc++)
+		{
+			if ((*iterDest)->_memberInfo.encaps != (*iterSrc)->_memberInfo.encaps)
+				throw UnavailableTypeException();
+			(*iterDest)->setNull((*iterSrc)->isNull());
+			if (!(*iterSrc)->isNull())
+				(*iterDest)->copyValueFrom(**iterSrc);
+		}
+	}
+
+	void Serializable::serializableMoveFrom(Serializable &src) JSRPC_THROWS(UnavailableTypeException)
+	{
+		std::list<internal::STypeCommon*>::const_iterator iterDest = m_members.begin();
+		std::list<internal::STypeCommon*>::const_iterator iterSrc = src.m_members.begin();
+
+		if (this == &src)
+			return;
+		if (m_membersMissing || src.m_membersMissing)
+			throw UnavailableTypeException();
+		if ((m_members.size() != src.m_members.size()) || (m_name != src.m_name) || (m_serialVersionUID != src.m_serialVersionUID))
+			throw UnavailableTypeException();
+
+		for (; iterDest != m_members.end(); iterDest++, iterSrc++)
+		{
+			if ((*iterDest)->_memberInfo.encaps != (*iterSrc)->_memberInfo.encaps)
+				throw UnavailableTypeException();
+			(*iterDest)->setNull((*iterSrc)->isNull());
+			if (!(*iterSrc)->isNull())
+				(*iterDest)->moveValueFrom(**iterSrc);
+		}
+		src.serializableInvalidateCache();
+	}
+
+	void Serializable::serializableSetCacheEnabled(bool enabled)
+	{
+		std::lock_guard<std::mutex> lock(m_cacheMutex);
+		m_cacheEnabled.store(enabled, std::memory_order_relaxed);
+		m_cachePayload = SerializedPayload();
+	}
+
+	void Serializable::serializableInvalidateCache()
+	{
+		// Nested objects also invalidate every enclosing object
+		for (Serializable *p = this; p; p = p->m_cacheParent)
+			p->m_generation.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	bool Serializable::cacheLookup(SerializedPayload &cached) const
+	{
+		std::lock_guard<std::mutex> lock(m_cacheMutex);
+		if (m_cachePayload.empty() || (m_cacheGeneration != m_generation.load(std::memory_order_relaxed)))
+			return false;
+		cached = m_cachePayload;
+		return true;
+	}
+
+	static inline bool checkFlagsAll(int value, int type)
+	{
+		return (value & type) == type;
 	}
 
 	static void _serializeCheckNotEoo(uint16_t *tempEtype, std::list<internal::SerializableMemberInfo::EncapType>::const_iterator *iterEncap, std::list<internal::SerializableMemberInfo::EncapType>::const_iterator endOfEncap)
@@ -310,316 +882,1354 @@ namespace JsRPC {
 			throw Serializable::UnavailableTypeException();
 	}
 
-	void Serializable::serialize(std::vector<unsigned char>& payload) const throw(UnavailableTypeException)
+	void Serializable::serialize(std::vector<unsigned char>& payload) const JSRPC_THROWS(UnavailableTypeException)
 	{
-		uint32_t pos = 0;
+		payload.clear();
+		serializeAppend(payload);
+	}
+
+	SerializedPayload Serializable::freeze() const JSRPC_THROWS(UnavailableTypeException)
+	{
+		SerializedPayload frozen;
+		std::vector<unsigned char> payload;
+		uint32_t generation;
+		bool useCache = m_cacheEnabled.load(std::memory_order_relaxed) && m_cacheable;
+
+		if (useCache && cacheLookup(frozen))
+			return frozen;
+
+		generation = m_generation.load(std::memory_order_relaxed);
+		encodeAppend(payload);
+		frozen = SerializedPayload(std::move(payload));
+
+		if (useCache)
+		{
+			std::lock_guard<std::mutex> lock(m_cacheMutex);
+			m_cachePayload = frozen;
+			m_cacheGeneration = generation;
+		}
+		return frozen;
+	}
 
+	void Serializable::serialize(std::vector<unsigned char>& payload, const SerializeOptions &options) const JSRPC_THROWS(UnavailableTypeException)
+	{
 		payload.clear();
-		payload.assign(sizeof(header) + 9 + m_name.length(), 0);
+		serializeAppend(payload, options);
+	}
 
-		// [0] Header
-		memcpy(&payload[0], header, sizeof(header));
-		pos += sizeof(header);
-		// [6] Version
-		payload[pos++] = m_name.length();
-		memcpy(&payload[pos], m_name.c_str(), m_name.length());
-		pos += m_name.length();
-		payload[pos++] = ((unsigned char)(m_serialVersionUID >> 0));
-		payload[pos++] = ((unsigned char)(m_serialVersionUID >> 8));
-		payload[pos++] = ((unsigned char)(m_serialVersionUID >> 16));
-		payload[pos++] = ((unsigned char)(m_serialVersionUID >> 24));
-		payload[pos++] = ((unsigned char)(m_serialVersionUID >> 32));
-		payload[pos++] = ((unsigned char)(m_serialVersionUID >> 40));
-		payload[pos++] = ((unsigned char)(m_serialVersionUID >> 48));
-		payload[pos++] = ((unsigned char)(m_serialVersionUID >> 56));
+	// Compresses the member data of the payload that starts at start, in place.
+	// The data is first shifted right by the worst-case framing overhead, then
+	// compressed block by block towards the front, so the output never overtakes
+	// the unread input and no second full-size buffer is needed.
+	static void compressPayload(std::vector<unsigned char>& payload, size_t start, size_t headerSize)
+	{
+		static thread_local std::vector<unsigned char> scratch;
+		size_t bodyStart = start + headerSize;
+		size_t bodySize = payload.size() - bodyStart;
+		size_t blocks = (bodySize + internal::COMPRESS_BLOCK_SIZE - 1) / internal::COMPRESS_BLOCK_SIZE;
+		size_t slack = 4 + 4 * blocks;
+		size_t in;
+		size_t out;
+		uint32_t word;
 
-		// Data
-		for (std::list<internal::STypeCommon*>::const_iterator iterMem = m_members.begin(); iterMem != m_members.end(); iterMem++)
+		if (bodySize > 0xFFFFFFFFU)
+			return;
+		scratch.resize(internal::BlockCompressor::bound(internal::COMPRESS_BLOCK_SIZE));
+
+		payload.insert(payload.begin() + bodyStart, slack, 0);
+		in = bodyStart + slack;
+		out = bodyStart;
+		word = (uint32_t)bodySize;
+		memcpy(&payload[out], &word, 4);
+		out += 4;
+		while (in < payload.size())
 		{
-			std::list<internal::SerializableMemberInfo::EncapType>::const_iterator iterEncap = (*iterMem)->_memberInfo.encaps.begin();
-			std::list<internal::SerializableMemberInfo::EncapType>::const_iterator endOfEncap = (*iterMem)->_memberInfo.encaps.end();
-			uint16_t tempEtype;
-			_serializeCheckNotEoo(&tempEtype, &iterEncap, endOfEncap);
-			if ((*iterMem)->isNull())
+			size_t length = payload.size() - in;
+			size_t compressed;
+			if (length > internal::COMPRESS_BLOCK_SIZE)
+				length = internal::COMPRESS_BLOCK_SIZE;
+			compressed = internal::BlockCompressor::compress(&payload[in], length, &scratch[0], length - 1);
+			if (compressed)
 			{
-				tempEtype |= internal::SerializableMemberInfo::EncapType::ETYPE_NULL;
-				writeElementToPayload(payload, &tempEtype);
+				word = (uint32_t)compressed;
+				memcpy(&payload[out], &word, 4);
+				memcpy(&payload[out + 4], &scratch[0], compressed);
 			}
-			else {
-				writeElementToPayload(payload, &tempEtype);
-				if ((tempEtype & 0xFF00) == internal::SerializableMemberInfo::EncapType::ETYPE_NATIVE)
-				{
-					switch (tempEtype & 0x00FF)
-					{
-					case (internal::SerializableMemberInfo::EncapType::ETYPE_BOOL):
-						writeElementToPayload<bool>(payload, (bool*)((*iterMem)->_memberInfo.ptr));
-						break;
-					case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 1):
-						writeElementToPayload<int8_t>(payload, (int8_t*)((*iterMem)->_memberInfo.ptr));
-						break;
-					case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 1):
-						writeElementToPayload<uint8_t>(payload, (uint8_t*)((*iterMem)->_memberInfo.ptr));
-						break;
-					case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 2):
-						writeElementToPayload<int16_t>(payload, (int16_t*)((*iterMem)->_memberInfo.ptr));
-						break;
-					case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 2):
-						writeElementToPayload<uint16_t>(payload, (uint16_t*)((*iterMem)->_memberInfo.ptr));
-						break;
-					case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 4):
-						writeElementToPayload<int32_t>(payload, (int32_t*)((*iterMem)->_memberInfo.ptr));
-						break;
-					case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 4):
-						writeElementToPayload<uint32_t>(payload, (uint32_t*)((*iterMem)->_memberInfo.ptr));
-						break;
-					case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 8):
-						writeElementToPayload<int64_t>(payload, (int64_t*)((*iterMem)->_memberInfo.ptr));
-						break;
-					case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 8):
-						writeElementToPayload<uint64_t>(payload, (uint64_t*)((*iterMem)->_memberInfo.ptr));
-						break;
-					case (internal::SerializableMemberInfo::EncapType::ETYPE_CHAR):
-						writeElementToPayload<char>(payload, (char*)((*iterMem)->_memberInfo.ptr));
-						break;
-					case (internal::SerializableMemberInfo::EncapType::ETYPE_WCHAR):
-						writeElementToPayload<wchar_t>(payload, (wchar_t*)((*iterMem)->_memberInfo.ptr));
-						break;
-					case (internal::SerializableMemberInfo::EncapType::ETYPE_FLOAT):
-						writeElementToPayload<float>(payload, (float*)((*iterMem)->_memberInfo.ptr));
-						break;
-					case (internal::SerializableMemberInfo::EncapType::ETYPE_DOUBLE):
-						writeElementToPayload<double>(payload, (double*)((*iterMem)->_memberInfo.ptr));
+			else
+			{
+				compressed = length;
+				word = (uint32_t)length | internal::COMPRESS_BLOCK_STORED;
+				memcpy(&payload[out], &word, 4);
+				memmove(&payload[out + 4], &payload[in], length);
+			}
+			out += 4 + compressed;
+			in += length;
+		}
+		payload.resize(out);
+		payload[start + internal::HEADER_FLAGS_POS] |= Serializable::HEADER_FLAG_COMPRESSED;
+	}
+
+	void Serializable::serializeAppend(std::vector<unsigned char>& payload, const SerializeOptions &options) const JSRPC_THROWS(UnavailableTypeException)
+	{
+		size_t start = payload.size();
+		size_t headerSize = sizeof(header) + 9 + m_name.length();
+		{
+			internal::ChecksumNestedScope scope(options.checksumNested);
+			serializeAppend(payload);
+		}
+		if (options.internStrings && (payload.size() > start + headerSize))
+		{
+			static thread_local std::vector<unsigned char> interned;
+			interned.clear();
+			if (internal::StringInterner::intern(&payload[start + headerSize], payload.size() - start - headerSize, interned))
+			{
+				payload.resize(start + headerSize);
+				payload.insert(payload.end(), interned.begin(), interned.end());
+				payload[start + internal::HEADER_FLAGS_POS] |= HEADER_FLAG_STRING_TABLE;
+			}
+		}
+		if (options.compressThreshold &&(payload.size() - start - headerSize >= options.compressThreshold))
+			compressPayload(payload, start, headerSize);
+		// Computed last, so it covers the bytes as they are stored
+		if (options.checksum)
+			internal::appendChecksum(payload, start);
+	}
+
+	void Serializable::serializeAppend(std::vector<unsigned char>& payload) const JSRPC_THROWS(UnavailableTypeException)
+	{
+		// Cached bytes carry no nested checksums
+		if (m_cacheEnabled.load(std::memory_order_relaxed) && m_cacheable && !internal::checksumNested)
+		{
+			SerializedPayload frozen = freeze();
+			payload.insert(payload.end(), frozen.data(), frozen.data() + frozen.size());
+		} else {
+			encodeAppend(payload);
+		}
+	}
+
+	size_t internal::nativeElementSize(uint16_t etype)
+	{
+		switch (etype & 0x00FF)
+		{
+		case (internal::SerializableMemberInfo::EncapType::ETYPE_BOOL):
+		case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 1):
+		case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 1):
+		case (internal::SerializableMemberInfo::EncapType::ETYPE_CHAR):
+			return 1;
+		case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 2):
+		case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 2):
+			return 2;
+		case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 4):
+		case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 4):
+		case (internal::SerializableMemberInfo::EncapType::ETYPE_FLOAT):
+			return 4;
+		case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 8):
+		case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 8):
+		case (internal::SerializableMemberInfo::EncapType::ETYPE_DOUBLE):
+			return 8;
+		case (internal::SerializableMemberInfo::EncapType::ETYPE_WCHAR):
+			return sizeof(wchar_t);
+		default:
+			throw Serializable::ParseException();
+		}
+	}
+
+	static uint64_t loadInteger(const void *ptr, uint16_t etype)
+	{
+		switch (etype & 0x00FF)
+		{
+		case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 1):
+			return (uint64_t)(int64_t)*(const int8_t*)ptr;
+		case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 1):
+			return *(const uint8_t*)ptr;
+		case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 2):
+			return (uint64_t)(int64_t)*(const int16_t*)ptr;
+		case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 2):
+			return *(const uint16_t*)ptr;
+		case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 4):
+			return (uint64_t)(int64_t)*(const int32_t*)ptr;
+		case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 4):
+			return *(const uint32_t*)ptr;
+		default:
+			return *(const uint64_t*)ptr;
+		}
+	}
+
+	static void storeInteger(void *ptr, uint16_t etype, uint64_t value)
+	{
+		switch (etype & 0x00FF)
+		{
+		case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 1):
+		case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 1):
+			*(uint8_t*)ptr = (uint8_t)value;
+			break;
+		case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 2):
+		case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 2):
+			*(uint16_t*)ptr = (uint16_t)value;
+			break;
+		case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 4):
+		case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 4):
+			*(uint32_t*)ptr = (uint32_t)value;
+			break;
+		default:
+			*(uint64_t*)ptr = value;
+			break;
+		}
+	}
+
+	static inline bool isIntegerEtype(uint16_t etype)
+	{
+		return ((etype & 0x00F0) == internal::SerializableMemberInfo::EncapType::ETYPE_SINT) || ((etype & 0x00F0) == internal::SerializableMemberInfo::EncapType::ETYPE_UINT);
+	}
+
+	static inline size_t varintSize(uint64_t value)
+	{
+		size_t size = 1;
+		while (value >= 0x80)
+		{
+			value >>= 7;
+			size++;
+		}
+		return size;
+	}
+
+	static void writeVarint(std::vector<unsigned char>& payload, uint64_t value)
+	{
+		while (value >= 0x80)
+		{
+			payload.push_back((unsigned char)(value | 0x80));
+			value >>= 7;
+		}
+		payload.push_back((unsigned char)value);
+	}
+
+	static uint64_t readVarint(const PayloadView& payload, uint32_t *pos)
+	{
+		uint64_t value = 0;
+		int shift;
+		for (shift = 0; shift < 64; shift += 7)
+		{
+			unsigned char b = readFromPayload<unsigned char>(payload, pos);
+			value |= (uint64_t)(b & 0x7F) << shift;
+			if (!(b & 0x80))
+				return value;
+		}
+		throw Serializable::ParseException();
+	}
+
+	// Writes the data of a native column and returns its encoding
+	static unsigned char writeNativeColumn(std::vector<unsigned char>& payload, const std::vector<const internal::STypeCommon*> &column, uint16_t etype, bool nulls)
+	{
+		size_t count = column.size();
+		size_t elementSize = internal::nativeElementSize(etype);
+		size_t pos;
+		size_t i;
+
+		if (nulls)
+		{
+			pos = payload.size();
+			payload.resize(pos + (count + 7) / 8, 0);
+			for (i = 0; i < count; i++)
+			{
+				if (column[i]->isNull())
+					payload[pos + i / 8] |= (unsigned char)(1 << (i % 8));
+			}
+		}
+
+		if (isIntegerEtype(etype))
+		{
+			// Sorted or slowly changing values (timestamps, counters) take a byte or two each
+			size_t deltaSize = 0;
+			uint64_t prev = 0;
+			for (i = 0; i < count; i++)
+			{
+				uint64_t value;
+				if (column[i]->isNull())
+					continue;
+				value = loadInteger(column[i]->_memberInfo.ptr, etype);
+				deltaSize += varintSize(internal::zigzagEncode(value - prev));
+				prev = value;
+			}
+			if (deltaSize < count * elementSize)
+			{
+				prev = 0;
+				for (i = 0; i < count; i++)
+				{
+					uint64_t value;
+					if (column[i]->isNull())
+						continue;
+					value = loadInteger(column[i]->_memberInfo.ptr, etype);
+					writeVarint(payload, internal::zigzagEncode(value - prev));
+					prev = value;
+				}
+				return internal::COLUMN_DELTA;
+			}
+		}
+
+		pos = payload.size();
+		payload.resize(pos + count * elementSize, 0);
+		for (i = 0; i < count; i++)
+		{
+			if (column[i]->isNull())
+				continue;
+			if ((etype & 0x00FF) == internal::SerializableMemberInfo::EncapType::ETYPE_BOOL)
+				payload[pos + i] = *(const bool*)column[i]->_memberInfo.ptr ? 1 : 0;
+			else
+				memcpy(&payload[pos + i * elementSize], column[i]->_memberInfo.ptr, elementSize);
+		}
+		return internal::COLUMN_RAW;
+	}
+
+	static void readNativeColumn(const PayloadView& payload, uint32_t *pos, const std::vector<internal::STypeCommon*> &column, uint16_t etype, unsigned char encoding)
+	{
+		size_t count = column.size();
+		size_t elementSize = internal::nativeElementSize(etype);
+		uint32_t bitmapPos = *pos;
+		bool nulls = (etype & internal::SerializableMemberInfo::EncapType::ETYPE_NULL) ? true : false;
+		uint64_t value = 0;
+		size_t i;
+
+		if (nulls)
+		{
+			if (payload.size() - *pos < (count + 7) / 8)
+				throw Serializable::ParseException();
+			*pos += (uint32_t)((count + 7) / 8);
+		}
+		if ((encoding == internal::COLUMN_RAW) && ((payload.size() - *pos) / elementSize < count))
+			throw Serializable::ParseException();
+		else if ((encoding == internal::COLUMN_DELTA) && !isIntegerEtype(etype))
+			throw Serializable::ParseException();
+		else if ((encoding != internal::COLUMN_RAW) && (encoding != internal::COLUMN_DELTA))
+			throw Serializable::ParseException();
+
+		for (i = 0; i < count; i++)
+		{
+			internal::STypeCommon *member = column[i];
+			bool isNull = nulls && (payload[bitmapPos + i / 8] & (1 << (i % 8)));
+			member->clear();
+			member->setNull(isNull);
+			if (encoding == internal::COLUMN_DELTA)
+			{
+				if (isNull)
+					continue;
+				value += internal::zigzagDecode(readVarint(payload, pos));
+				storeInteger(member->_memberInfo.ptr, etype, value);
+			}
+			else
+			{
+				if (!isNull)
+				{
+					if ((etype & 0x00FF) == internal::SerializableMemberInfo::EncapType::ETYPE_BOOL)
+						*(bool*)member->_memberInfo.ptr = payload[*pos] ? true : false;
+					else
+						memcpy(member->_memberInfo.ptr, &payload[*pos], elementSize);
+				}
+				*pos += (uint32_t)elementSize;
+			}
+		}
+	}
+
+	// True when the list is worth writing column by column: no null elements,
+	// one class throughout, and at least one member per element.
+	static bool isColumnarList(const std::list< JsCPPUtils::SmartPointer<Serializable> > &list)
+	{
+		const Serializable *first;
+		if (list.empty() || !list.front().getPtr())
+			return false;
+		first = list.front().getPtr();
+		if (first->serializableMembers().empty())
+			return false;
+		for (std::list< JsCPPUtils::SmartPointer<Serializable> >::const_iterator iter = list.begin(); iter != list.end(); iter++)
+		{
+			const Serializable *row = iter->getPtr();
+			if (!row || (row->serializableGetSerialVersionUID() != first->serializableGetSerialVersionUID()) || (row->serializableGetName() != first->serializableGetName()))
+				return false;
+			if (row->serializableMembers().size() != first->serializableMembers().size())
+				return false;
+		}
+		return true;
+	}
+
+	// Columnar list, after the element etype:
+	//   u32 count, u32 size, class header, then one column per member:
+	//   u16 etype, u8 encoding, u32 size, data
+	// A native column whose etype has the NULL bit starts with a bitmap of
+	// its null rows.
+	void Serializable::encodeColumns(std::vector<unsigned char>& payload, const std::list< JsCPPUtils::SmartPointer<Serializable> > &list)
+	{
+		const Serializable *first = list.front().getPtr();
+		size_t count = list.size();
+		std::vector< std::list<internal::STypeCommon*>::const_iterator > cursors;
+		std::vector<const internal::STypeCommon*> column(count);
+		size_t blockPos;
+		size_t i;
+		uint32_t size;
+
+		cursors.reserve(count);
+		for (std::list< JsCPPUtils::SmartPointer<Serializable> >::const_iterator iter = list.begin(); iter != list.end(); iter++)
+			cursors.push_back(iter->getPtr()->m_members.begin());
+
+		writeArrayElementSize(payload, (uint32_t)count);
+		blockPos = payload.size();
+		writeArrayElementSize(payload, 0);
+		first->encodeHeader(payload);
+
+		for (std::list<internal::STypeCommon*>::const_iterator iterMem = first->m_members.begin(); iterMem != first->m_members.end(); iterMem++)
+		{
+			uint16_t etype = (*iterMem)->_memberInfo.encaps.front();
+			size_t columnPos = payload.size();
+			unsigned char encoding;
+			bool nulls = false;
+
+			for (i = 0; i < count; i++)
+			{
+				column[i] = *(cursors[i]++);
+				if (column[i]->isNull())
+					nulls = true;
+			}
+
+			payload.resize(columnPos + 7, 0);
+			if ((etype & 0xFF00) == internal::SerializableMemberInfo::EncapType::ETYPE_NATIVE)
+			{
+				encoding = writeNativeColumn(payload, column, etype, nulls);
+				if (nulls)
+					etype |= internal::SerializableMemberInfo::EncapType::ETYPE_NULL;
+			}
+			else
+			{
+				encoding = internal::COLUMN_ROWS;
+				for (i = 0; i < count; i++)
+					encodeMember(payload, column[i]);
+			}
+			memcpy(&payload[columnPos], &etype, 2);
+			payload[columnPos + 2] = encoding;
+			size = (uint32_t)(payload.size() - columnPos - 7);
+			memcpy(&payload[columnPos + 3], &size, 4);
+		}
+
+		size = (uint32_t)(payload.size() - blockPos - sizeof(size));
+		memcpy(&payload[blockPos], &size, sizeof(size));
+	}
+
+	void Serializable::decodeColumns(const PayloadView& payload, uint32_t *pos, std::list< JsCPPUtils::SmartPointer<Serializable> > &list, SerializableCreateFactory *createFactory)
+	{
+		uint32_t count = readFromPayload<uint32_t>(payload, pos);
+		uint32_t size;
+		uint32_t end;
+		const char *name;
+		size_t nameLength;
+		int64_t serialVersionUID;
+		size_t headerSize;
+		std::vector< std::list<internal::STypeCommon*>::const_iterator > cursors;
+		std::list<internal::STypeCommon*>::const_iterator endOfMembers;
+		std::vector<internal::STypeCommon*> column;
+		uint32_t i;
+
+		if (count == 0)
+			return;
+		size = readFromPayload<uint32_t>(payload, pos);
+		if ((payload.size() - *pos < size) || !serializablePeekHeader(&payload[*pos], size, &name, &nameLength, &serialVersionUID, &headerSize))
+			throw ParseException();
+		// Every row takes at least one bit of some column
+		if (payload[*pos + internal::HEADER_FLAGS_POS] || (count / 8 > size))
+			throw ParseException();
+		end = *pos + size;
+		*pos += (uint32_t)headerSize;
+
+		if (!createFactory)
+		{
+			createFactory = SerializableTypeRegistry::find(name, nameLength, serialVersionUID);
+			if (!createFactory)
+				throw UnavailableTypeException();
+		}
+		cursors.reserve(count);
+		column.resize(count);
+		for (i = 0; i < count; i++)
+		{
+			JsCPPUtils::SmartPointer<Serializable> obj = createFactory->create();
+			Serializable *row = obj.getPtr();
+			if ((row->m_serialVersionUID != serialVersionUID) || (row->m_name.length() != nameLength) || memcmp(row->m_name.c_str(), name, nameLength))
+				throw ParseException();
+			row->serializableInvalidateCache();
+			cursors.push_back(row->m_members.begin());
+			endOfMembers = row->m_members.end();
+			list.push_back(obj);
+		}
+
+		while (*pos < end)
+		{
+			PayloadView block(&payload[0], end);
+			uint16_t etype = readFromPayload<uint16_t>(block, pos);
+			unsigned char encoding = readFromPayload<unsigned char>(block, pos);
+			uint32_t columnSize = readFromPayload<uint32_t>(block, pos);
+			uint32_t columnEnd;
+			if ((end - *pos < columnSize) || (cursors[count - 1] == endOfMembers))
+				throw ParseException();
+			columnEnd = *pos + columnSize;
+			PayloadView data(&payload[0], columnEnd);
+
+			for (i = 0; i < count; i++)
+				column[i] = *(cursors[i]++);
+			if ((etype & 0x7F00) == internal::SerializableMemberInfo::EncapType::ETYPE_NATIVE)
+			{
+				if ((uint16_t)(etype & ~internal::SerializableMemberInfo::EncapType::ETYPE_NULL) != column[0]->_memberInfo.encaps.front())
+					throw ParseException();
+				readNativeColumn(data, pos, column, etype, encoding);
+			}
+			else if (encoding == internal::COLUMN_ROWS)
+			{
+				for (i = 0; i < count; i++)
+					decodeMember(data, pos, column[i]);
+			}
+			else
+			{
+				throw ParseException();
+			}
+			if (*pos != columnEnd)
+				throw ParseException();
+		}
+		if (cursors[count - 1] != endOfMembers)
+			throw ParseException();
+	}
+
+	void Serializable::encodeMember(std::vector<unsigned char>& payload, const internal::STypeCommon *member)
+	{
+		std::list<internal::SerializableMemberInfo::EncapType>::const_iterator iterEncap = member->_memberInfo.encaps.begin();
+		std::list<internal::SerializableMemberInfo::EncapType>::const_iterator endOfEncap = member->_memberInfo.encaps.end();
+		uint16_t tempEtype;
+		_serializeCheckNotEoo(&tempEtype, &iterEncap, endOfEncap);
+		if (member->isNull())
+		{
+			tempEtype |= internal::SerializableMemberInfo::EncapType::ETYPE_NULL;
+			writeElementToPayload(payload, &tempEtype);
+		}
+		else {
+			writeElementToPayload(payload, &tempEtype);
+			if ((tempEtype & 0xFF00) == internal::SerializableMemberInfo::EncapType::ETYPE_NATIVE)
+			{
+				switch (tempEtype & 0x00FF)
+				{
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_BOOL):
+					writeElementToPayload<bool>(payload, (bool*)(member->_memberInfo.ptr));
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 1):
+					writeElementToPayload<int8_t>(payload, (int8_t*)(member->_memberInfo.ptr));
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 1):
+					writeElementToPayload<uint8_t>(payload, (uint8_t*)(member->_memberInfo.ptr));
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 2):
+					writeElementToPayload<int16_t>(payload, (int16_t*)(member->_memberInfo.ptr));
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 2):
+					writeElementToPayload<uint16_t>(payload, (uint16_t*)(member->_memberInfo.ptr));
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 4):
+					writeElementToPayload<int32_t>(payload, (int32_t*)(member->_memberInfo.ptr));
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 4):
+					writeElementToPayload<uint32_t>(payload, (uint32_t*)(member->_memberInfo.ptr));
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 8):
+					writeElementToPayload<int64_t>(payload, (int64_t*)(member->_memberInfo.ptr));
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 8):
+					writeElementToPayload<uint64_t>(payload, (uint64_t*)(member->_memberInfo.ptr));
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_CHAR):
+					writeElementToPayload<char>(payload, (char*)(member->_memberInfo.ptr));
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_WCHAR):
+					writeElementToPayload<wchar_t>(payload, (wchar_t*)(member->_memberInfo.ptr));
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_FLOAT):
+					writeElementToPayload<float>(payload, (float*)(member->_memberInfo.ptr));
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_DOUBLE):
+					writeElementToPayload<double>(payload, (double*)(member->_memberInfo.ptr));
+					break;
+				default:
+					throw UnavailableTypeException();
+				}
+			}
+			else if ((tempEtype & 0xFF00) == internal::SerializableMemberInfo::EncapType::ETYPE_NATIVEARRAY)
+			{
+				switch (tempEtype & 0x00FF)
+				{
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_BOOL):
+					writeElementArrayToPayload(payload, (int8_t*)(member->_memberInfo.ptr), member->_memberInfo.length);
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 1):
+					writeElementArrayToPayload(payload, (int8_t*)(member->_memberInfo.ptr), member->_memberInfo.length);
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 1):
+					writeElementArrayToPayload(payload, (uint8_t*)(member->_memberInfo.ptr), member->_memberInfo.length);
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 2):
+					writeElementArrayToPayload(payload, (int16_t*)(member->_memberInfo.ptr), member->_memberInfo.length);
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 2):
+					writeElementArrayToPayload(payload, (uint16_t*)(member->_memberInfo.ptr), member->_memberInfo.length);
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 4):
+					writeElementArrayToPayload(payload, (int32_t*)(member->_memberInfo.ptr), member->_memberInfo.length);
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 4):
+					writeElementArrayToPayload(payload, (uint32_t*)(member->_memberInfo.ptr), member->_memberInfo.length);
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 8):
+					writeElementArrayToPayload(payload, (int64_t*)(member->_memberInfo.ptr), member->_memberInfo.length);
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 8):
+					writeElementArrayToPayload(payload, (uint64_t*)(member->_memberInfo.ptr), member->_memberInfo.length);
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_CHAR):
+					writeElementArrayToPayload(payload, (char*)(member->_memberInfo.ptr), member->_memberInfo.length);
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_WCHAR):
+					writeElementArrayToPayload(payload, (wchar_t*)(member->_memberInfo.ptr), member->_memberInfo.length);
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_FLOAT):
+					writeElementArrayToPayload(payload, (float*)(member->_memberInfo.ptr), member->_memberInfo.length);
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_DOUBLE):
+					writeElementArrayToPayload(payload, (double*)(member->_memberInfo.ptr), member->_memberInfo.length);
+					break;
+				default:
+					throw UnavailableTypeException();
+				}
+			}
+			else {
+				switch (tempEtype)
+				{
+				case internal::SerializableMemberInfo::EncapType::ETYPE_STDBASICSTRING:
+					_serializeCheckNotEoo(&tempEtype, &iterEncap, endOfEncap);
+					writeElementToPayload(payload, &tempEtype);
+					if (iterEncap != endOfEncap)
+						throw UnavailableTypeException();
+					if (checkFlagsAll(tempEtype, internal::SerializableMemberInfo::EncapType::ETYPE_CHAR))
+						writeElementToPayload(payload, (const std::basic_string<char>*)member->_memberInfo.ptr);
+					else if (checkFlagsAll(tempEtype, internal::SerializableMemberInfo::EncapType::ETYPE_WCHAR))
+						writeElementToPayload(payload, (const std::basic_string<wchar_t>*)member->_memberInfo.ptr);
+					else
+						throw UnavailableTypeException();
+					break;
+				case internal::SerializableMemberInfo::EncapType::ETYPE_STDVECTOR:
+					_serializeCheckNotEoo(&tempEtype, &iterEncap, endOfEncap);
+					writeElementToPayload(payload, &tempEtype);
+					if (iterEncap != endOfEncap)
+						throw UnavailableTypeException();
+					switch (tempEtype & 0x00FF)
+					{
+					case (internal::SerializableMemberInfo::EncapType::ETYPE_BOOL):
+						writeStdVectorToPayload(payload, (std::vector<bool>*)(member->_memberInfo.ptr));
+						break;
+					case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 1):
+						writeStdVectorToPayload(payload, (std::vector<int8_t>*)(member->_memberInfo.ptr));
+						break;
+					case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 1):
+						writeStdVectorToPayload(payload, (std::vector<uint8_t>*)(member->_memberInfo.ptr));
+						break;
+					case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 2):
+						writeStdVectorToPayload(payload, (std::vector<int16_t>*)(member->_memberInfo.ptr));
+						break;
+					case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 2):
+						writeStdVectorToPayload(payload, (std::vector<uint16_t>*)(member->_memberInfo.ptr));
+						break;
+					case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 4):
+						writeStdVectorToPayload(payload, (std::vector<int32_t>*)(member->_memberInfo.ptr));
+						break;
+					case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 4):
+						writeStdVectorToPayload(payload, (std::vector<uint32_t>*)(member->_memberInfo.ptr));
+						break;
+					case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 8):
+						writeStdVectorToPayload(payload, (std::vector<int64_t>*)(member->_memberInfo.ptr));
+						break;
+					case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 8):
+						writeStdVectorToPayload(payload, (std::vector<uint64_t>*)(member->_memberInfo.ptr));
+						break;
+					case (internal::SerializableMemberInfo::EncapType::ETYPE_CHAR):
+						writeStdVectorToPayload(payload, (std::vector<char>*)(member->_memberInfo.ptr));
+						break;
+					case (internal::SerializableMemberInfo::EncapType::ETYPE_WCHAR):
+						writeStdVectorToPayload(payload, (std::vector<wchar_t>*)(member->_memberInfo.ptr));
+						break;
+					case (internal::SerializableMemberInfo::EncapType::ETYPE_FLOAT):
+						writeStdVectorToPayload(payload, (std::vector<float>*)(member->_memberInfo.ptr));
+						break;
+					case (internal::SerializableMemberInfo::EncapType::ETYPE_DOUBLE):
+						writeStdVectorToPayload(payload, (std::vector<double>*)(member->_memberInfo.ptr));
 						break;
 					default:
 						throw UnavailableTypeException();
-					}
-				}
-				else {
-					switch (tempEtype)
+					}
+					break;
+				case internal::SerializableMemberInfo::EncapType::ETYPE_STDLIST:
+					_serializeCheckNotEoo(&tempEtype, &iterEncap, endOfEncap);
+					writeElementToPayload(payload, &tempEtype);
+					if (iterEncap == endOfEncap)
+					{
+						throw UnavailableTypeException();
+					}
+					else {
+						switch (tempEtype)
+						{
+						case internal::SerializableMemberInfo::EncapType::ETYPE_SMARTPOINTER:
+							tempEtype = *(iterEncap++);
+							if ((tempEtype == internal::SerializableMemberInfo::EncapType::ETYPE_SUBPAYLOAD) && member->_memberInfo.columnar && isColumnarList(*(std::list<JsCPPUtils::SmartPointer<Serializable> >*)member->_memberInfo.ptr))
+								tempEtype = internal::SerializableMemberInfo::EncapType::ETYPE_COLUMNAR;
+							writeElementToPayload(payload, &tempEtype);
+							switch (tempEtype)
+							{
+							case internal::SerializableMemberInfo::EncapType::ETYPE_SUBPAYLOAD:
+								if (iterEncap != endOfEncap)
+									throw UnavailableTypeException();
+								writeArrayElementSize(payload, ((std::list<JsCPPUtils::SmartPointer<Serializable> >*)member->_memberInfo.ptr)->size());
+								for (std::list<JsCPPUtils::SmartPointer<Serializable> >::const_iterator subiter = ((std::list<JsCPPUtils::SmartPointer<Serializable> >*)member->_memberInfo.ptr)->begin(); subiter != ((std::list<JsCPPUtils::SmartPointer<Serializable> >*)member->_memberInfo.ptr)->end(); subiter++)
+								{
+									writeElementToPayload(payload, subiter->getPtr());
+								}
+								break;
+							case internal::SerializableMemberInfo::EncapType::ETYPE_COLUMNAR:
+								if (iterEncap != endOfEncap)
+									throw UnavailableTypeException();
+								encodeColumns(payload, *(std::list<JsCPPUtils::SmartPointer<Serializable> >*)member->_memberInfo.ptr);
+								break;
+							default:
+								throw UnavailableTypeException();
+							}
+							break;
+						case internal::SerializableMemberInfo::EncapType::ETYPE_STDVECTOR:
+							_serializeCheckEoo(&tempEtype, &iterEncap, endOfEncap);
+							writeElementToPayload(payload, &tempEtype);
+							switch (tempEtype & 0x00FF)
+							{
+							case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 1):
+								writeStdListToPayload(payload, (std::list< std::vector<int8_t> >*)(member->_memberInfo.ptr));
+								break;
+							case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 1):
+								writeStdListToPayload(payload, (std::list< std::vector<uint8_t> >*)(member->_memberInfo.ptr));
+								break;
+							case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 2):
+								writeStdListToPayload(payload, (std::list< std::vector<int16_t> >*)(member->_memberInfo.ptr));
+								break;
+							case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 2):
+								writeStdListToPayload(payload, (std::list< std::vector<uint16_t> >*)(member->_memberInfo.ptr));
+								break;
+							case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 4):
+								writeStdListToPayload(payload, (std::list< std::vector<int32_t> >*)(member->_memberInfo.ptr));
+								break;
+							case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 4):
+								writeStdListToPayload(payload, (std::list< std::vector<uint32_t> >*)(member->_memberInfo.ptr));
+								break;
+							case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 8):
+								writeStdListToPayload(payload, (std::list< std::vector<int64_t> >*)(member->_memberInfo.ptr));
+								break;
+							case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 8):
+								writeStdListToPayload(payload, (std::list< std::vector<uint64_t> >*)(member->_memberInfo.ptr));
+								break;
+							case (internal::SerializableMemberInfo::EncapType::ETYPE_CHAR):
+								writeStdListToPayload(payload, (std::list< std::vector<char> >*)(member->_memberInfo.ptr));
+								break;
+							case (internal::SerializableMemberInfo::EncapType::ETYPE_WCHAR):
+								writeStdListToPayload(payload, (std::list< std::vector<wchar_t> >*)(member->_memberInfo.ptr));
+								break;
+							default:
+								throw UnavailableTypeException();
+							}
+							break;
+						case internal::SerializableMemberInfo::EncapType::ETYPE_STDBASICSTRING:
+							_serializeCheckEoo(&tempEtype, &iterEncap, endOfEncap);
+							writeElementToPayload(payload, &tempEtype);
+							if (checkFlagsAll(tempEtype, internal::SerializableMemberInfo::EncapType::ETYPE_CHAR))
+								writeStdListToPayload(payload, (std::list< std::basic_string<char> > *)member->_memberInfo.ptr);
+							else if (checkFlagsAll(tempEtype, internal::SerializableMemberInfo::EncapType::ETYPE_WCHAR))
+								writeStdListToPayload(payload, (std::list<std::basic_string<wchar_t> >*)member->_memberInfo.ptr);
+							else
+								throw UnavailableTypeException();
+							break;
+						default:
+							throw UnavailableTypeException();
+						}
+					}
+					break;
+				case internal::SerializableMemberInfo::EncapType::ETYPE_SUBPAYLOAD:
+					writeElementToPayload(payload, (Serializable*)member->_memberInfo.ptr);
+					break;
+				case internal::SerializableMemberInfo::EncapType::ETYPE_SMARTPOINTER:
+					tempEtype = *(iterEncap++);
+					switch (tempEtype)
+					{
+					case internal::SerializableMemberInfo::EncapType::ETYPE_SUBPAYLOAD:
+						if (iterEncap != endOfEncap)
+							throw UnavailableTypeException();
+						if (!((JsCPPUtils::SmartPointer<Serializable>*)member->_memberInfo.ptr)->getPtr() || member->isNull())
+						{
+							tempEtype |= internal::SerializableMemberInfo::EncapType::ETYPE_NULL;
+							writeElementToPayload(payload, &tempEtype);
+						} else {
+							writeElementToPayload(payload, &tempEtype);
+							writeElementToPayload(payload, ((JsCPPUtils::SmartPointer<Serializable>*)member->_memberInfo.ptr)->getPtr());
+						}
+
+						break;
+					default:
+						throw UnavailableTypeException();
+					}
+					break;
+				default:
+					throw UnavailableTypeException();
+				}
+			}
+		}
+	}
+
+	void Serializable::encodeAppend(std::vector<unsigned char>& payload) const
+	{
+		// A sliced copy lacks members its class name promises
+		if (m_membersMissing)
+			throw UnavailableTypeException();
+		encodeHeader(payload);
+
+		// Data
+		for (std::list<internal::STypeCommon*>::const_iterator iterMem = m_members.begin(); iterMem != m_members.end(); iterMem++)
+			encodeMember(payload, *iterMem);
+	}
+
+	void Serializable::encodeHeader(std::vector<unsigned char>& payload) const
+	{
+		size_t pos = payload.size();
+
+		payload.resize(pos + sizeof(header) + 9 + m_name.length(), 0);
+
+		// [0] Header
+		memcpy(&payload[pos], header, sizeof(header));
+		pos += sizeof(header);
+		// [6] Version
+		payload[pos++] = m_name.length();
+		memcpy(&payload[pos], m_name.c_str(), m_name.length());
+		pos += m_name.length();
+		payload[pos++] = ((unsigned char)(m_serialVersionUID >> 0));
+		payload[pos++] = ((unsigned char)(m_serialVersionUID >> 8));
+		payload[pos++] = ((unsigned char)(m_serialVersionUID >> 16));
+		payload[pos++] = ((unsigned char)(m_serialVersionUID >> 24));
+		payload[pos++] = ((unsigned char)(m_serialVersionUID >> 32));
+		payload[pos++] = ((unsigned char)(m_serialVersionUID >> 40));
+		payload[pos++] = ((unsigned char)(m_serialVersionUID >> 48));
+		payload[pos++] = ((unsigned char)(m_serialVersionUID >> 56));
+	}
+
+	bool Serializable::serializablePeekHeader(const unsigned char *payload, size_t size, const char **name, size_t *nameLength, int64_t *serialVersionUID, size_t *headerSize)
+	{
+		size_t length;
+		size_t pos = sizeof(header);
+		uint64_t uid = 0;
+		int i;
+		if ((size <= sizeof(header)) || !internal::matchHeader(payload, header, sizeof(header)))
+			return false;
+		length = payload[pos++];
+		if (size < sizeof(header) + 9 + length)
+			return false;
+		if (name)
+			*name = (const char*)&payload[pos];
+		if (nameLength)
+			*nameLength = length;
+		pos += length;
+		for (i = 0; i < 8; i++)
+			uid |= ((uint64_t)payload[pos++]) << (i * 8);
+		if (serialVersionUID)
+			*serialVersionUID = (int64_t)uid;
+		if (headerSize)
+			*headerSize = pos;
+		return true;
+	}
+
+	static void decompressPayload(const unsigned char *payload, size_t size, size_t headerSize, std::vector<unsigned char> &plain)
+	{
+		size_t pos = headerSize;
+		size_t out;
+		uint32_t bodySize;
+
+		if (size - pos < 4)
+			throw Serializable::ParseException();
+		memcpy(&bodySize, &payload[pos], 4);
+		pos += 4;
+		// Every block has a size word, so a bodySize the payload cannot hold the
+		// blocks of is rejected before it is allocated
+		if (((size_t)bodySize + internal::COMPRESS_BLOCK_SIZE - 1) / internal::COMPRESS_BLOCK_SIZE * 4 > size - pos)
+			throw Serializable::ParseException();
+
+		plain.resize(headerSize + (size_t)bodySize);
+		memcpy(&plain[0], payload, headerSize);
+		plain[internal::HEADER_FLAGS_POS] &= ~Serializable::HEADER_FLAG_COMPRESSED;
+		out = headerSize;
+		while (out < plain.size())
+		{
+			size_t length = plain.size() - out;
+			uint32_t word;
+			size_t stored;
+			if (length > internal::COMPRESS_BLOCK_SIZE)
+				length = internal::COMPRESS_BLOCK_SIZE;
+			if (size - pos < 4)
+				throw Serializable::ParseException();
+			memcpy(&word, &payload[pos], 4);
+			pos += 4;
+			stored = word & ~internal::COMPRESS_BLOCK_STORED;
+			if (size - pos < stored)
+				throw Serializable::ParseException();
+			if (word & internal::COMPRESS_BLOCK_STORED)
+			{
+				if (stored != length)
+					throw Serializable::ParseException();
+				memcpy(&plain[out], &payload[pos], length);
+			}
+			else if (!internal::BlockCompressor::decompress(&payload[pos], stored, &plain[out], length))
+			{
+				throw Serializable::ParseException();
+			}
+			pos += stored;
+			out += length;
+		}
+		if (pos != size)
+			throw Serializable::ParseException();
+	}
+
+	// Undoes compression and string interning. A checksum trailer must already
+	// have been checked and cut off from size; plain comes out with no flags.
+	static void expandPayload(const unsigned char *payload, size_t size, size_t headerSize, std::vector<unsigned char> &plain)
+	{
+		static thread_local std::vector<unsigned char> retained;
+		std::vector<unsigned char> decompressed;
+		unsigned char flags = payload[internal::HEADER_FLAGS_POS];
+
+		// Compression is applied after interning, so it is undone first
+		if (flags & Serializable::HEADER_FLAG_COMPRESSED)
+		{
+			if (!(flags & Serializable::HEADER_FLAG_STRING_TABLE))
+			{
+				decompressPayload(payload, size, headerSize, plain);
+				plain[internal::HEADER_FLAGS_POS] = 0;
+				return;
+			}
+			decompressed.swap(retained);
+			decompressPayload(payload, size, headerSize, decompressed);
+			payload = &decompressed[0];
+			size = decompressed.size();
+		}
+		else if (!(flags & Serializable::HEADER_FLAG_STRING_TABLE))
+		{
+			plain.assign(payload, payload + size);
+			plain[internal::HEADER_FLAGS_POS] = 0;
+			return;
+		}
+
+		plain.assign(payload, payload + headerSize);
+		plain[internal::HEADER_FLAGS_POS] = 0;
+		internal::StringInterner::expand(payload + headerSize, size - headerSize, plain);
+		if (decompressed.capacity() <= internal::DECOMPRESS_RETAIN_SIZE)
+			decompressed.swap(retained);
+	}
+
+	bool Serializable::serializableExpand(const unsigned char *payload, size_t size, std::vector<unsigned char> &plain) JSRPC_THROWS(ParseException)
+	{
+		size_t headerSize;
+
+		if (!serializablePeekHeader(payload, size, NULL, NULL, NULL, &headerSize))
+			throw ParseException();
+		if (!payload[internal::HEADER_FLAGS_POS])
+			return false;
+
+		if (payload[internal::HEADER_FLAGS_POS] & HEADER_FLAG_CHECKSUM)
+		{
+			if ((size - headerSize < internal::CHECKSUM_SIZE) || !internal::verifyChecksum(payload, size))
+				throw ParseException();
+			size -= internal::CHECKSUM_SIZE;
+		}
+		expandPayload(payload, size, headerSize, plain);
+		return true;
+	}
+
+#if defined(HAS_JSCPPUTILS) && HAS_JSCPPUTILS
+	JsCPPUtils::SmartPointer<Serializable> Serializable::decodeAny(const unsigned char *payload, size_t size) JSRPC_THROWS(ParseException, UnavailableTypeException)
+	{
+		const char *name;
+		size_t nameLength;
+		int64_t serialVersionUID;
+		SerializableCreateFactory *factory;
+		if (!serializablePeekHeader(payload, size, &name, &nameLength, &serialVersionUID, NULL))
+			throw ParseException();
+		factory = SerializableTypeRegistry::find(name, nameLength, serialVersionUID);
+		if (!factory)
+			throw UnavailableTypeException();
+		JsCPPUtils::SmartPointer<Serializable> obj = factory->create();
+		obj.getPtr()->deserialize(payload, size);
+		return obj;
+	}
+
+	Serializable *internal::cloneSerializable(const Serializable &src, SerializableCreateFactory *factory)
+	{
+		Serializable *obj = factory ? factory->create() : NULL;
+		if (obj && ((obj->serializableGetName() != src.serializableGetName()) || (obj->serializableGetSerialVersionUID() != src.serializableGetSerialVersionUID())))
+		{
+			// The factory makes some other class; fall back to the registry
+			delete obj;
+			obj = NULL;
+		}
+		if (!obj)
+		{
+			factory = SerializableTypeRegistry::find(src.serializableGetName().c_str(), src.serializableGetName().length(), src.serializableGetSerialVersionUID());
+			if (!factory)
+				throw Serializable::UnavailableTypeException();
+			obj = factory->create();
+		}
+		try {
+			obj->serializableCopyFrom(src);
+		} catch (...) {
+			delete obj;
+			throw;
+		}
+		return obj;
+	}
+#endif
+
+	void Serializable::decodeMember(const PayloadView& payload, uint32_t *pos, internal::STypeCommon *member)
+	{
+		std::list<internal::SerializableMemberInfo::EncapType>::const_iterator iterEncap = member->_memberInfo.encaps.begin();
+		std::list<internal::SerializableMemberInfo::EncapType>::const_iterator endOfEncap = member->_memberInfo.encaps.end();
+		uint16_t tempEtypeRecv;
+		uint16_t tempEtypeReal;
+		_serializeCheckNotEoo(&tempEtypeReal, &iterEncap, endOfEncap);
+		tempEtypeRecv = readFromPayload<uint16_t>(payload, pos);
+		// Every etype on the wire must be the declared one, or the branches below
+		// would write one type into another type's storage
+		if ((uint16_t)(tempEtypeRecv & ~internal::SerializableMemberInfo::EncapType::ETYPE_NULL) != tempEtypeReal)
+			throw ParseException();
+		member->clear();
+		member->setNull(tempEtypeRecv & internal::SerializableMemberInfo::EncapType::ETYPE_NULL);
+		if (!(tempEtypeRecv & internal::SerializableMemberInfo::EncapType::ETYPE_NULL))
+		{
+			if ((tempEtypeRecv & 0xFF00) == internal::SerializableMemberInfo::EncapType::ETYPE_NATIVE)
+			{
+				switch (tempEtypeRecv & 0x00FF)
+				{
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_BOOL):
+					readElementFromPayload<bool>(payload, pos, (bool*)(member->_memberInfo.ptr));
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 1):
+					readElementFromPayload<int8_t>(payload, pos, (int8_t*)(member->_memberInfo.ptr));
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 1):
+					readElementFromPayload<uint8_t>(payload, pos, (uint8_t*)(member->_memberInfo.ptr));
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 2):
+					readElementFromPayload<int16_t>(payload, pos, (int16_t*)(member->_memberInfo.ptr));
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 2):
+					readElementFromPayload<uint16_t>(payload, pos, (uint16_t*)(member->_memberInfo.ptr));
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 4):
+					readElementFromPayload<int32_t>(payload, pos, (int32_t*)(member->_memberInfo.ptr));
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 4):
+					readElementFromPayload<uint32_t>(payload, pos, (uint32_t*)(member->_memberInfo.ptr));
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 8):
+					readElementFromPayload<int64_t>(payload, pos, (int64_t*)(member->_memberInfo.ptr));
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 8):
+					readElementFromPayload<uint64_t>(payload, pos, (uint64_t*)(member->_memberInfo.ptr));
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_CHAR):
+					readElementFromPayload<char>(payload, pos, (char*)(member->_memberInfo.ptr));
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_WCHAR):
+					readElementFromPayload<wchar_t>(payload, pos, (wchar_t*)(member->_memberInfo.ptr));
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_FLOAT):
+					readElementFromPayload<float>(payload, pos, (float*)(member->_memberInfo.ptr));
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_DOUBLE):
+					readElementFromPayload<double>(payload, pos, (double*)(member->_memberInfo.ptr));
+					break;
+				default:
+					throw UnavailableTypeException();
+				}
+			}
+			else if ((tempEtypeRecv & 0xFF00) == internal::SerializableMemberInfo::EncapType::ETYPE_NATIVEARRAY)
+			{
+				switch (tempEtypeRecv & 0x00FF)
+				{
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_BOOL):
+					readElementArrayFromPayload(payload, pos, (int8_t*)(member->_memberInfo.ptr), member->_memberInfo.length);
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 1):
+					readElementArrayFromPayload(payload, pos, (int8_t*)(member->_memberInfo.ptr), member->_memberInfo.length);
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 1):
+					readElementArrayFromPayload(payload, pos, (uint8_t*)(member->_memberInfo.ptr), member->_memberInfo.length);
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 2):
+					readElementArrayFromPayload(payload, pos, (int16_t*)(member->_memberInfo.ptr), member->_memberInfo.length);
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 2):
+					readElementArrayFromPayload(payload, pos, (uint16_t*)(member->_memberInfo.ptr), member->_memberInfo.length);
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 4):
+					readElementArrayFromPayload(payload, pos, (int32_t*)(member->_memberInfo.ptr), member->_memberInfo.length);
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 4):
+					readElementArrayFromPayload(payload, pos, (uint32_t*)(member->_memberInfo.ptr), member->_memberInfo.length);
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 8):
+					readElementArrayFromPayload(payload, pos, (int64_t*)(member->_memberInfo.ptr), member->_memberInfo.length);
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 8):
+					readElementArrayFromPayload(payload, pos, (uint64_t*)(member->_memberInfo.ptr), member->_memberInfo.length);
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_CHAR):
+					readElementArrayFromPayload(payload, pos, (char*)(member->_memberInfo.ptr), member->_memberInfo.length);
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_WCHAR):
+					readElementArrayFromPayload(payload, pos, (wchar_t*)(member->_memberInfo.ptr), member->_memberInfo.length);
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_FLOAT):
+					readElementArrayFromPayload(payload, pos, (float*)(member->_memberInfo.ptr), member->_memberInfo.length);
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_DOUBLE):
+					readElementArrayFromPayload(payload, pos, (double*)(member->_memberInfo.ptr), member->_memberInfo.length);
+					break;
+				default:
+					throw UnavailableTypeException();
+				}
+			}
+			else {
+				switch (tempEtypeRecv)
+				{
+				case internal::SerializableMemberInfo::EncapType::ETYPE_STDBASICSTRING:
+					_serializeCheckEoo(&tempEtypeReal, &iterEncap, endOfEncap);
+					tempEtypeRecv = readFromPayload<uint16_t>(payload, pos);
+					if (iterEncap != endOfEncap)
+						throw UnavailableTypeException();
+					if (tempEtypeRecv != tempEtypeReal)
+						throw ParseException();
+					if (checkFlagsAll(tempEtypeReal, internal::SerializableMemberInfo::EncapType::ETYPE_CHAR))
+						readElementFromPayload(payload, pos, (std::basic_string<char>*)member->_memberInfo.ptr);
+					else if (checkFlagsAll(tempEtypeReal, internal::SerializableMemberInfo::EncapType::ETYPE_WCHAR))
+						readElementFromPayload(payload, pos, (std::basic_string<wchar_t>*)member->_memberInfo.ptr);
+					else
+						throw UnavailableTypeException();
+					break;
+				case internal::SerializableMemberInfo::EncapType::ETYPE_STDVECTOR:
+					_serializeCheckNotEoo(&tempEtypeReal, &iterEncap, endOfEncap);
+					tempEtypeRecv = readFromPayload<uint16_t>(payload, pos);
+					if (iterEncap != endOfEncap)
+						throw UnavailableTypeException();
+					if ((uint16_t)(tempEtypeRecv & ~internal::SerializableMemberInfo::EncapType::ETYPE_NULL) != tempEtypeReal)
+						throw ParseException();
+					if (!(tempEtypeRecv & internal::SerializableMemberInfo::EncapType::ETYPE_NULL))
 					{
-					case internal::SerializableMemberInfo::EncapType::ETYPE_STDBASICSTRING:
-						_serializeCheckNotEoo(&tempEtype, &iterEncap, endOfEncap);
-						writeElementToPayload(payload, &tempEtype);
-						if (iterEncap != endOfEncap)
-							throw UnavailableTypeException();
-						if (checkFlagsAll(tempEtype, internal::SerializableMemberInfo::EncapType::ETYPE_CHAR))
-							writeElementToPayload(payload, (const std::basic_string<char>*)(*iterMem)->_memberInfo.ptr);
-						else if (checkFlagsAll(tempEtype, internal::SerializableMemberInfo::EncapType::ETYPE_WCHAR))
-							writeElementToPayload(payload, (const std::basic_string<wchar_t>*)(*iterMem)->_memberInfo.ptr);
-						else
-							throw UnavailableTypeException();
-						break;
-					case internal::SerializableMemberInfo::EncapType::ETYPE_STDVECTOR:
-						_serializeCheckNotEoo(&tempEtype, &iterEncap, endOfEncap);
-						writeElementToPayload(payload, &tempEtype);
-						if (iterEncap != endOfEncap)
-							throw UnavailableTypeException();
-						switch (tempEtype & 0x00FF)
+						switch (tempEtypeRecv & 0x00FF)
 						{
 						case (internal::SerializableMemberInfo::EncapType::ETYPE_BOOL):
-							writeStdVectorToPayload(payload, (std::vector<bool>*)((*iterMem)->_memberInfo.ptr));
+							readStdVectorFromPayload(payload, pos,(std::vector<bool>*)(member->_memberInfo.ptr));
 							break;
 						case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 1):
-							writeStdVectorToPayload(payload, (std::vector<int8_t>*)((*iterMem)->_memberInfo.ptr));
+							readStdVectorFromPayload(payload, pos, (std::vector<int8_t>*)(member->_memberInfo.ptr));
 							break;
 						case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 1):
-							writeStdVectorToPayload(payload, (std::vector<uint8_t>*)((*iterMem)->_memberInfo.ptr));
+							readStdVectorFromPayload(payload, pos, (std::vector<uint8_t>*)(member->_memberInfo.ptr));
 							break;
 						case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 2):
-							writeStdVectorToPayload(payload, (std::vector<int16_t>*)((*iterMem)->_memberInfo.ptr));
+							readStdVectorFromPayload(payload, pos, (std::vector<int16_t>*)(member->_memberInfo.ptr));
 							break;
 						case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 2):
-							writeStdVectorToPayload(payload, (std::vector<uint16_t>*)((*iterMem)->_memberInfo.ptr));
+							readStdVectorFromPayload(payload, pos, (std::vector<uint16_t>*)(member->_memberInfo.ptr));
 							break;
 						case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 4):
-							writeStdVectorToPayload(payload, (std::vector<int32_t>*)((*iterMem)->_memberInfo.ptr));
+							readStdVectorFromPayload(payload, pos, (std::vector<int32_t>*)(member->_memberInfo.ptr));
 							break;
 						case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 4):
-							writeStdVectorToPayload(payload, (std::vector<uint32_t>*)((*iterMem)->_memberInfo.ptr));
+							readStdVectorFromPayload(payload, pos, (std::vector<uint32_t>*)(member->_memberInfo.ptr));
 							break;
 						case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 8):
-							writeStdVectorToPayload(payload, (std::vector<int64_t>*)((*iterMem)->_memberInfo.ptr));
+							readStdVectorFromPayload(payload, pos, (std::vector<int64_t>*)(member->_memberInfo.ptr));
 							break;
 						case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 8):
-							writeStdVectorToPayload(payload, (std::vector<uint64_t>*)((*iterMem)->_memberInfo.ptr));
+							readStdVectorFromPayload(payload, pos, (std::vector<uint64_t>*)(member->_memberInfo.ptr));
 							break;
 						case (internal::SerializableMemberInfo::EncapType::ETYPE_CHAR):
-							writeStdVectorToPayload(payload, (std::vector<char>*)((*iterMem)->_memberInfo.ptr));
+							readStdVectorFromPayload(payload, pos, (std::vector<char>*)(member->_memberInfo.ptr));
 							break;
 						case (internal::SerializableMemberInfo::EncapType::ETYPE_WCHAR):
-							writeStdVectorToPayload(payload, (std::vector<wchar_t>*)((*iterMem)->_memberInfo.ptr));
+							readStdVectorFromPayload(payload, pos, (std::vector<wchar_t>*)(member->_memberInfo.ptr));
 							break;
 						case (internal::SerializableMemberInfo::EncapType::ETYPE_FLOAT):
-							writeStdVectorToPayload(payload, (std::vector<float>*)((*iterMem)->_memberInfo.ptr));
+							readStdVectorFromPayload(payload, pos, (std::vector<float>*)(member->_memberInfo.ptr));
 							break;
 						case (internal::SerializableMemberInfo::EncapType::ETYPE_DOUBLE):
-							writeStdVectorToPayload(payload, (std::vector<double>*)((*iterMem)->_memberInfo.ptr));
+							readStdVectorFromPayload(payload, pos, (std::vector<double>*)(member->_memberInfo.ptr));
 							break;
 						default:
 							throw UnavailableTypeException();
 						}
-						break;
-					case internal::SerializableMemberInfo::EncapType::ETYPE_STDLIST:
-						_serializeCheckNotEoo(&tempEtype, &iterEncap, endOfEncap);
-						writeElementToPayload(payload, &tempEtype);
-						if (iterEncap == endOfEncap)
+					}
+					break;
+				case internal::SerializableMemberInfo::EncapType::ETYPE_STDLIST:
+					_serializeCheckNotEoo(&tempEtypeReal, &iterEncap, endOfEncap);
+					tempEtypeRecv = readFromPayload<uint16_t>(payload, pos);
+					if (tempEtypeRecv != tempEtypeReal)
+						throw ParseException();
+					if (iterEncap == endOfEncap)
+					{
+						throw UnavailableTypeException();
+					}
+					else {
+						switch (tempEtypeReal)
 						{
-							throw UnavailableTypeException();
-						}
-						else {
-							switch (tempEtype)
+						case internal::SerializableMemberInfo::EncapType::ETYPE_SMARTPOINTER:
+							tempEtypeReal = *(iterEncap++);
+							tempEtypeRecv = readFromPayload<uint16_t>(payload, pos);
+							switch (tempEtypeReal)
 							{
-							case internal::SerializableMemberInfo::EncapType::ETYPE_SMARTPOINTER:
-								tempEtype = *(iterEncap++);
-								writeElementToPayload(payload, &tempEtype);
-								switch (tempEtype)
+							case internal::SerializableMemberInfo::EncapType::ETYPE_SUBPAYLOAD:
+								if (iterEncap != endOfEncap)
+									throw UnavailableTypeException();
+								if ((tempEtypeRecv != tempEtypeReal) && (tempEtypeRecv != internal::SerializableMemberInfo::EncapType::ETYPE_COLUMNAR))
+									throw ParseException();
 								{
-								case internal::SerializableMemberInfo::EncapType::ETYPE_SUBPAYLOAD:
-									if (iterEncap != endOfEncap)
-										throw UnavailableTypeException();
-									writeArrayElementSize(payload, ((std::list<JsCPPUtils::SmartPointer<Serializable> >*)(*iterMem)->_memberInfo.ptr)->size());
-									for (std::list<JsCPPUtils::SmartPointer<Serializable> >::const_iterator subiter = ((std::list<JsCPPUtils::SmartPointer<Serializable> >*)(*iterMem)->_memberInfo.ptr)->begin(); subiter != ((std::list<JsCPPUtils::SmartPointer<Serializable> >*)(*iterMem)->_memberInfo.ptr)->end(); subiter++)
+									uint32_t i;
+									uint32_t length;
+									std::list<JsCPPUtils::SmartPointer<Serializable> > *plist = ((std::list<JsCPPUtils::SmartPointer<Serializable> >*)member->_memberInfo.ptr);
+									plist->clear();
+									if (tempEtypeRecv == internal::SerializableMemberInfo::EncapType::ETYPE_COLUMNAR)
 									{
-										writeElementToPayload(payload, subiter->getPtr());
+										decodeColumns(payload, pos, *plist, member->_memberInfo.createFactory);
+										break;
 									}
-									break;
-								default:
-									throw UnavailableTypeException();
+									length = readFromPayload<uint32_t>(payload, pos);
+									for (i = 0; i < length; i++)
+										plist->push_back(readNestedFromPayload(payload, pos, member->_memberInfo.createFactory));
 								}
 								break;
-							case internal::SerializableMemberInfo::EncapType::ETYPE_STDVECTOR:
-								_serializeCheckEoo(&tempEtype, &iterEncap, endOfEncap);
-								writeElementToPayload(payload, &tempEtype);
-								switch (tempEtype & 0x00FF)
-								{
-								case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 1):
-									writeStdListToPayload(payload, (std::list< std::vector<int8_t> >*)((*iterMem)->_memberInfo.ptr));
-									break;
-								case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 1):
-									writeStdListToPayload(payload, (std::list< std::vector<uint8_t> >*)((*iterMem)->_memberInfo.ptr));
-									break;
-								case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 2):
-									writeStdListToPayload(payload, (std::list< std::vector<int16_t> >*)((*iterMem)->_memberInfo.ptr));
-									break;
-								case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 2):
-									writeStdListToPayload(payload, (std::list< std::vector<uint16_t> >*)((*iterMem)->_memberInfo.ptr));
-									break;
-								case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 4):
-									writeStdListToPayload(payload, (std::list< std::vector<int32_t> >*)((*iterMem)->_memberInfo.ptr));
-									break;
-								case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 4):
-									writeStdListToPayload(payload, (std::list< std::vector<uint32_t> >*)((*iterMem)->_memberInfo.ptr));
-									break;
-								case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 8):
-									writeStdListToPayload(payload, (std::list< std::vector<int64_t> >*)((*iterMem)->_memberInfo.ptr));
-									break;
-								case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 8):
-									writeStdListToPayload(payload, (std::list< std::vector<uint64_t> >*)((*iterMem)->_memberInfo.ptr));
-									break;
-								case (internal::SerializableMemberInfo::EncapType::ETYPE_CHAR):
-									writeStdListToPayload(payload, (std::list< std::vector<char> >*)((*iterMem)->_memberInfo.ptr));
-									break;
-								case (internal::SerializableMemberInfo::EncapType::ETYPE_WCHAR):
-									writeStdListToPayload(payload, (std::list< std::vector<wchar_t> >*)((*iterMem)->_memberInfo.ptr));
-									break;
-								default:
-									throw UnavailableTypeException();
-								}
+							default:
+								throw UnavailableTypeException();
+							}
+							break;
+						case internal::SerializableMemberInfo::EncapType::ETYPE_STDVECTOR:
+							_serializeCheckEoo(&tempEtypeReal, &iterEncap, endOfEncap);
+							tempEtypeRecv = readFromPayload<uint16_t>(payload, pos);
+							if (tempEtypeRecv != tempEtypeReal)
+								throw ParseException();
+							switch (tempEtypeReal & 0x00FF)
+							{
+							case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 1):
+								readStdListFromPayload(payload, pos, (std::list< std::vector<int8_t> >*)(member->_memberInfo.ptr));
 								break;
-							case internal::SerializableMemberInfo::EncapType::ETYPE_STDBASICSTRING:
-								_serializeCheckEoo(&tempEtype, &iterEncap, endOfEncap);
-								writeElementToPayload(payload, &tempEtype);
-								if (checkFlagsAll(tempEtype, internal::SerializableMemberInfo::EncapType::ETYPE_CHAR))
-									writeStdListToPayload(payload, (std::list< std::basic_string<char> > *)(*iterMem)->_memberInfo.ptr);
-								else if (checkFlagsAll(tempEtype, internal::SerializableMemberInfo::EncapType::ETYPE_WCHAR))
-									writeStdListToPayload(payload, (std::list<std::basic_string<wchar_t> >*)(*iterMem)->_memberInfo.ptr);
-								else
-									throw UnavailableTypeException();
+							case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 1):
+								readStdListFromPayload(payload, pos, (std::list< std::vector<uint8_t> >*)(member->_memberInfo.ptr));
+								break;
+							case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 2):
+								readStdListFromPayload(payload, pos, (std::list< std::vector<int16_t> >*)(member->_memberInfo.ptr));
+								break;
+							case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 2):
+								readStdListFromPayload(payload, pos, (std::list< std::vector<uint16_t> >*)(member->_memberInfo.ptr));
+								break;
+							case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 4):
+								readStdListFromPayload(payload, pos, (std::list< std::vector<int32_t> >*)(member->_memberInfo.ptr));
+								break;
+							case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 4):
+								readStdListFromPayload(payload, pos, (std::list< std::vector<uint32_t> >*)(member->_memberInfo.ptr));
+								break;
+							case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 8):
+								readStdListFromPayload(payload, pos, (std::list< std::vector<int64_t> >*)(member->_memberInfo.ptr));
+								break;
+							case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 8):
+								readStdListFromPayload(payload, pos, (std::list< std::vector<uint64_t> >*)(member->_memberInfo.ptr));
+								break;
+							case (internal::SerializableMemberInfo::EncapType::ETYPE_CHAR):
+								readStdListFromPayload(payload, pos, (std::list< std::vector<char> >*)(member->_memberInfo.ptr));
+								break;
+							case (internal::SerializableMemberInfo::EncapType::ETYPE_WCHAR):
+								readStdListFromPayload(payload, pos, (std::list< std::vector<wchar_t> >*)(member->_memberInfo.ptr));
 								break;
 							default:
 								throw UnavailableTypeException();
 							}
-						}
-						break;
-					case internal::SerializableMemberInfo::EncapType::ETYPE_SUBPAYLOAD:
-						writeElementToPayload(payload, (Serializable*)(*iterMem)->_memberInfo.ptr);
-						break;
-					case internal::SerializableMemberInfo::EncapType::ETYPE_SMARTPOINTER:
-						tempEtype = *(iterEncap++);
-						switch (tempEtype)
-						{
-						case internal::SerializableMemberInfo::EncapType::ETYPE_SUBPAYLOAD:
-							if (iterEncap != endOfEncap)
+							break;
+						case internal::SerializableMemberInfo::EncapType::ETYPE_STDBASICSTRING:
+							_serializeCheckEoo(&tempEtypeReal, &iterEncap, endOfEncap);
+							tempEtypeRecv = readFromPayload<uint16_t>(payload, pos);
+							if (tempEtypeRecv != tempEtypeReal)
+								throw ParseException();
+							if (checkFlagsAll(tempEtypeReal, internal::SerializableMemberInfo::EncapType::ETYPE_CHAR))
+								readStdListFromPayload(payload, pos, (std::list< std::basic_string<char> > *)member->_memberInfo.ptr);
+							else if (checkFlagsAll(tempEtypeReal, internal::SerializableMemberInfo::EncapType::ETYPE_WCHAR))
+								readStdListFromPayload(payload, pos, (std::list<std::basic_string<wchar_t> >*)member->_memberInfo.ptr);
+							else
 								throw UnavailableTypeException();
-							if (!((JsCPPUtils::SmartPointer<Serializable>*)(*iterMem)->_memberInfo.ptr)->getPtr() || (*iterMem)->isNull())
-							{
-								tempEtype |= internal::SerializableMemberInfo::EncapType::ETYPE_NULL;
-								writeElementToPayload(payload, &tempEtype);
-							} else {
-								writeElementToPayload(payload, &tempEtype);
-								writeElementToPayload(payload, ((JsCPPUtils::SmartPointer<Serializable>*)(*iterMem)->_memberInfo.ptr)->getPtr());
-							}
-
 							break;
 						default:
 							throw UnavailableTypeException();
 						}
-						break;
-					case internal::SerializableMemberInfo::EncapType::ETYPE_NATIVEARRAY:
-						switch (tempEtype & 0x00FF)
+					}
+					break;
+				case internal::SerializableMemberInfo::EncapType::ETYPE_SUBPAYLOAD:
+					readElementFromPayload(payload, pos, (Serializable*)member->_memberInfo.ptr);
+					break;
+				case internal::SerializableMemberInfo::EncapType::ETYPE_SMARTPOINTER:
+					tempEtypeReal = *(iterEncap++);
+					tempEtypeRecv = readFromPayload<uint16_t>(payload, pos);
+					if ((uint16_t)(tempEtypeRecv & ~internal::SerializableMemberInfo::EncapType::ETYPE_NULL) != tempEtypeReal)
+						throw ParseException();
+					if (tempEtypeRecv & internal::SerializableMemberInfo::EncapType::ETYPE_NULL)
+					{
+						member->setNull();
+					}else{
+						switch (tempEtypeReal)
 						{
-						case (internal::SerializableMemberInfo::EncapType::ETYPE_BOOL):
-							writeElementArrayToPayload(payload, (int8_t*)((*iterMem)->_memberInfo.ptr), (*iterMem)->_memberInfo.length);
-							break;
-						case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 1):
-							writeElementArrayToPayload(payload, (int8_t*)((*iterMem)->_memberInfo.ptr), (*iterMem)->_memberInfo.length);
-							break;
-						case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 1):
-							writeElementArrayToPayload(payload, (uint8_t*)((*iterMem)->_memberInfo.ptr), (*iterMem)->_memberInfo.length);
-							break;
-						case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 2):
-							writeElementArrayToPayload(payload, (int16_t*)((*iterMem)->_memberInfo.ptr), (*iterMem)->_memberInfo.length);
-							break;
-						case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 2):
-							writeElementArrayToPayload(payload, (uint16_t*)((*iterMem)->_memberInfo.ptr), (*iterMem)->_memberInfo.length);
-							break;
-						case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 4):
-							writeElementArrayToPayload(payload, (int32_t*)((*iterMem)->_memberInfo.ptr), (*iterMem)->_memberInfo.length);
-							break;
-						case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 4):
-							writeElementArrayToPayload(payload, (uint32_t*)((*iterMem)->_memberInfo.ptr), (*iterMem)->_memberInfo.length);
-							break;
-						case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 8):
-							writeElementArrayToPayload(payload, (int64_t*)((*iterMem)->_memberInfo.ptr), (*iterMem)->_memberInfo.length);
-							break;
-						case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 8):
-							writeElementArrayToPayload(payload, (uint64_t*)((*iterMem)->_memberInfo.ptr), (*iterMem)->_memberInfo.length);
-							break;
-						case (internal::SerializableMemberInfo::EncapType::ETYPE_CHAR):
-							writeElementArrayToPayload(payload, (char*)((*iterMem)->_memberInfo.ptr), (*iterMem)->_memberInfo.length);
-							break;
-						case (internal::SerializableMemberInfo::EncapType::ETYPE_WCHAR):
-							writeElementArrayToPayload(payload, (wchar_t*)((*iterMem)->_memberInfo.ptr), (*iterMem)->_memberInfo.length);
-							break;
-						case (internal::SerializableMemberInfo::EncapType::ETYPE_FLOAT):
-							writeElementArrayToPayload(payload, (float*)((*iterMem)->_memberInfo.ptr), (*iterMem)->_memberInfo.length);
+						case internal::SerializableMemberInfo::EncapType::ETYPE_SUBPAYLOAD:
+							*(JsCPPUtils::SmartPointer<Serializable>*)member->_memberInfo.ptr = readNestedFromPayload(payload, pos, member->_memberInfo.createFactory);
 							break;
-						case (internal::SerializableMemberInfo::EncapType::ETYPE_DOUBLE):
-							writeElementArrayToPayload(payload, (double*)((*iterMem)->_memberInfo.ptr), (*iterMem)->_memberInfo.length);
 						default:
 							throw UnavailableTypeException();
 						}
-						break;
-					default:
-						throw UnavailableTypeException();
 					}
+					break;
+				case internal::SerializableMemberInfo::EncapType::ETYPE_NULL:
+					member->setNull();
+					break;
+				default:
+					throw UnavailableTypeException();
 				}
 			}
 		}
 	}
 
-	void Serializable::deserialize(const std::vector<unsigned char>& payload) throw(ParseException)
+	void Serializable::deserialize(const std::vector<unsigned char>& payload) JSRPC_THROWS(ParseException)
+	{
+		deserialize(payload.empty() ? NULL : &payload[0], payload.size());
+	}
+
+	void Serializable::deserialize(const std::vector<unsigned char>& payload, SerializableArena &arena) JSRPC_THROWS(ParseException)
 	{
+		SerializableArena::Scope scope(arena);
+		deserialize(payload);
+	}
+
+	void Serializable::deserialize(const std::vector<unsigned char>& payload, const DeserializeOptions &options) JSRPC_THROWS(ParseException)
+	{
+		deserialize(payload.empty() ? NULL : &payload[0], payload.size(), options);
+	}
+
+	void Serializable::deserialize(const unsigned char *payload, size_t size, const DeserializeOptions &options) JSRPC_THROWS(ParseException)
+	{
+		internal::DeserializeOptionsScope scope(options);
+		deserialize(payload, size);
+	}
+
+	void Serializable::deserialize(const unsigned char *data, size_t size) JSRPC_THROWS(ParseException)
+	{
+		PayloadView payload(data, size);
 		uint32_t pos = 0;
 		size_t remainsize = 0;
 		size_t totalsize = payload.size();
@@ -627,12 +2237,17 @@ namespace JsRPC {
 		unsigned char serialVersionUID[8];
 
 		std::list<internal::STypeCommon*>::iterator iterMem = m_members.begin();
+		internal::DeserializeFrame frame;
+
+		if (m_membersMissing)
+			throw ParseException();
+		serializableInvalidateCache();
 
 		if (payload.size() < headersize)
 		{
 			throw ParseException();
 		}
-		if (memcmp(&payload[0], header, sizeof(header)))
+		if (!internal::matchHeader(&payload[0], header, sizeof(header)))
 		{
 			throw ParseException();
 		}
@@ -660,299 +2275,32 @@ namespace JsRPC {
 		}
 		pos += 8;
 
+		if (payload[internal::HEADER_FLAGS_POS] & HEADER_FLAG_CHECKSUM)
+		{
+			if (totalsize - pos < internal::CHECKSUM_SIZE)
+				throw ParseException();
+			if (frame.verifyChecksum() && !internal::verifyChecksum(data, totalsize))
+				throw ParseException();
+			totalsize -= internal::CHECKSUM_SIZE;
+			payload = PayloadView(data, totalsize);
+		}
+		else if (frame.requireChecksum())
+		{
+			throw ParseException();
+		}
+
+		if (payload[internal::HEADER_FLAGS_POS] & ~HEADER_FLAG_CHECKSUM)
+		{
+			std::vector<unsigned char> plain;
+			expandPayload(data, totalsize, pos, plain);
+			deserialize(&plain[0], plain.size());
+			return;
+		}
+
 		remainsize = totalsize - pos;
 		while (remainsize > 0 && iterMem != m_members.end())
 		{
-			std::list<internal::SerializableMemberInfo::EncapType>::const_iterator iterEncap = (*iterMem)->_memberInfo.encaps.begin();
-			std::list<internal::SerializableMemberInfo::EncapType>::const_iterator endOfEncap = (*iterMem)->_memberInfo.encaps.end();
-			uint16_t tempEtypeRecv;
-			uint16_t tempEtypeReal;
-			_serializeCheckNotEoo(&tempEtypeReal, &iterEncap, endOfEncap);
-			tempEtypeRecv = readFromPayload<uint16_t>(payload, &pos);
-			(*iterMem)->clear();
-			(*iterMem)->setNull(tempEtypeRecv & internal::SerializableMemberInfo::EncapType::ETYPE_NULL);
-			if (!(tempEtypeRecv & internal::SerializableMemberInfo::EncapType::ETYPE_NULL))
-			{
-				if ((tempEtypeRecv & 0xFF00) == internal::SerializableMemberInfo::EncapType::ETYPE_NATIVE)
-				{
-					switch (tempEtypeRecv & 0x00FF)
-					{
-					case (internal::SerializableMemberInfo::EncapType::ETYPE_BOOL):
-						readElementFromPayload<bool>(payload, &pos, (bool*)((*iterMem)->_memberInfo.ptr));
-						break;
-					case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 1):
-						readElementFromPayload<int8_t>(payload, &pos, (int8_t*)((*iterMem)->_memberInfo.ptr));
-						break;
-					case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 1):
-						readElementFromPayload<uint8_t>(payload, &pos, (uint8_t*)((*iterMem)->_memberInfo.ptr));
-						break;
-					case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 2):
-						readElementFromPayload<int16_t>(payload, &pos, (int16_t*)((*iterMem)->_memberInfo.ptr));
-						break;
-					case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 2):
-						readElementFromPayload<uint16_t>(payload, &pos, (uint16_t*)((*iterMem)->_memberInfo.ptr));
-						break;
-					case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 4):
-						readElementFromPayload<int32_t>(payload, &pos, (int32_t*)((*iterMem)->_memberInfo.ptr));
-						break;
-					case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 4):
-						readElementFromPayload<uint32_t>(payload, &pos, (uint32_t*)((*iterMem)->_memberInfo.ptr));
-						break;
-					case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 8):
-						readElementFromPayload<int64_t>(payload, &pos, (int64_t*)((*iterMem)->_memberInfo.ptr));
-						break;
-					case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 8):
-						readElementFromPayload<uint64_t>(payload, &pos, (uint64_t*)((*iterMem)->_memberInfo.ptr));
-						break;
-					case (internal::SerializableMemberInfo::EncapType::ETYPE_CHAR):
-						readElementFromPayload<char>(payload, &pos, (char*)((*iterMem)->_memberInfo.ptr));
-						break;
-					case (internal::SerializableMemberInfo::EncapType::ETYPE_WCHAR):
-						readElementFromPayload<wchar_t>(payload, &pos, (wchar_t*)((*iterMem)->_memberInfo.ptr));
-						break;
-					case (internal::SerializableMemberInfo::EncapType::ETYPE_FLOAT):
-						readElementFromPayload<float>(payload, &pos, (float*)((*iterMem)->_memberInfo.ptr));
-						break;
-					case (internal::SerializableMemberInfo::EncapType::ETYPE_DOUBLE):
-						readElementFromPayload<double>(payload, &pos, (double*)((*iterMem)->_memberInfo.ptr));
-						break;
-					default:
-						throw UnavailableTypeException();
-					}
-				}
-				else {
-					switch (tempEtypeRecv)
-					{
-					case internal::SerializableMemberInfo::EncapType::ETYPE_STDBASICSTRING:
-						_serializeCheckEoo(&tempEtypeReal, &iterEncap, endOfEncap);
-						tempEtypeRecv = readFromPayload<uint16_t>(payload, &pos);
-						if (iterEncap != endOfEncap)
-							throw UnavailableTypeException();
-						if (checkFlagsAll(tempEtypeReal, internal::SerializableMemberInfo::EncapType::ETYPE_CHAR))
-							readElementFromPayload(payload, &pos, (std::basic_string<char>*)(*iterMem)->_memberInfo.ptr);
-						else if (checkFlagsAll(tempEtypeReal, internal::SerializableMemberInfo::EncapType::ETYPE_WCHAR))
-							readElementFromPayload(payload, &pos, (std::basic_string<wchar_t>*)(*iterMem)->_memberInfo.ptr);
-						else
-							throw UnavailableTypeException();
-						break;
-					case internal::SerializableMemberInfo::EncapType::ETYPE_STDVECTOR:
-						_serializeCheckNotEoo(&tempEtypeReal, &iterEncap, endOfEncap);
-						tempEtypeRecv = readFromPayload<uint16_t>(payload, &pos);
-						if (iterEncap != endOfEncap)
-							throw UnavailableTypeException();
-						if (!(tempEtypeRecv & internal::SerializableMemberInfo::EncapType::ETYPE_NULL))
-						{
-							switch (tempEtypeRecv & 0x00FF)
-							{
-							case (internal::SerializableMemberInfo::EncapType::ETYPE_BOOL):
-								readStdVectorFromPayload(payload, &pos,(std::vector<bool>*)((*iterMem)->_memberInfo.ptr));
-								break;
-							case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 1):
-								readStdVectorFromPayload(payload, &pos, (std::vector<int8_t>*)((*iterMem)->_memberInfo.ptr));
-								break;
-							case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 1):
-								readStdVectorFromPayload(payload, &pos, (std::vector<uint8_t>*)((*iterMem)->_memberInfo.ptr));
-								break;
-							case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 2):
-								readStdVectorFromPayload(payload, &pos, (std::vector<int16_t>*)((*iterMem)->_memberInfo.ptr));
-								break;
-							case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 2):
-								readStdVectorFromPayload(payload, &pos, (std::vector<uint16_t>*)((*iterMem)->_memberInfo.ptr));
-								break;
-							case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 4):
-								readStdVectorFromPayload(payload, &pos, (std::vector<int32_t>*)((*iterMem)->_memberInfo.ptr));
-								break;
-							case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 4):
-								readStdVectorFromPayload(payload, &pos, (std::vector<uint32_t>*)((*iterMem)->_memberInfo.ptr));
-								break;
-							case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 8):
-								readStdVectorFromPayload(payload, &pos, (std::vector<int64_t>*)((*iterMem)->_memberInfo.ptr));
-								break;
-							case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 8):
-								readStdVectorFromPayload(payload, &pos, (std::vector<uint64_t>*)((*iterMem)->_memberInfo.ptr));
-								break;
-							case (internal::SerializableMemberInfo::EncapType::ETYPE_CHAR):
-								readStdVectorFromPayload(payload, &pos, (std::vector<char>*)((*iterMem)->_memberInfo.ptr));
-								break;
-							case (internal::SerializableMemberInfo::EncapType::ETYPE_WCHAR):
-								readStdVectorFromPayload(payload, &pos, (std::vector<wchar_t>*)((*iterMem)->_memberInfo.ptr));
-								break;
-							case (internal::SerializableMemberInfo::EncapType::ETYPE_FLOAT):
-								readStdVectorFromPayload(payload, &pos, (std::vector<float>*)((*iterMem)->_memberInfo.ptr));
-								break;
-							case (internal::SerializableMemberInfo::EncapType::ETYPE_DOUBLE):
-								readStdVectorFromPayload(payload, &pos, (std::vector<double>*)((*iterMem)->_memberInfo.ptr));
-								break;
-							default:
-								throw UnavailableTypeException();
-							}
-						}
-						break;
-					case internal::SerializableMemberInfo::EncapType::ETYPE_STDLIST:
-						_serializeCheckNotEoo(&tempEtypeReal, &iterEncap, endOfEncap);
-						tempEtypeRecv = readFromPayload<uint16_t>(payload, &pos);
-						if (iterEncap == endOfEncap)
-						{
-							throw UnavailableTypeException();
-						}
-						else {
-							switch (tempEtypeReal)
-							{
-							case internal::SerializableMemberInfo::EncapType::ETYPE_SMARTPOINTER:
-								tempEtypeReal = *(iterEncap++);
-								tempEtypeRecv = readFromPayload<uint16_t>(payload, &pos);
-								switch (tempEtypeReal)
-								{
-								case internal::SerializableMemberInfo::EncapType::ETYPE_SUBPAYLOAD:
-									if (iterEncap != endOfEncap)
-										throw UnavailableTypeException();
-									{
-										uint32_t i;
-										uint32_t length = readFromPayload<uint32_t>(payload, &pos);
-										std::list<JsCPPUtils::SmartPointer<Serializable> > *plist = ((std::list<JsCPPUtils::SmartPointer<Serializable> >*)(*iterMem)->_memberInfo.ptr);
-										plist->clear();
-										for (i = 0; i < length; i++)
-										{
-											JsCPPUtils::SmartPointer<Serializable> obj = (*iterMem)->_memberInfo.createFactory->create();
-											readElementFromPayload(payload, &pos, obj.getPtr());
-											plist->push_back(obj);
-										}
-									}
-									break;
-								default:
-									throw UnavailableTypeException();
-								}
-								break;
-							case internal::SerializableMemberInfo::EncapType::ETYPE_STDVECTOR:
-								_serializeCheckEoo(&tempEtypeReal, &iterEncap, endOfEncap);
-								tempEtypeRecv = readFromPayload<uint16_t>(payload, &pos);
-								switch (tempEtypeReal & 0x00FF)
-								{
-								case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 1):
-									readStdListFromPayload(payload, &pos, (std::list< std::vector<int8_t> >*)((*iterMem)->_memberInfo.ptr));
-									break;
-								case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 1):
-									readStdListFromPayload(payload, &pos, (std::list< std::vector<uint8_t> >*)((*iterMem)->_memberInfo.ptr));
-									break;
-								case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 2):
-									readStdListFromPayload(payload, &pos, (std::list< std::vector<int16_t> >*)((*iterMem)->_memberInfo.ptr));
-									break;
-								case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 2):
-									readStdListFromPayload(payload, &pos, (std::list< std::vector<uint16_t> >*)((*iterMem)->_memberInfo.ptr));
-									break;
-								case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 4):
-									readStdListFromPayload(payload, &pos, (std::list< std::vector<int32_t> >*)((*iterMem)->_memberInfo.ptr));
-									break;
-								case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 4):
-									readStdListFromPayload(payload, &pos, (std::list< std::vector<uint32_t> >*)((*iterMem)->_memberInfo.ptr));
-									break;
-								case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 8):
-									readStdListFromPayload(payload, &pos, (std::list< std::vector<int64_t> >*)((*iterMem)->_memberInfo.ptr));
-									break;
-								case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 8):
-									readStdListFromPayload(payload, &pos, (std::list< std::vector<uint64_t> >*)((*iterMem)->_memberInfo.ptr));
-									break;
-								case (internal::SerializableMemberInfo::EncapType::ETYPE_CHAR):
-									readStdListFromPayload(payload, &pos, (std::list< std::vector<char> >*)((*iterMem)->_memberInfo.ptr));
-									break;
-								case (internal::SerializableMemberInfo::EncapType::ETYPE_WCHAR):
-									readStdListFromPayload(payload, &pos, (std::list< std::vector<wchar_t> >*)((*iterMem)->_memberInfo.ptr));
-									break;
-								default:
-									throw UnavailableTypeException();
-								}
-								break;
-							case internal::SerializableMemberInfo::EncapType::ETYPE_STDBASICSTRING:
-								_serializeCheckEoo(&tempEtypeReal, &iterEncap, endOfEncap);
-								tempEtypeRecv = readFromPayload<uint16_t>(payload, &pos);
-								if (checkFlagsAll(tempEtypeReal, internal::SerializableMemberInfo::EncapType::ETYPE_CHAR))
-									readStdListFromPayload(payload, &pos, (std::list< std::basic_string<char> > *)(*iterMem)->_memberInfo.ptr);
-								else if (checkFlagsAll(tempEtypeReal, internal::SerializableMemberInfo::EncapType::ETYPE_WCHAR))
-									readStdListFromPayload(payload, &pos, (std::list<std::basic_string<wchar_t> >*)(*iterMem)->_memberInfo.ptr);
-								else
-									throw UnavailableTypeException();
-								break;
-							default:
-								throw UnavailableTypeException();
-							}
-						}
-						break;
-					case internal::SerializableMemberInfo::EncapType::ETYPE_SUBPAYLOAD:
-						readElementFromPayload(payload, &pos, (Serializable*)(*iterMem)->_memberInfo.ptr);
-						break;
-					case internal::SerializableMemberInfo::EncapType::ETYPE_SMARTPOINTER:
-						tempEtypeReal = *(iterEncap++);
-						tempEtypeRecv = readFromPayload<uint16_t>(payload, &pos);
-						if (tempEtypeRecv & internal::SerializableMemberInfo::EncapType::ETYPE_NULL)
-						{
-							(*iterMem)->setNull();
-						}else{
-							switch (tempEtypeReal & 0xFF00)
-							{
-							case internal::SerializableMemberInfo::EncapType::ETYPE_SUBPAYLOAD:
-								if (!(tempEtypeRecv & internal::SerializableMemberInfo::EncapType::ETYPE_NULL))
-								{
-									JsCPPUtils::SmartPointer<Serializable> obj = (*iterMem)->_memberInfo.createFactory->create();
-									readElementFromPayload(payload, &pos, (Serializable*)obj.getPtr());
-								}
-							default:
-								throw UnavailableTypeException();
-							}
-						}
-						break;
-					case internal::SerializableMemberInfo::EncapType::ETYPE_NATIVEARRAY:
-						switch (tempEtypeRecv & 0x00FF)
-						{
-						case (internal::SerializableMemberInfo::EncapType::ETYPE_BOOL):
-							readElementArrayFromPayload(payload, &pos, (int8_t*)((*iterMem)->_memberInfo.ptr), (*iterMem)->_memberInfo.length);
-							break;
-						case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 1):
-							readElementArrayFromPayload(payload, &pos, (int8_t*)((*iterMem)->_memberInfo.ptr), (*iterMem)->_memberInfo.length);
-							break;
-						case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 1):
-							readElementArrayFromPayload(payload, &pos, (uint8_t*)((*iterMem)->_memberInfo.ptr), (*iterMem)->_memberInfo.length);
-							break;
-						case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 2):
-							readElementArrayFromPayload(payload, &pos, (int16_t*)((*iterMem)->_memberInfo.ptr), (*iterMem)->_memberInfo.length);
-							break;
-						case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 2):
-							readElementArrayFromPayload(payload, &pos, (uint16_t*)((*iterMem)->_memberInfo.ptr), (*iterMem)->_memberInfo.length);
-							break;
-						case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 4):
-							readElementArrayFromPayload(payload, &pos, (int32_t*)((*iterMem)->_memberInfo.ptr), (*iterMem)->_memberInfo.length);
-							break;
-						case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 4):
-							readElementArrayFromPayload(payload, &pos, (uint32_t*)((*iterMem)->_memberInfo.ptr), (*iterMem)->_memberInfo.length);
-							break;
-						case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 8):
-							readElementArrayFromPayload(payload, &pos, (int64_t*)((*iterMem)->_memberInfo.ptr), (*iterMem)->_memberInfo.length);
-							break;
-						case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 8):
-							readElementArrayFromPayload(payload, &pos, (uint64_t*)((*iterMem)->_memberInfo.ptr), (*iterMem)->_memberInfo.length);
-							break;
-						case (internal::SerializableMemberInfo::EncapType::ETYPE_CHAR):
-							readElementArrayFromPayload(payload, &pos, (char*)((*iterMem)->_memberInfo.ptr), (*iterMem)->_memberInfo.length);
-							break;
-						case (internal::SerializableMemberInfo::EncapType::ETYPE_WCHAR):
-							readElementArrayFromPayload(payload, &pos, (wchar_t*)((*iterMem)->_memberInfo.ptr), (*iterMem)->_memberInfo.length);
-							break;
-						case (internal::SerializableMemberInfo::EncapType::ETYPE_FLOAT):
-							readElementArrayFromPayload(payload, &pos, (float*)((*iterMem)->_memberInfo.ptr), (*iterMem)->_memberInfo.length);
-							break;
-						case (internal::SerializableMemberInfo::EncapType::ETYPE_DOUBLE):
-							readElementArrayFromPayload(payload, &pos, (double*)((*iterMem)->_memberInfo.ptr), (*iterMem)->_memberInfo.length);
-						default:
-							throw UnavailableTypeException();
-						}
-						break;
-					case internal::SerializableMemberInfo::EncapType::ETYPE_NULL:
-						(*iterMem)->setNull();
-						break;
-					default:
-						throw UnavailableTypeException();
-					}
-				}
-			}
+			decodeMember(payload, &pos, *iterMem);
 			iterMem++;
 			remainsize = totalsize - pos;
 		}
@@ -29,21 +29,210 @@
 #include <string>
 #include <list>
 #include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <utility>
 #include <exception>
+#include <typeindex>
 
 #if defined(HAS_JSCPPUTILS) && HAS_JSCPPUTILS
 #include <JsCPPUtils/SmartPointer.h>
 #endif
 
+// Dynamic exception specifications were removed in C++17; keep them for older standards only
+#if (__cplusplus >= 201703L) || (defined(_MSVC_LANG) && (_MSVC_LANG >= 201703L))
+#define JSRPC_THROWS(...)
+#else
+#define JSRPC_THROWS(...) throw(__VA_ARGS__)
+#endif
+
 namespace JsRPC {
 
 	class Serializable;
+	class PayloadView;
 	
 	class SerializableCreateFactory
 	{
 	public:
 		virtual Serializable *create() = 0;
-	}; 
+	};
+
+	// Immutable encoded payload, shared by reference count.
+	// Copies are cheap and may be handed to any number of threads.
+	class SerializedPayload
+	{
+	private:
+		std::shared_ptr< const std::vector<unsigned char> > m_bytes;
+
+	public:
+		SerializedPayload() {}
+		explicit SerializedPayload(std::vector<unsigned char>&& payload) :
+			m_bytes(std::make_shared< const std::vector<unsigned char> >(std::move(payload)))
+		{
+		}
+
+		const unsigned char *data() const {
+			return (m_bytes && !m_bytes->empty()) ? &(*m_bytes)[0] : NULL;
+		}
+		size_t size() const {
+			return m_bytes ? m_bytes->size() : 0;
+		}
+		bool empty() const {
+			return size() == 0;
+		}
+		const std::vector<unsigned char> &bytes() const {
+			static const std::vector<unsigned char> emptyBytes;
+			return m_bytes ? *m_bytes : emptyBytes;
+		}
+	};
+
+	namespace internal {
+		class ArenaState;
+		class STypeCommon;
+
+		// Member name -> position in Serializable::serializableMembers().
+		// Built once per class and shared by all of its instances.
+		class MemberNameTable
+		{
+		private:
+			std::vector<std::string> m_names;
+			std::vector<uint32_t> m_hashes;
+			std::vector<int32_t> m_slots;
+			uint32_t m_mask;
+
+		public:
+			explicit MemberNameTable(const std::list<STypeCommon*> &members);
+			explicit MemberNameTable(const std::vector<std::string> &names);
+
+			// Returns -1 if no member has this name
+			int32_t find(const char *name, size_t length) const;
+
+			static uint32_t hash(const char *name, size_t length);
+
+		private:
+			void reserve(size_t count);
+			void insert(const std::string &name);
+		};
+
+		// Process-wide cache that is filled once per key (a class, a registered
+		// type) and then only read. find() takes no lock; insert() serializes
+		// writers. Entries are never moved or replaced, so a pointer returned by
+		// either stays valid until the table itself is destroyed.
+		template<typename Key, typename Value>
+		class AppendOnlyTable
+		{
+		private:
+			struct Node {
+				uint32_t hash;
+				Key key;
+				Value value;
+				const Node *next;
+			};
+			enum { BUCKETS = 256 };
+
+			std::atomic<const Node*> m_buckets[BUCKETS];
+			std::mutex m_mutex;
+
+			AppendOnlyTable(const AppendOnlyTable &obj);
+			AppendOnlyTable &operator=(const AppendOnlyTable &obj);
+
+		public:
+			AppendOnlyTable() {
+				for (int i = 0; i < BUCKETS; i++)
+					m_buckets[i].store(NULL, std::memory_order_relaxed);
+			}
+			~AppendOnlyTable() {
+				for (int i = 0; i < BUCKETS; i++)
+				{
+					const Node *node = m_buckets[i].load(std::memory_order_relaxed);
+					while (node)
+					{
+						const Node *next = node->next;
+						delete node;
+						node = next;
+					}
+				}
+			}
+
+			// match(const Key&) tells the entries that share hash apart
+			template<typename Match>
+			const Value *find(uint32_t hash, Match match) const {
+				for (const Node *node = m_buckets[hash & (BUCKETS - 1)].load(std::memory_order_acquire); node; node = node->next)
+				{
+					if ((node->hash == hash) && match(node->key))
+						return &node->value;
+				}
+				return NULL;
+			}
+
+			// Adds key/value unless match finds an entry first. Returns the entry
+			// that is in the table either way; *inserted tells which.
+			template<typename Match>
+			const Value *insert(uint32_t hash, Match match, const Key &key, const Value &value, bool *inserted) {
+				std::lock_guard<std::mutex> lock(m_mutex);
+				std::atomic<const Node*> &bucket = m_buckets[hash & (BUCKETS - 1)];
+				const Value *existing = find(hash, match);
+				Node *node;
+				*inserted = !existing;
+				if (existing)
+					return existing;
+				node = new Node{ hash, key, value, bucket.load(std::memory_order_relaxed) };
+				bucket.store(node, std::memory_order_release);
+				return &node->value;
+			}
+		};
+
+		// Matcher for an AppendOnlyTable keyed by class
+		struct SameClass
+		{
+			std::type_index type;
+
+			explicit SameClass(const std::type_index &t) : type(t) {}
+			bool operator()(const std::type_index &key) const {
+				return key == type;
+			}
+			uint32_t hash() const {
+				return (uint32_t)type.hash_code();
+			}
+		};
+	}
+
+	// Monotonic allocator for a message tree.
+	// While a Scope is active on a thread, Serializable objects created with new on
+	// that thread (e.g. the nested objects a SerializableCreateFactory makes during
+	// deserialize) are carved out of the arena's chunks. Deleting them frees nothing;
+	// the chunks are released in one shot once the arena and every object allocated
+	// from it are gone, so objects may safely outlive the SerializableArena itself.
+	// An arena must not be used by two threads at the same time.
+	class SerializableArena
+	{
+	public:
+		class Scope
+		{
+		private:
+			internal::ArenaState *m_prev;
+
+			Scope(const Scope &obj);
+			Scope& operator=(const Scope &obj);
+
+		public:
+			explicit Scope(SerializableArena &arena);
+			~Scope();
+		};
+
+	private:
+		internal::ArenaState *m_state;
+
+		SerializableArena(const SerializableArena &obj);
+		SerializableArena& operator=(const SerializableArena &obj);
+
+	public:
+		explicit SerializableArena(size_t chunkSize = 65536);
+		~SerializableArena();
+
+		size_t bytesReserved() const;
+	};
 
 	namespace internal {
 		struct SerializableMemberInfo {
@@ -53,6 +242,8 @@ namespace JsRPC {
 				ETYPE_STDLIST = 3,
 				ETYPE_SUBPAYLOAD = 4,
 				ETYPE_SMARTPOINTER = 5,
+				// Wire only: a list of objects written column by column
+				ETYPE_COLUMNAR = 6,
 				ETYPE_NATIVEARRAY = 0x0200,
 				ETYPE_NULL = 0x8000,
 				ETYPE_NATIVE = 0x0100,
@@ -71,6 +262,8 @@ namespace JsRPC {
 			int32_t length;
 			SerializableCreateFactory *createFactory;
 			bool isNull;
+			bool byReference;
+			bool columnar;
 
 			SerializableMemberInfo(const std::list<EncapType>& _encaps) {
 				this->encaps = _encaps;
@@ -78,17 +271,60 @@ namespace JsRPC {
 				this->length = 0;
 				this->createFactory = NULL;
 				this->isNull = false;
+				this->byReference = false;
+				this->columnar = false;
 			}
 		};
 
+		// Encoding of one column of an ETYPE_COLUMNAR list
+		enum ColumnEncoding {
+			// Native values of every row, null rows zero-filled
+			COLUMN_RAW = 0,
+			// Zigzag varint differences between the non-null integer values
+			COLUMN_DELTA = 1,
+			// The ordinary member encoding of every row
+			COLUMN_ROWS = 2
+		};
+
+		// Wire size of one native element; throws Serializable::ParseException
+		// for other etypes.
+		size_t nativeElementSize(uint16_t etype);
+
+		inline uint64_t zigzagEncode(uint64_t delta) {
+			return (delta << 1) ^ (uint64_t)((int64_t)delta >> 63);
+		}
+		inline uint64_t zigzagDecode(uint64_t value) {
+			return (value >> 1) ^ (0 - (value & 1));
+		}
+
 		class STypeCommon {
 		public:
-			friend class Serializable;
+			friend class JsRPC::Serializable;
 			SerializableMemberInfo _memberInfo;
 
+		protected:
+			Serializable *_owner;
+
+			// Called on every write access: the member is no longer null and
+			// the owner's cached payload (if any) is stale.
+			void touch() {
+				_memberInfo.isNull = false;
+				invalidate();
+			}
+			void invalidate();
+
 		public:
 			STypeCommon(const std::list<internal::SerializableMemberInfo::EncapType>& _encaps) :
 			_memberInfo(_encaps)
+			, _owner(NULL)
+			{
+			}
+			// A copy belongs to no object until the enclosing object's copy/move
+			// constructor rebinds it, see Serializable::serializableRebindMember().
+			// Derived classes re-point _memberInfo.ptr at their own storage.
+			STypeCommon(const STypeCommon &obj) :
+			_memberInfo(obj._memberInfo)
+			, _owner(NULL)
 			{
 			}
 
@@ -100,13 +336,27 @@ namespace JsRPC {
 				this->_memberInfo.createFactory = factory;
 			}
 
+			// For a list of objects: when every element is of the same class, write
+			// the class header once and each member as a column over all elements.
+			void setColumnar(bool value = true) {
+				this->_memberInfo.columnar = value;
+				invalidate();
+			}
+
 			virtual void clear() = 0;
 
+			// Copy/move the value of a member with the same encaps
+			// (used by Serializable::serializableCopyFrom/serializableMoveFrom).
+			virtual void copyValueFrom(const STypeCommon &other) = 0;
+			virtual void moveValueFrom(STypeCommon &other) = 0;
+
 			void setNull() {
 				_memberInfo.isNull = true;
+				invalidate();
 			}
 			void setNull(bool value) {
 				_memberInfo.isNull = value;
+				invalidate();
 			}
 			const bool isNull() const {
 				return _memberInfo.isNull;
@@ -128,30 +378,59 @@ namespace JsRPC {
 			STypeCommon(_encaps)
 		{
 		}
+		STypeBase(const STypeBase<T>& obj) :
+			STypeCommon(obj)
+			, _value(obj._value)
+		{
+			this->_memberInfo.ptr = &_value;
+		}
+		STypeBase(STypeBase<T>&& obj) :
+			STypeCommon(obj)
+			, _value(std::move(obj._value))
+		{
+			this->_memberInfo.ptr = &_value;
+		}
 
 	public:
 		virtual ~STypeBase() { }
 
-		void set(const T value) {
-			this->_memberInfo.isNull = false;
+		void set(const T& value) {
+			this->touch();
 			this->_value = value;
 		}
+		void set(T&& value) {
+			this->touch();
+			this->_value = std::move(value);
+		}
 		const T& get() const {
 			return this->_value;
 		}
 
 		T& operator*() {
-			this->_memberInfo.isNull = false;
+			this->touch();
 			return this->_value;
 		}
 		const T& operator*() const {
 			return this->_value;
 		}
 
+		void copyValueFrom(const internal::STypeCommon &other) override {
+			this->_value = *(const T*)other._memberInfo.ptr;
+		}
+		void moveValueFrom(internal::STypeCommon &other) override {
+			this->_value = std::move(*(T*)other._memberInfo.ptr);
+		}
+
 		STypeBase<T> &operator=(const STypeBase<T>& obj) {
 			this->setNull(obj.isNull());
 			if (!obj.isNull())
-				this->_value = obj.get();
+				this->copyValueFrom(obj);
+			return *this;
+		}
+		STypeBase<T> &operator=(STypeBase<T>&& obj) {
+			this->setNull(obj.isNull());
+			if (!obj.isNull())
+				this->moveValueFrom(obj);
 			return *this;
 		}
 	};
@@ -165,31 +444,53 @@ namespace JsRPC {
 			STypeCommon(_encaps)
 			, _value(refvalue)
 		{
+			this->_memberInfo.byReference = true;
 		}
 
+	private:
+		// A copy would still refer to the source's storage
+		SRefTypeBase(const SRefTypeBase<T>& obj);
+
 	public:
 		virtual ~SRefTypeBase() { }
 
-		void set(const T value) {
-			this->_memberInfo.isNull = false;
+		void set(const T& value) {
+			this->touch();
 			this->_value = value;
 		}
+		void set(T&& value) {
+			this->touch();
+			this->_value = std::move(value);
+		}
 		const T get() const {
 			return this->_value;
 		}
 
 		T& operator*() {
-			this->_memberInfo.isNull = false;
+			this->touch();
 			return this->_value;
 		}
 		const T& operator*() const {
 			return this->_value;
 		}
 
+		void copyValueFrom(const internal::STypeCommon &other) override {
+			this->_value = *(const T*)other._memberInfo.ptr;
+		}
+		void moveValueFrom(internal::STypeCommon &other) override {
+			this->_value = std::move(*(T*)other._memberInfo.ptr);
+		}
+
 		SRefTypeBase<T> &operator=(const SRefTypeBase<T>& obj) {
 			this->setNull(obj.isNull());
 			if (!obj.isNull())
-				this->_value = obj.get();
+				this->copyValueFrom(obj);
+			return *this;
+		}
+		SRefTypeBase<T> &operator=(SRefTypeBase<T>&& obj) {
+			this->setNull(obj.isNull());
+			if (!obj.isNull())
+				this->moveValueFrom(obj);
 			return *this;
 		}
 	};
@@ -199,34 +500,53 @@ namespace JsRPC {
 	protected:
 		T _value[arraySize];
 
-		SArrayTypeBase(int _ptype, const std::list<internal::SerializableMemberInfo::EncapType>& _encaps) :
-			STypeCommon((internal::SerializableMemberInfo::ProtoType)_ptype, _encaps)
+		SArrayTypeBase(const std::list<internal::SerializableMemberInfo::EncapType>& _encaps) :
+			STypeCommon(_encaps)
 		{
 		}
+		SArrayTypeBase(const SArrayTypeBase<T, arraySize>& obj) :
+			STypeCommon(obj)
+		{
+			memcpy(this->_value, obj._value, sizeof(this->_value));
+			this->_memberInfo.ptr = this->_value;
+		}
 
 	public:
 		virtual ~SArrayTypeBase() { }
 
-		T& operator*() {
-			this->_memberInfo.isNull = false;
+		T (&operator*())[arraySize] {
+			this->touch();
 			return this->_value;
 		}
-		const T& operator*() const {
+		const T (&operator*() const)[arraySize] {
 			return this->_value;
 		}
-		void set(const T value) {
-			this->_memberInfo.isNull = false;
-			this->_value = value;
+		T& operator[](int index) {
+			this->touch();
+			return this->_value[index];
 		}
-		const T get() const {
+		const T& operator[](int index) const {
+			return this->_value[index];
+		}
+		void set(const T (&value)[arraySize]) {
+			this->touch();
+			memcpy(this->_value, value, sizeof(this->_value));
+		}
+		const T (&get() const)[arraySize] {
 			return this->_value;
 		}
 
+		void copyValueFrom(const internal::STypeCommon &other) override {
+			memcpy(this->_value, other._memberInfo.ptr, sizeof(T) * arraySize);
+		}
+		void moveValueFrom(internal::STypeCommon &other) override {
+			copyValueFrom(other);
+		}
+
 		SArrayTypeBase<T, arraySize> &operator=(const SArrayTypeBase<T, arraySize>& obj) {
 			this->setNull(obj.isNull());
-			if (!obj.isNull()) {
-				memcpy(this->_value, obj.get(), sizeof(this->_value));
-			}
+			if (!obj.isNull())
+				this->copyValueFrom(obj);
 			return *this;
 		}
 	};
@@ -236,35 +556,52 @@ namespace JsRPC {
 	protected:
 		T (&_value)[arraySize];
 
-		SArrayTypeRefBase(int _ptype, const std::list<internal::SerializableMemberInfo::EncapType>& _encaps, T (&refvalue)[arraySize]) :
-			STypeCommon((internal::SerializableMemberInfo::ProtoType)_ptype, _encaps)
+		SArrayTypeRefBase(const std::list<internal::SerializableMemberInfo::EncapType>& _encaps, T (&refvalue)[arraySize]) :
+			STypeCommon(_encaps)
 			, _value(refvalue)
 		{
+			this->_memberInfo.byReference = true;
 		}
 
+	private:
+		SArrayTypeRefBase(const SArrayTypeRefBase<T, arraySize>& obj);
+
 	public:
 		virtual ~SArrayTypeRefBase() { }
 
-		T& operator*() {
-			this->_memberInfo.isNull = false;
+		T (&operator*())[arraySize] {
+			this->touch();
 			return this->_value;
 		}
-		const T& operator*() const {
+		const T (&operator*() const)[arraySize] {
 			return this->_value;
 		}
-		void set(const T value) {
-			this->_memberInfo.isNull = false;
-			this->_value = value;
+		T& operator[](int index) {
+			this->touch();
+			return this->_value[index];
 		}
-		const T get() const {
+		const T& operator[](int index) const {
+			return this->_value[index];
+		}
+		void set(const T (&value)[arraySize]) {
+			this->touch();
+			memcpy(this->_value, value, sizeof(this->_value));
+		}
+		const T (&get() const)[arraySize] {
 			return this->_value;
 		}
 
+		void copyValueFrom(const internal::STypeCommon &other) override {
+			memcpy(this->_value, other._memberInfo.ptr, sizeof(T) * arraySize);
+		}
+		void moveValueFrom(internal::STypeCommon &other) override {
+			copyValueFrom(other);
+		}
+
 		SArrayTypeRefBase<T, arraySize> &operator=(const SArrayTypeRefBase<T, arraySize>& obj) {
 			this->setNull(obj.isNull());
-			if (!obj.isNull()) {
-				memcpy(this->_value, obj.get(), sizeof(this->_value));
-			}
+			if (!obj.isNull())
+				this->copyValueFrom(obj);
 			return *this;
 		}
 	};
@@ -297,7 +634,6 @@ namespace JsRPC {
 	{
 	protected:
 		T _value;
-		Serializable *_test;
 
 		//internal::SerializableMemberInfo::ProtoType _ptype, const std::list<internal::SerializableMemberInfo::EncapType>& _encaps
 
@@ -305,35 +641,60 @@ namespace JsRPC {
 		SSerializableType() : 
 			STypeCommon({ internal::SerializableMemberInfo::ETYPE_SUBPAYLOAD })
 		{
-			this->_test = &this->_value;
 			this->_memberInfo.ptr = &_value;
 			this->_memberInfo.length = 1;
 		}
+		// The nested object is built fresh and filled member-wise, so T needs no
+		// copy/move constructor of its own
+		SSerializableType(const SSerializableType& obj) :
+			STypeCommon(obj)
+		{
+			this->_memberInfo.ptr = &_value;
+			_value.serializableCopyFrom(obj._value);
+		}
+		SSerializableType(SSerializableType&& obj) :
+			STypeCommon(obj)
+		{
+			this->_memberInfo.ptr = &_value;
+			_value.serializableMoveFrom(obj._value);
+		}
 		virtual ~SSerializableType() {}
 
 		void clear() override {
 			_value.serializableClearObjects();
 		}
+		void copyValueFrom(const internal::STypeCommon &other) override {
+			_value.serializableCopyFrom(*(const T*)other._memberInfo.ptr);
+		}
+		void moveValueFrom(internal::STypeCommon &other) override {
+			_value.serializableMoveFrom(*(T*)other._memberInfo.ptr);
+		}
 
 		T& operator*() {
-			this->_memberInfo.isNull = false;
+			this->touch();
 			return this->_value;
 		}
 		const T& operator*() const {
 			return this->_value;
 		}
-		void set(const T value) {
-			this->_memberInfo.isNull = false;
+		void set(const T& value) {
+			this->touch();
 			this->_value = value;
 		}
+		void set(T&& value) {
+			this->touch();
+			this->_value = std::move(value);
+		}
 		const T &get() const {
 			return this->_value;
 		}
 		void setNull() {
 			this->_memberInfo.isNull = true;
+			this->invalidate();
 		}
 		void setNull(bool value) {
 			this->_memberInfo.isNull = value;
+			this->invalidate();
 		}
 		const bool isNull() const {
 			return this->_memberInfo.isNull;
@@ -341,20 +702,20 @@ namespace JsRPC {
 
 		SSerializableType<T> &operator=(const SSerializableType<T>& obj) {
 			this->setNull(obj.isNull());
-			if (!obj.isNull()) {
-				std::vector<uint8_t> payload;
-				obj._test->serialize(payload);
-				this->_test->deserialize(payload);
-			}
+			if (!obj.isNull())
+				this->copyValueFrom(obj);
+			return *this;
+		}
+		SSerializableType<T> &operator=(SSerializableType<T>&& obj) {
+			this->setNull(obj.isNull());
+			if (!obj.isNull())
+				this->moveValueFrom(obj);
 			return *this;
 		}
 		SSerializableType<T> &operator=(const SSerializableRefType<T>& obj) {
 			this->setNull(obj.isNull());
-			if (!obj.isNull()) {
-				std::vector<uint8_t> payload;
-				obj._test->serialize(payload);
-				this->_test->deserialize(payload);
-			}
+			if (!obj.isNull())
+				this->copyValueFrom(obj);
 			return *this;
 		}
 	};
@@ -363,7 +724,6 @@ namespace JsRPC {
 	{
 	protected:
 		T &_value;
-		Serializable *_test;
 
 		//internal::SerializableMemberInfo::ProtoType _ptype, const std::list<internal::SerializableMemberInfo::EncapType>& _encaps
 
@@ -372,35 +732,52 @@ namespace JsRPC {
 			STypeCommon({ internal::SerializableMemberInfo::ETYPE_SUBPAYLOAD })
 			, _value(refvalue)
 		{
-			this->_test = &this->_value;
+			this->_memberInfo.byReference = true;
 			this->_memberInfo.ptr = &_value;
 			this->_memberInfo.length = 1;
 		}
 		virtual ~SSerializableRefType() {}
 
+	private:
+		SSerializableRefType(const SSerializableRefType& obj);
+
+	public:
+
 		void clear() override {
 			_value.serializableClearObjects();
 		}
+		void copyValueFrom(const internal::STypeCommon &other) override {
+			_value.serializableCopyFrom(*(const T*)other._memberInfo.ptr);
+		}
+		void moveValueFrom(internal::STypeCommon &other) override {
+			_value.serializableMoveFrom(*(T*)other._memberInfo.ptr);
+		}
 
 		T& operator*() {
-			this->_memberInfo.isNull = false;
+			this->touch();
 			return this->_value;
 		}
 		const T& operator*() const {
 			return this->_value;
 		}
-		void set(const T value) {
-			this->_memberInfo.isNull = false;
+		void set(const T& value) {
+			this->touch();
 			this->_value = value;
 		}
-		const T get() const {
+		void set(T&& value) {
+			this->touch();
+			this->_value = std::move(value);
+		}
+		const T &get() const {
 			return this->_value;
 		}
 		void setNull() {
 			this->_memberInfo.isNull = true;
+			this->invalidate();
 		}
 		void setNull(bool value) {
 			this->_memberInfo.isNull = value;
+			this->invalidate();
 		}
 		const bool isNull() const {
 			return this->_memberInfo.isNull;
@@ -408,26 +785,30 @@ namespace JsRPC {
 
 		SSerializableRefType<T> &operator=(const SSerializableType<T>& obj) {
 			this->setNull(obj.isNull());
-			if (!obj.isNull()) {
-				std::vector<uint8_t> payload;
-				obj._test->serialize(payload);
-				this->_test->deserialize(payload);
-			}
+			if (!obj.isNull())
+				this->copyValueFrom(obj);
 			return *this;
 		}
 		SSerializableRefType<T> &operator=(const SSerializableRefType<T>& obj) {
 			this->setNull(obj.isNull());
-			if (!obj.isNull()) {
-				std::vector<uint8_t> payload;
-				obj._test->serialize(payload);
-				this->_test->deserialize(payload);
-			}
+			if (!obj.isNull())
+				this->copyValueFrom(obj);
 			return *this;
 		}
 	};
 
 #if defined(HAS_JSCPPUTILS) && HAS_JSCPPUTILS
 
+	namespace internal {
+		// Deep copy of a nested object, created through factory or, without one,
+		// through SerializableTypeRegistry. Throws UnavailableTypeException if the
+		// class cannot be created.
+		Serializable *cloneSerializable(const Serializable &src, SerializableCreateFactory *factory);
+
+		template <typename T>
+		JsCPPUtils::SmartPointer<T> cloneSmartPointer(const JsCPPUtils::SmartPointer<T> &src, SerializableCreateFactory *factory);
+	}
+
 	template <typename T>
 	class SSerializableRefType< JsCPPUtils::SmartPointer<T> >;
 
@@ -444,21 +825,40 @@ namespace JsRPC {
 			this->_memberInfo.ptr = &_value;
 			this->_memberInfo.length = 1;
 		}
+		SSerializableType(const SSerializableType& obj) :
+			STypeCommon(obj)
+			, _value(internal::cloneSmartPointer(obj._value, obj._memberInfo.createFactory))
+		{
+			this->_memberInfo.ptr = &_value;
+		}
+		SSerializableType(SSerializableType&& obj) :
+			STypeCommon(obj)
+			, _value(std::move(obj._value))
+		{
+			this->_memberInfo.ptr = &_value;
+		}
 		virtual ~SSerializableType() {}
 
 		void clear() override {
 			_value = NULL;
 		}
+		void copyValueFrom(const internal::STypeCommon &other) override {
+			_value = internal::cloneSmartPointer(*(const JsCPPUtils::SmartPointer<T>*)other._memberInfo.ptr, _memberInfo.createFactory);
+		}
+		void moveValueFrom(internal::STypeCommon &other) override {
+			_value = *(const JsCPPUtils::SmartPointer<T>*)other._memberInfo.ptr;
+			*(JsCPPUtils::SmartPointer<T>*)other._memberInfo.ptr = NULL;
+		}
 
 		T& operator*() {
-			this->_memberInfo.isNull = false;
+			this->touch();
 			return this->_value;
 		}
 		const T& operator*() const {
 			return this->_value;
 		}
 		void set(const T value) {
-			this->_memberInfo.isNull = false;
+			this->touch();
 			this->_value = value;
 		}
 		const T &get() const {
@@ -466,6 +866,7 @@ namespace JsRPC {
 		}
 		void setNull() {
 			this->_memberInfo.isNull = true;
+			this->invalidate();
 		}
 		const bool isNull() {
 			return this->_memberInfo.isNull;
@@ -473,14 +874,14 @@ namespace JsRPC {
 		SSerializableType< JsCPPUtils::SmartPointer<T> > &operator=(const SSerializableType< JsCPPUtils::SmartPointer<T> >& obj) {
 			this->setNull(obj.isNull());
 			if (!obj.isNull()) {
-				this->set(obj.get());
+				this->copyValueFrom(obj);
 			}
 			return *this;
 		}
 		SSerializableType< JsCPPUtils::SmartPointer<T> > &operator=(const SSerializableRefType< JsCPPUtils::SmartPointer<T> >& obj) {
 			this->setNull(obj.isNull());
 			if (!obj.isNull()) {
-				this->set(obj.get());
+				this->copyValueFrom(obj);
 			}
 			return *this;
 		}
@@ -496,24 +897,37 @@ namespace JsRPC {
 			STypeCommon({ internal::SerializableMemberInfo::ETYPE_SMARTPOINTER, internal::SerializableMemberInfo::ETYPE_SUBPAYLOAD })
 			, _value(refvalue)
 		{
+			this->_memberInfo.byReference = true;
 			this->_memberInfo.ptr = &_value;
 			this->_memberInfo.length = 1;
 		}
 		virtual ~SSerializableRefType() {}
 
+	private:
+		SSerializableRefType(const SSerializableRefType& obj);
+
+	public:
+
 		void clear() override {
 			_value = NULL;
 		}
+		void copyValueFrom(const internal::STypeCommon &other) override {
+			_value = internal::cloneSmartPointer(*(const JsCPPUtils::SmartPointer<T>*)other._memberInfo.ptr, _memberInfo.createFactory);
+		}
+		void moveValueFrom(internal::STypeCommon &other) override {
+			_value = *(const JsCPPUtils::SmartPointer<T>*)other._memberInfo.ptr;
+			*(JsCPPUtils::SmartPointer<T>*)other._memberInfo.ptr = NULL;
+		}
 
 		T& operator*() {
-			this->_memberInfo.isNull = false;
+			this->touch();
 			return this->_value;
 		}
 		const T& operator*() const {
 			return this->_value;
 		}
 		void set(const T value) {
-			this->_memberInfo.isNull = false;
+			this->touch();
 			this->_value = value;
 		}
 		const T get() const {
@@ -521,6 +935,7 @@ namespace JsRPC {
 		}
 		void setNull() {
 			this->_memberInfo.isNull = true;
+			this->invalidate();
 		}
 		const bool isNull() const {
 			return this->_memberInfo.isNull;
@@ -528,14 +943,14 @@ namespace JsRPC {
 		SSerializableRefType< JsCPPUtils::SmartPointer<T> > &operator=(const SSerializableType< JsCPPUtils::SmartPointer<T> >& obj) {
 			this->setNull(obj.isNull());
 			if (!obj.isNull()) {
-				this->set(obj.get());
+				this->copyValueFrom(obj);
 			}
 			return *this;
 		}
 		SSerializableRefType< JsCPPUtils::SmartPointer<T> > &operator=(const SSerializableRefType< JsCPPUtils::SmartPointer<T> >& obj) {
 			this->setNull(obj.isNull());
 			if (!obj.isNull()) {
-				this->set(obj.get());
+				this->copyValueFrom(obj);
 			}
 			return *this;
 		}
@@ -553,7 +968,7 @@ namespace JsRPC {
 		} \
 		void clear() override { _value = (CTYPE)0; } \
 		SType<CTYPE>& operator=(const CTYPE& value) { \
-			this->_memberInfo.isNull = false; \
+			this->touch(); \
 			this->_value = value; \
 			return *this; \
 		} \
@@ -568,7 +983,7 @@ namespace JsRPC {
 		} \
 		void clear() override { _value = (CTYPE)0; } \
 		SRefType<CTYPE>& operator=(const CTYPE& value) { \
-			this->_memberInfo.isNull = false; \
+			this->touch(); \
 			this->_value = value; \
 			return *this; \
 		} \
@@ -598,12 +1013,17 @@ namespace JsRPC {
 		} \
 		void clear() override { _value.clear(); } \
 		SType< std::basic_string<CTYPE> >& operator=(const std::basic_string<CTYPE>& value) { \
-			this->_memberInfo.isNull = false; \
+			this->touch(); \
 			this->_value = value; \
 			return *this; \
 		} \
+		SType< std::basic_string<CTYPE> >& operator=(std::basic_string<CTYPE>&& value) { \
+			this->touch(); \
+			this->_value = std::move(value); \
+			return *this; \
+		} \
 		std::basic_string<CTYPE>& operator->() { \
-			this->_memberInfo.isNull = false; \
+			this->touch(); \
 			return this->_value; \
 		} \
 	}; \
@@ -617,12 +1037,17 @@ namespace JsRPC {
 		} \
 		void clear() override { _value.clear(); } \
 		SRefType< std::basic_string<CTYPE> >& operator=(const std::basic_string<CTYPE>& value) { \
-			this->_memberInfo.isNull = false; \
+			this->touch(); \
 			this->_value = value; \
 			return *this; \
 		} \
+		SRefType< std::basic_string<CTYPE> >& operator=(std::basic_string<CTYPE>&& value) { \
+			this->touch(); \
+			this->_value = std::move(value); \
+			return *this; \
+		} \
 		std::basic_string<CTYPE>& operator->() { \
-			this->_memberInfo.isNull = false; \
+			this->touch(); \
 			return this->_value; \
 		} \
 	};
@@ -637,8 +1062,18 @@ namespace JsRPC {
 			this->_memberInfo.length = 1; \
 		} \
 		void clear() override { _value.clear(); } \
+		SType< std::vector<CTYPE> >& operator=(const std::vector<CTYPE>& value) { \
+			this->touch(); \
+			this->_value = value; \
+			return *this; \
+		} \
+		SType< std::vector<CTYPE> >& operator=(std::vector<CTYPE>&& value) { \
+			this->touch(); \
+			this->_value = std::move(value); \
+			return *this; \
+		} \
 		std::vector<CTYPE>& operator->() { \
-			this->_memberInfo.isNull = false; \
+			this->touch(); \
 			return this->_value; \
 		} \
 	}; \
@@ -651,8 +1086,18 @@ namespace JsRPC {
 			this->_memberInfo.length = 1; \
 		} \
 		void clear() override { _value.clear(); } \
+		SRefType< std::vector<CTYPE> >& operator=(const std::vector<CTYPE>& value) { \
+			this->touch(); \
+			this->_value = value; \
+			return *this; \
+		} \
+		SRefType< std::vector<CTYPE> >& operator=(std::vector<CTYPE>&& value) { \
+			this->touch(); \
+			this->_value = std::move(value); \
+			return *this; \
+		} \
 		std::vector<CTYPE>& operator->() { \
-			this->_memberInfo.isNull = false; \
+			this->touch(); \
 			return this->_value; \
 		} \
 	};
@@ -668,12 +1113,17 @@ namespace JsRPC {
 		} \
 		void clear() override { _value.clear(); } \
 		SType< std::list<std::vector<CTYPE> > >& operator=(const std::list<std::vector<CTYPE> >& value) { \
-			this->_memberInfo.isNull = false; \
+			this->touch(); \
 			this->_value = value; \
 			return *this; \
 		} \
+		SType< std::list<std::vector<CTYPE> > >& operator=(std::list<std::vector<CTYPE> >&& value) { \
+			this->touch(); \
+			this->_value = std::move(value); \
+			return *this; \
+		} \
 		std::list<std::vector<CTYPE> >& operator->() { \
-			this->_memberInfo.isNull = false; \
+			this->touch(); \
 			return this->_value; \
 		} \
 	}; \
@@ -687,12 +1137,17 @@ namespace JsRPC {
 		} \
 		void clear() override { _value.clear(); } \
 		SRefType< std::list<std::vector<CTYPE> > >& operator=(const std::list<std::vector<CTYPE> >& value) { \
-			this->_memberInfo.isNull = false; \
+			this->touch(); \
 			this->_value = value; \
 			return *this; \
 		} \
+		SRefType< std::list<std::vector<CTYPE> > >& operator=(std::list<std::vector<CTYPE> >&& value) { \
+			this->touch(); \
+			this->_value = std::move(value); \
+			return *this; \
+		} \
 		std::list<std::vector<CTYPE> >& operator->() { \
-			this->_memberInfo.isNull = false; \
+			this->touch(); \
 			return this->_value; \
 		} \
 	};
@@ -708,12 +1163,17 @@ namespace JsRPC {
 		} \
 		void clear() override { _value.clear(); } \
 		SType< std::list<std::basic_string<CTYPE> > >& operator=(const std::list<std::basic_string<CTYPE> >& value) { \
-			this->_memberInfo.isNull = false; \
+			this->touch(); \
 			this->_value = value; \
 			return *this; \
 		} \
+		SType< std::list<std::basic_string<CTYPE> > >& operator=(std::list<std::basic_string<CTYPE> >&& value) { \
+			this->touch(); \
+			this->_value = std::move(value); \
+			return *this; \
+		} \
 		std::list<std::basic_string<CTYPE> >& operator->() { \
-			this->_memberInfo.isNull = false; \
+			this->touch(); \
 			return this->_value; \
 		} \
 	}; \
@@ -727,12 +1187,17 @@ namespace JsRPC {
 		} \
 		void clear() override { _value.clear(); } \
 		SRefType< std::list<std::basic_string<CTYPE> > >& operator=(const std::list<std::basic_string<CTYPE> >& value) { \
-			this->_memberInfo.isNull = false; \
+			this->touch(); \
 			this->_value = value; \
 			return *this; \
 		} \
+		SRefType< std::list<std::basic_string<CTYPE> > >& operator=(std::list<std::basic_string<CTYPE> >&& value) { \
+			this->touch(); \
+			this->_value = std::move(value); \
+			return *this; \
+		} \
 		std::list<std::basic_string<CTYPE> >& operator->() { \
-			this->_memberInfo.isNull = false; \
+			this->touch(); \
 			return this->_value; \
 		} \
 	};
@@ -745,14 +1210,32 @@ namespace JsRPC {
 			this->_memberInfo.ptr = &_value;
 			this->_memberInfo.length = 1;
 		}
+		SType(const SType< std::list< JsCPPUtils::SmartPointer<Serializable> > >& obj);
+		SType(SType< std::list< JsCPPUtils::SmartPointer<Serializable> > >&& obj) :
+			STypeBase(std::move(obj)) {
+		}
+		SType< std::list<JsCPPUtils::SmartPointer<Serializable> > >& operator=(const SType< std::list<JsCPPUtils::SmartPointer<Serializable> > >& obj) {
+			STypeBase::operator=(obj);
+			return *this;
+		}
+		SType< std::list<JsCPPUtils::SmartPointer<Serializable> > >& operator=(SType< std::list<JsCPPUtils::SmartPointer<Serializable> > >&& obj) {
+			STypeBase::operator=(std::move(obj));
+			return *this;
+		}
 		void clear() override { _value.clear(); }
+		void copyValueFrom(const internal::STypeCommon &other) override;
 		SType< std::list<JsCPPUtils::SmartPointer<Serializable> > >& operator=(const std::list<JsCPPUtils::SmartPointer<Serializable> >& value) {
-			this->_memberInfo.isNull = false;
+			this->touch();
 			this->_value = value;
 			return *this;
 		}
+		SType< std::list<JsCPPUtils::SmartPointer<Serializable> > >& operator=(std::list<JsCPPUtils::SmartPointer<Serializable> >&& value) {
+			this->touch();
+			this->_value = std::move(value);
+			return *this;
+		}
 		std::list<JsCPPUtils::SmartPointer<Serializable> >& operator->() {
-			this->_memberInfo.isNull = false;
+			this->touch();
 			return this->_value;
 		}
 	};
@@ -765,13 +1248,19 @@ namespace JsRPC {
 			this->_memberInfo.length = 1;
 		}
 		void clear() override { _value.clear(); }
+		void copyValueFrom(const internal::STypeCommon &other) override;
 		SRefType< std::list<JsCPPUtils::SmartPointer<Serializable> > >& operator=(const std::list<JsCPPUtils::SmartPointer<Serializable> >& value) {
-			this->_memberInfo.isNull = false;
+			this->touch();
 			this->_value = value;
 			return *this;
 		}
+		SRefType< std::list<JsCPPUtils::SmartPointer<Serializable> > >& operator=(std::list<JsCPPUtils::SmartPointer<Serializable> >&& value) {
+			this->touch();
+			this->_value = std::move(value);
+			return *this;
+		}
 		std::list<JsCPPUtils::SmartPointer<Serializable> >& operator->() {
-			this->_memberInfo.isNull = false;
+			this->touch();
 			return this->_value;
 		}
 	};
@@ -781,11 +1270,11 @@ namespace JsRPC {
 	class SArrayType<CTYPE, arraySize> : public SArrayTypeBase<CTYPE, arraySize> { \
 	public: \
 		SArrayType() : \
-		SArrayTypeBase({ internal::SerializableMemberInfo::ETYPE_NATIVEARRAY | ((internal::SerializableMemberInfo::EncapType)(ETYPE)) }) { \
-			this->_memberInfo.ptr = _value; \
+		SArrayTypeBase<CTYPE, arraySize>({ (internal::SerializableMemberInfo::EncapType)(internal::SerializableMemberInfo::ETYPE_NATIVEARRAY | (ETYPE)) }) { \
+			this->_memberInfo.ptr = this->_value; \
 			this->_memberInfo.length = arraySize; \
 		} \
-		void clear() override { memset(_value, 0, sizeof(_value)); } \
+		void clear() override { memset(this->_value, 0, sizeof(this->_value)); } \
 	};
 
 	__JSRPC_SERIALIZABLE_GENSTYPE(bool, internal::SerializableMemberInfo::ETYPE_BOOL)
@@ -850,6 +1339,40 @@ namespace JsRPC {
 	__JSRPC_SERIALIZABLE_GENSARRAYTYPE_LIST_VECTOR(float, internal::SerializableMemberInfo::ETYPE_FLOAT)
 	__JSRPC_SERIALIZABLE_GENSARRAYTYPE_LIST_VECTOR(double, internal::SerializableMemberInfo::ETYPE_DOUBLE)
 
+	struct SerializeOptions
+	{
+		// Member data of at least this many bytes is block-compressed (0 = never).
+		// Only the outermost object is compressed; the header stays readable.
+		size_t compressThreshold;
+		// Repeated char strings, including those in nested objects, are written
+		// once and then referred to by number.
+		bool internStrings;
+		// A CRC-32C of the finished payload is appended as a trailing u32, so
+		// corruption is caught before any member is decoded.
+		bool checksum;
+		// Nested objects also get a trailer of their own, so a sub-payload taken
+		// out of the message can be checked by itself. Disables encode caching.
+		bool checksumNested;
+
+		SerializeOptions() :
+			compressThreshold(0), internStrings(false), checksum(false), checksumNested(false)
+		{ }
+	};
+
+	struct DeserializeOptions
+	{
+		// Reject an outermost payload that carries no checksum
+		bool requireChecksum;
+		// Nested objects with their own trailer are verified too. The outer
+		// checksum already covers their bytes, so turning this off trades
+		// nothing but the ability to tell which object was corrupted.
+		bool verifyNestedChecksums;
+
+		DeserializeOptions() :
+			requireChecksum(false), verifyNestedChecksums(true)
+		{ }
+	};
+
 	class Serializable
 	{
 	public:
@@ -858,59 +1381,229 @@ namespace JsRPC {
 		class ParseException : public std::exception
 		{ };
 
+		// Bits of header byte 4, which plain payloads leave at 0
+		enum HeaderFlags {
+			HEADER_FLAG_COMPRESSED = 0x01,
+			HEADER_FLAG_STRING_TABLE = 0x02,
+			// Payload ends with a u32 CRC-32C of every byte before it
+			HEADER_FLAG_CHECKSUM = 0x04
+		};
+
 	private:
 		static const unsigned char header[];
 		std::string m_name;
 		int64_t m_serialVersionUID;
 		std::list<internal::STypeCommon*> m_members;
 
+		// Encoded-bytes cache, see serializableSetCacheEnabled()
+		Serializable *m_cacheParent;
+		std::atomic<bool> m_cacheEnabled;
+		bool m_cacheable;
+		std::atomic<uint32_t> m_generation;
+		mutable std::mutex m_cacheMutex;
+		mutable SerializedPayload m_cachePayload;
+		mutable uint32_t m_cacheGeneration;
+
+		// Members a copied/moved object had that are not rebound here yet. Stays
+		// non-zero on a sliced copy or when a subclass uses the implicit copy
+		// constructor.
+		size_t m_membersMissing;
+
+		// m_members in random-access form, and the class-wide name table
+		std::vector<internal::STypeCommon*> m_memberIndex;
+		mutable std::atomic<const internal::MemberNameTable*> m_nameTable;
+
 	protected:
+		// The copy/move constructors take over no members. A subclass that is
+		// copied or moved copies its member wrappers and rebinds each of them:
+		//
+		//   Row(const Row &obj) : Serializable(obj), id(obj.id), name(obj.name) {
+		//       serializableRebindMember(id);
+		//       serializableRebindMember(name);
+		//   }
+		//
+		// Until every member of the source is rebound (a sliced copy, or an
+		// implicit copy constructor), encoding, decoding or copying the object
+		// throws UnavailableTypeException/ParseException.
+		Serializable(const Serializable &obj);
 #if (__cplusplus >= 201103) || (__cplusplus == 199711) || (defined(HAS_MOVE_SEMANTICS) && HAS_MOVE_SEMANTICS == 1)
-		explicit Serializable(Serializable&& _ref)
-		{
-			assert(false);
-		}
+		Serializable(Serializable&& obj);
 #endif
 
-	private:
-		Serializable(const Serializable &obj) {
-			assert(false);
-		}
-
 	public:
 		Serializable(const char *name, int64_t serialVersionUID);
 		virtual ~Serializable();
 
-		Serializable& operator=(const Serializable& obj) {
-			assert(this->m_name == obj.m_name);
-			assert(this->m_serialVersionUID == obj.m_serialVersionUID);
-			std::vector<uint8_t> payload;
-			obj.serialize(payload);
-			this->deserialize(payload);
+		// Member-wise copy, see serializableCopyFrom(). In the implicit assignment
+		// of a subclass the member wrappers then assign themselves again, which is
+		// why a move through this operator copies: the values must still be there
+		// when each member is moved.
+		Serializable& operator=(const Serializable& obj) JSRPC_THROWS(UnavailableTypeException) {
+			serializableCopyFrom(obj);
+			return *this;
+		}
+#if (__cplusplus >= 201103) || (__cplusplus == 199711) || (defined(HAS_MOVE_SEMANTICS) && HAS_MOVE_SEMANTICS == 1)
+		Serializable& operator=(Serializable&& obj) JSRPC_THROWS(UnavailableTypeException) {
+			serializableCopyFrom(obj);
 			return *this;
 		}
+#endif
 
-		const std::list<internal::STypeCommon*> &serializableMembers() const { return m_members; }
+		// Allocate from the current thread's SerializableArena, if any
+		static void *operator new(size_t size);
+		static void operator delete(void *ptr);
 
-		void serialize(std::vector<unsigned char>& payload) const throw(UnavailableTypeException);
-		void deserialize(const std::vector<unsigned char>& payload) throw (ParseException);
+		const std::list<internal::STypeCommon*> &serializableMembers() const { return m_members; }
+		// Looks a member up by name through a hash table shared by all instances of the class
+		internal::STypeCommon *serializableFindMember(const char *name, size_t length) const;
+
+		// serialize() only reads this object and its members, so any number of threads
+		// may encode the same object at once as long as none of them mutates it.
+		void serialize(std::vector<unsigned char>& payload) const JSRPC_THROWS(UnavailableTypeException);
+		void serializeAppend(std::vector<unsigned char>& payload) const JSRPC_THROWS(UnavailableTypeException);
+		void serialize(std::vector<unsigned char>& payload, const SerializeOptions &options) const JSRPC_THROWS(UnavailableTypeException);
+		void serializeAppend(std::vector<unsigned char>& payload, const SerializeOptions &options) const JSRPC_THROWS(UnavailableTypeException);
+		SerializedPayload freeze() const JSRPC_THROWS(UnavailableTypeException);
+		void deserialize(const std::vector<unsigned char>& payload) JSRPC_THROWS(ParseException);
+		void deserialize(const unsigned char *payload, size_t size) JSRPC_THROWS(ParseException);
+		// Nested objects created while decoding are allocated from arena
+		void deserialize(const std::vector<unsigned char>& payload, SerializableArena &arena) JSRPC_THROWS(ParseException);
+		void deserialize(const std::vector<unsigned char>& payload, const DeserializeOptions &options) JSRPC_THROWS(ParseException);
+		void deserialize(const unsigned char *payload, size_t size, const DeserializeOptions &options) JSRPC_THROWS(ParseException);
 
 		void serializableClearObjects();
 
-		std::string serializableGetName() {
+		// Member-wise copy/move between two objects of the same class,
+		// without going through the codec.
+		void serializableCopyFrom(const Serializable &src) JSRPC_THROWS(UnavailableTypeException);
+		void serializableMoveFrom(Serializable &src) JSRPC_THROWS(UnavailableTypeException);
+
+		// When enabled, the last encoded bytes are kept and reused until a member is
+		// written through set()/operator*/operator=/setNull() or the object is
+		// deserialized. Objects holding SRefType or SmartPointer members are never
+		// cached, since their values can change without going through the wrapper.
+		// The cache is invalidated when operator* or operator[] hands out a
+		// reference, not when it is written through: a reference kept across
+		// serialize() must be followed by serializableInvalidateCache().
+		void serializableSetCacheEnabled(bool enabled);
+		void serializableInvalidateCache();
+
+		const std::string &serializableGetName() const {
 			return m_name;
 		}
-		int64_t serializableGetSerialVersionUID() {
+		int64_t serializableGetSerialVersionUID() const {
 			return m_serialVersionUID;
 		}
 
+		// Reads the class name and serialVersionUID from the front of an encoded
+		// payload without decoding it. name points into payload. Returns false if
+		// the bytes do not start with a valid header.
+		static bool serializablePeekHeader(const unsigned char *payload, size_t size, const char **name, size_t *nameLength, int64_t *serialVersionUID, size_t *headerSize);
+		// Rewrites a payload that uses header flags (e.g. compression) into plain
+		// form. Returns false, leaving plain untouched, if it already is plain.
+		static bool serializableExpand(const unsigned char *payload, size_t size, std::vector<unsigned char> &plain) JSRPC_THROWS(ParseException);
+
+#if defined(HAS_JSCPPUTILS) && HAS_JSCPPUTILS
+		// Creates the class named in the payload header through
+		// SerializableTypeRegistry and decodes into it.
+		static JsCPPUtils::SmartPointer<Serializable> decodeAny(const unsigned char *payload, size_t size) JSRPC_THROWS(ParseException, UnavailableTypeException);
+		static JsCPPUtils::SmartPointer<Serializable> decodeAny(const std::vector<unsigned char>& payload) JSRPC_THROWS(ParseException, UnavailableTypeException) {
+			return decodeAny(payload.empty() ? NULL : &payload[0], payload.size());
+		}
+#endif
+
 	protected:
 		internal::STypeCommon &serializableMapMember(const char *name, internal::STypeCommon &object);
+		// Maps a member copied in a copy/move constructor under the name it was
+		// copied with
+		internal::STypeCommon &serializableRebindMember(internal::STypeCommon &object);
 
 	private:
-		bool checkFlagsAll(int value, int type) const
+		void encodeAppend(std::vector<unsigned char>& payload) const;
+		void encodeHeader(std::vector<unsigned char>& payload) const;
+		bool cacheLookup(SerializedPayload &cached) const;
+
+		static void encodeMember(std::vector<unsigned char>& payload, const internal::STypeCommon *member);
+		static void decodeMember(const PayloadView& payload, uint32_t *pos, internal::STypeCommon *member);
+#if defined(HAS_JSCPPUTILS) && HAS_JSCPPUTILS
+		static void encodeColumns(std::vector<unsigned char>& payload, const std::list< JsCPPUtils::SmartPointer<Serializable> > &list);
+		static void decodeColumns(const PayloadView& payload, uint32_t *pos, std::list< JsCPPUtils::SmartPointer<Serializable> > &list, SerializableCreateFactory *createFactory);
+#endif
+	};
+
+	template<class T>
+	class SerializableTypeFactory : public SerializableCreateFactory
+	{
+	public:
+		Serializable *create() override {
+			return new T();
+		}
+	};
+
+	// Process-wide class name/serialVersionUID -> factory map, used by
+	// Serializable::decodeAny() and for nested SmartPointer members that have no
+	// create factory of their own.
+	// find() takes no lock; registration adds to an append-only table under a
+	// mutex (see internal::AppendOnlyTable) and never copies or replaces it.
+	class SerializableTypeRegistry
+	{
+	public:
+		// Returns false if the name/UID pair is already registered
+		static bool registerType(const char *name, int64_t serialVersionUID, SerializableCreateFactory *factory);
+		template<class T>
+		static bool registerType()
 		{
-			return (value & type) == type;
+			static SerializableTypeFactory<T> factory;
+			T prototype;
+			return registerType(prototype.serializableGetName().c_str(), prototype.serializableGetSerialVersionUID(), &factory);
 		}
+
+		// Returns NULL if the type is not registered
+		static SerializableCreateFactory *find(const char *name, size_t length, int64_t serialVersionUID);
 	};
+
+	inline void internal::STypeCommon::invalidate() {
+		if (_owner)
+			_owner->serializableInvalidateCache();
+	}
+
+	namespace internal {
+		template <typename T>
+		inline JsCPPUtils::SmartPointer<T> cloneSmartPointer(const JsCPPUtils::SmartPointer<T> &src, SerializableCreateFactory *factory)
+		{
+			Serializable *obj;
+			T *typed;
+			if (!src.getPtr())
+				return JsCPPUtils::SmartPointer<T>();
+			obj = cloneSerializable(*src.getPtr(), factory);
+			typed = dynamic_cast<T*>(obj);
+			if (!typed)
+			{
+				delete obj;
+				throw Serializable::UnavailableTypeException();
+			}
+			return JsCPPUtils::SmartPointer<T>(typed);
+		}
+
+		// List elements are deep-copied like a serialize/deserialize round trip
+		// would, see cloneSerializable()
+		inline void copySerializableList(std::list< JsCPPUtils::SmartPointer<Serializable> > &dest, const std::list< JsCPPUtils::SmartPointer<Serializable> > &src, SerializableCreateFactory *createFactory)
+		{
+			std::list< JsCPPUtils::SmartPointer<Serializable> > copied;
+			for (std::list< JsCPPUtils::SmartPointer<Serializable> >::const_iterator iter = src.begin(); iter != src.end(); iter++)
+				copied.push_back(cloneSmartPointer(*iter, createFactory));
+			dest.swap(copied);
+		}
+	}
+
+	inline SType< std::list< JsCPPUtils::SmartPointer<Serializable> > >::SType(const SType< std::list< JsCPPUtils::SmartPointer<Serializable> > >& obj) :
+		STypeBase(obj) {
+		internal::copySerializableList(_value, obj._value, _memberInfo.createFactory);
+	}
+	inline void SType< std::list< JsCPPUtils::SmartPointer<Serializable> > >::copyValueFrom(const internal::STypeCommon &other) {
+		internal::copySerializableList(_value, *(const std::list< JsCPPUtils::SmartPointer<Serializable> >*)other._memberInfo.ptr, _memberInfo.createFactory);
+	}
+	inline void SRefType< std::list< JsCPPUtils::SmartPointer<Serializable> > >::copyValueFrom(const internal::STypeCommon &other) {
+		internal::copySerializableList(_value, *(const std::list< JsCPPUtils::SmartPointer<Serializable> >*)other._memberInfo.ptr, _memberInfo.createFactory);
+	}
 }
@@ -0,0 +1,629 @@
+/*
+* Licensed to the Apache Software Foundation (ASF) under one or more
+* contributor license agreements.  See the NOTICE file distributed with
+* this work for additional information regarding copyright ownership.
+* The ASF licenses this file to You under the Apache License, Version 2.0
+* (the "License"); you may not use this file except in compliance with
+* the License.  You may obtain a copy of the License at
+*
+*    http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+/**
+ * @file	SerializableLog.cpp
+ * @author	Jichan (development@jc-lab.net / http://ablog.jc-lab.net/ )
+ * @date	2026/10/18
+ * @copyright Copyright (C) 2026 jichan.\n
+ *            This software may be modified and distributed under the terms
+ *            of the Apache License 2.0.  See the LICENSE file for details.
+ */
+
+#include "SerializableLog.h"
+#include "Crc32c.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <atomic>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace JsRPC {
+
+	namespace internal {
+
+		// Whole-file mapping that can be grown (writable) or refreshed (read-only)
+		class MappedFile
+		{
+		public:
+			unsigned char *data;
+			uint64_t size;
+
+		private:
+			bool m_writable;
+#if defined(_WIN32)
+			HANDLE m_file;
+			HANDLE m_mapping;
+#else
+			int m_fd;
+#endif
+
+		public:
+			MappedFile() :
+				data(NULL), size(0), m_writable(false)
+#if defined(_WIN32)
+				, m_file(INVALID_HANDLE_VALUE), m_mapping(NULL)
+#else
+				, m_fd(-1)
+#endif
+			{ }
+			~MappedFile() {
+				close();
+			}
+
+#if defined(_WIN32)
+			bool open(const char *path, bool writable)
+			{
+				m_writable = writable;
+				m_file = ::CreateFileA(path, writable ? (GENERIC_READ | GENERIC_WRITE) : GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, writable ? OPEN_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+				if (m_file == INVALID_HANDLE_VALUE)
+					return false;
+				return map(0);
+			}
+
+			bool map(uint64_t newSize)
+			{
+				LARGE_INTEGER fileSize;
+				unmap();
+				if (!::GetFileSizeEx(m_file, &fileSize))
+					return false;
+				if (newSize < (uint64_t)fileSize.QuadPart)
+					newSize = (uint64_t)fileSize.QuadPart;
+				if (newSize == 0)
+					return true;
+				// A writable mapping larger than the file extends the file
+				m_mapping = ::CreateFileMappingA(m_file, NULL, m_writable ? PAGE_READWRITE : PAGE_READONLY, (DWORD)(newSize >> 32), (DWORD)newSize, NULL);
+				if (!m_mapping)
+					return false;
+				data = (unsigned char*)::MapViewOfFile(m_mapping, m_writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, (SIZE_T)newSize);
+				if (!data)
+					return false;
+				size = newSize;
+				return true;
+			}
+
+			void unmap()
+			{
+				if (data)
+					::UnmapViewOfFile(data);
+				if (m_mapping)
+					::CloseHandle(m_mapping);
+				data = NULL;
+				m_mapping = NULL;
+				size = 0;
+			}
+
+			bool flush(uint64_t offset, uint64_t length)
+			{
+				if (!data || !length)
+					return true;
+				return ::FlushViewOfFile(data + offset, (SIZE_T)length) && ::FlushFileBuffers(m_file);
+			}
+
+			void close()
+			{
+				unmap();
+				if (m_file != INVALID_HANDLE_VALUE)
+					::CloseHandle(m_file);
+				m_file = INVALID_HANDLE_VALUE;
+			}
+#else
+			bool open(const char *path, bool writable)
+			{
+				m_writable = writable;
+				m_fd = ::open(path, writable ? (O_RDWR | O_CREAT) : O_RDONLY, 0644);
+				if (m_fd < 0)
+					return false;
+				return map(0);
+			}
+
+			bool map(uint64_t newSize)
+			{
+				struct stat st;
+				unmap();
+				if (::fstat(m_fd, &st) != 0)
+					return false;
+				if (newSize > (uint64_t)st.st_size)
+				{
+					if (::ftruncate(m_fd, (off_t)newSize) != 0)
+						return false;
+				}
+				else
+				{
+					newSize = (uint64_t)st.st_size;
+				}
+				if (newSize == 0)
+					return true;
+				void *address = ::mmap(NULL, (size_t)newSize, m_writable ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_SHARED, m_fd, 0);
+				if (address == MAP_FAILED)
+					return false;
+				data = (unsigned char*)address;
+				size = newSize;
+				return true;
+			}
+
+			void unmap()
+			{
+				if (data)
+					::munmap(data, (size_t)size);
+				data = NULL;
+				size = 0;
+			}
+
+			bool flush(uint64_t offset, uint64_t length)
+			{
+				uint64_t pageMask = (uint64_t)::sysconf(_SC_PAGESIZE) - 1;
+				uint64_t start = offset & ~pageMask;
+				if (!data || !length)
+					return true;
+				return ::msync(data + start, (size_t)(offset + length - start), MS_SYNC) == 0;
+			}
+
+			void close()
+			{
+				unmap();
+				if (m_fd >= 0)
+					::close(m_fd);
+				m_fd = -1;
+			}
+#endif
+		};
+
+		static const unsigned char logHeader[] = { 'J', 'L', 'O', 'G', 0x02, 0x00, 0x00, 0x00 };
+		static const uint64_t LOG_HEADER_SIZE = 16;
+		// u32 length, u32 CRC-32C
+		static const uint64_t LOG_RECORD_HEADER_SIZE = 8;
+		// Index spacing used when a reader extends the index past the .idx file
+		static const uint32_t LOG_READER_INDEX_INTERVAL = 1024;
+
+		static inline uint32_t readLogU32(const unsigned char *p)
+		{
+			return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+		}
+
+		static inline uint64_t readLogU64(const unsigned char *p)
+		{
+			return (uint64_t)readLogU32(p) | ((uint64_t)readLogU32(p + 4) << 32);
+		}
+
+		static inline void writeLogU32(unsigned char *p, uint32_t value)
+		{
+			for (int i = 0; i < 4; i++)
+				p[i] = (unsigned char)(value >> (i * 8));
+		}
+
+		static inline void writeLogU64(unsigned char *p, uint64_t value)
+		{
+			writeLogU32(p, (uint32_t)value);
+			writeLogU32(p + 4, (uint32_t)(value >> 32));
+		}
+
+		// Bytes the record takes up, padding included. Records start on 8 byte
+		// boundaries so the length word can be accessed atomically.
+		static inline uint64_t logRecordSize(uint32_t length)
+		{
+			return (LOG_RECORD_HEADER_SIZE + (uint64_t)length + 7) & ~(uint64_t)7;
+		}
+
+		// The length word is stored last with release ordering and loaded with
+		// acquire ordering, so a reader in another thread or process that sees
+		// the length also sees the payload and CRC written before it
+		static inline void publishLogLength(unsigned char *p, uint32_t length)
+		{
+			uint32_t raw;
+			writeLogU32((unsigned char*)&raw, length);
+			((std::atomic<uint32_t>*)p)->store(raw, std::memory_order_release);
+		}
+
+		static inline uint32_t loadLogLength(const unsigned char *p)
+		{
+			uint32_t raw = ((const std::atomic<uint32_t>*)p)->load(std::memory_order_acquire);
+			return readLogU32((const unsigned char*)&raw);
+		}
+
+		// Length of the record at offset, 0 at the end of the log or at a record
+		// whose CRC does not match its payload (a write torn by a crash)
+		static inline uint32_t logRecordAt(const MappedFile *file, uint64_t offset)
+		{
+			uint32_t length;
+			if (offset + LOG_RECORD_HEADER_SIZE > file->size)
+				return 0;
+			length = loadLogLength(file->data + offset);
+			if (length > file->size - offset - LOG_RECORD_HEADER_SIZE)
+				return 0;
+			if (Crc32c::compute(file->data + offset + LOG_RECORD_HEADER_SIZE, length) != readLogU32(file->data + offset + 4))
+				return 0;
+			return length;
+		}
+
+		// Zeroes whatever follows the last good record at offset, following the
+		// stale length words, so later appends never line up with old bytes.
+		// Returns the end of the cleared range.
+		static uint64_t clearLogTail(MappedFile *file, uint64_t offset)
+		{
+			uint64_t end = offset;
+			uint32_t length;
+			while ((end + LOG_RECORD_HEADER_SIZE <= file->size) && ((length = readLogU32(file->data + end)) != 0))
+			{
+				if (length > file->size - end - LOG_RECORD_HEADER_SIZE)
+				{
+					end = file->size;
+					break;
+				}
+				end += logRecordSize(length);
+			}
+			if (end > file->size)
+				end = file->size;
+			memset(file->data + offset, 0, (size_t)(end - offset));
+			return end;
+		}
+
+		static bool checkLogHeader(const MappedFile *file)
+		{
+			return (file->size >= LOG_HEADER_SIZE) && !memcmp(file->data, logHeader, sizeof(logHeader));
+		}
+
+		// Keeps the entries of the .idx file that still point at records of this log
+		static void loadLogIndex(const std::string &path, const MappedFile *file, std::vector<LogIndexEntry> &index)
+		{
+			unsigned char raw[16];
+			FILE *fp = fopen(path.c_str(), "rb");
+			index.clear();
+			if (!fp)
+				return;
+			while (fread(raw, 1, sizeof(raw), fp) == sizeof(raw))
+			{
+				LogIndexEntry entry;
+				entry.record = readLogU64(raw);
+				entry.offset = readLogU64(raw + 8);
+				if (entry.offset < LOG_HEADER_SIZE || !logRecordAt(file, entry.offset))
+					break;
+				if (!index.empty() && ((entry.record <= index.back().record) || (entry.offset <= index.back().offset)))
+					break;
+				index.push_back(entry);
+			}
+			fclose(fp);
+		}
+
+		// Walks records from offset/records to the end of the log, adding an index
+		// entry every interval records
+		static void scanLog(const MappedFile *file, uint64_t &offset, uint64_t &records, uint32_t interval, std::vector<LogIndexEntry> &index)
+		{
+			uint32_t length;
+			while ((length = logRecordAt(file, offset)) != 0)
+			{
+				if (((records % interval) == 0) && (index.empty() || (index.back().record < records)))
+				{
+					LogIndexEntry entry;
+					entry.record = records;
+					entry.offset = offset;
+					index.push_back(entry);
+				}
+				offset += logRecordSize(length);
+				records++;
+			}
+		}
+
+		static bool writeLogIndex(const std::string &path, const std::vector<LogIndexEntry> &entries, bool append)
+		{
+			unsigned char raw[16];
+			bool ok = true;
+			FILE *fp = fopen(path.c_str(), append ? "ab" : "wb");
+			if (!fp)
+				return false;
+			for (std::vector<LogIndexEntry>::const_iterator iter = entries.begin(); ok && (iter != entries.end()); iter++)
+			{
+				writeLogU64(raw, iter->record);
+				writeLogU64(raw + 8, iter->offset);
+				ok = fwrite(raw, 1, sizeof(raw), fp) == sizeof(raw);
+			}
+			if (fflush(fp) != 0)
+				ok = false;
+			fclose(fp);
+			return ok;
+		}
+	}
+
+	SerializableLogWriter::SerializableLogWriter(size_t growSize, size_t syncInterval, uint32_t indexInterval) :
+		m_file(NULL),
+		m_growSize(growSize ? growSize : 1),
+		m_syncInterval(syncInterval),
+		m_indexInterval(indexInterval ? indexInterval : 1),
+		m_end(0), m_records(0), m_syncedEnd(0)
+	{
+	}
+
+	SerializableLogWriter::~SerializableLogWriter()
+	{
+		close();
+	}
+
+	void SerializableLogWriter::open(const char *path) JSRPC_THROWS(IOException)
+	{
+		std::vector<internal::LogIndexEntry> index;
+
+		close();
+		m_file = new internal::MappedFile();
+		if (!m_file->open(path, true))
+		{
+			close();
+			throw IOException();
+		}
+		m_indexPath = std::string(path) + ".idx";
+
+		if (m_file->size == 0)
+		{
+			if (!m_file->map(m_growSize > internal::LOG_HEADER_SIZE ? m_growSize : internal::LOG_HEADER_SIZE))
+			{
+				close();
+				throw IOException();
+			}
+			memset(m_file->data, 0, (size_t)internal::LOG_HEADER_SIZE);
+			memcpy(m_file->data, internal::logHeader, sizeof(internal::logHeader));
+			m_end = internal::LOG_HEADER_SIZE;
+			m_records = 0;
+		}
+		else
+		{
+			if (!internal::checkLogHeader(m_file))
+			{
+				close();
+				throw IOException();
+			}
+			internal::loadLogIndex(m_indexPath, m_file, index);
+			if (index.empty())
+			{
+				m_end = internal::LOG_HEADER_SIZE;
+				m_records = 0;
+			}
+			else
+			{
+				m_end = index.back().offset;
+				m_records = index.back().record;
+			}
+			internal::scanLog(m_file, m_end, m_records, m_indexInterval, index);
+
+			// Recovery: the scan stopped at the end or at a torn record
+			uint64_t cleared = internal::clearLogTail(m_file, m_end);
+			if (!m_file->flush(m_end, cleared - m_end))
+			{
+				close();
+				throw IOException();
+			}
+		}
+
+		// The index may have been missing or stale; start it over from what is on disk
+		if (!internal::writeLogIndex(m_indexPath, index, false))
+		{
+			close();
+			throw IOException();
+		}
+		m_pendingIndex.clear();
+		m_syncedEnd = m_end;
+	}
+
+	void SerializableLogWriter::close()
+	{
+		if (!m_file)
+			return;
+		try {
+			sync();
+		} catch (IOException&) {
+		}
+		m_file->close();
+		delete m_file;
+		m_file = NULL;
+	}
+
+	uint64_t SerializableLogWriter::append(const Serializable &message) JSRPC_THROWS(Serializable::UnavailableTypeException, IOException)
+	{
+		message.serialize(m_buffer);
+		return append(m_buffer.empty() ? NULL : &m_buffer[0], m_buffer.size());
+	}
+
+	uint64_t SerializableLogWriter::append(const unsigned char *payload, size_t size) JSRPC_THROWS(IOException)
+	{
+		uint64_t record;
+		uint64_t need;
+		uint32_t crc;
+
+		// A zero length would read as the end of the log
+		if (!m_file || (size == 0) || ((uint64_t)size > 0xFFFFFFFFULL))
+			throw IOException();
+
+		need = internal::logRecordSize((uint32_t)size);
+		if (m_end + need > m_file->size)
+		{
+			uint64_t newSize = m_file->size + m_growSize;
+			if (newSize < m_end + need)
+				newSize = m_end + need;
+			if (!m_file->map(newSize))
+				throw IOException();
+		}
+
+		// Payload and CRC first, length last: a record is only visible once complete
+		crc = internal::Crc32c::compute(payload, size);
+		memcpy(m_file->data + m_end + internal::LOG_RECORD_HEADER_SIZE, payload, size);
+		memset(m_file->data + m_end + internal::LOG_RECORD_HEADER_SIZE + size, 0, (size_t)(need - internal::LOG_RECORD_HEADER_SIZE - size));
+		internal::writeLogU32(m_file->data + m_end + 4, crc);
+		internal::publishLogLength(m_file->data + m_end, (uint32_t)size);
+
+		record = m_records;
+		if ((record % m_indexInterval) == 0)
+		{
+			internal::LogIndexEntry entry;
+			entry.record = record;
+			entry.offset = m_end;
+			m_pendingIndex.push_back(entry);
+		}
+		m_end += need;
+		m_records++;
+
+		if (m_syncInterval && (m_end - m_syncedEnd >= m_syncInterval))
+			sync();
+		return record;
+	}
+
+	void SerializableLogWriter::sync() JSRPC_THROWS(IOException)
+	{
+		if (!m_file)
+			return;
+		if (!m_file->flush(m_syncedEnd, m_end - m_syncedEnd))
+			throw IOException();
+		m_syncedEnd = m_end;
+		if (!m_pendingIndex.empty())
+		{
+			if (!internal::writeLogIndex(m_indexPath, m_pendingIndex, true))
+				throw IOException();
+			m_pendingIndex.clear();
+		}
+	}
+
+	SerializableLogReader::SerializableLogReader() :
+		m_file(NULL),
+		m_scannedOffset(0), m_scannedRecords(0),
+		m_offset(0), m_record(0)
+	{
+	}
+
+	SerializableLogReader::~SerializableLogReader()
+	{
+		close();
+	}
+
+	void SerializableLogReader::open(const char *path) JSRPC_THROWS(IOException)
+	{
+		close();
+		m_file = new internal::MappedFile();
+		if (!m_file->open(path, false) || !internal::checkLogHeader(m_file))
+		{
+			close();
+			throw IOException();
+		}
+		m_path = path;
+
+		internal::loadLogIndex(m_path + ".idx", m_file, m_index);
+		if (m_index.empty())
+		{
+			m_scannedOffset = internal::LOG_HEADER_SIZE;
+			m_scannedRecords = 0;
+		}
+		else
+		{
+			m_scannedOffset = m_index.back().offset;
+			m_scannedRecords = m_index.back().record;
+		}
+		scanIndex();
+
+		m_offset = internal::LOG_HEADER_SIZE;
+		m_record = 0;
+	}
+
+	void SerializableLogReader::close()
+	{
+		if (!m_file)
+			return;
+		m_file->close();
+		delete m_file;
+		m_file = NULL;
+		m_index.clear();
+	}
+
+	void SerializableLogReader::refresh() JSRPC_THROWS(IOException)
+	{
+		if (!m_file || !m_file->map(0))
+			throw IOException();
+		scanIndex();
+	}
+
+	void SerializableLogReader::scanIndex()
+	{
+		internal::scanLog(m_file, m_scannedOffset, m_scannedRecords, internal::LOG_READER_INDEX_INTERVAL, m_index);
+	}
+
+	bool SerializableLogReader::next(const unsigned char **payload, size_t *size)
+	{
+		uint32_t length;
+		if (!m_file)
+			return false;
+		length = internal::logRecordAt(m_file, m_offset);
+		if (!length)
+			return false;
+		*payload = m_file->data + m_offset + internal::LOG_RECORD_HEADER_SIZE;
+		*size = length;
+		m_offset += internal::logRecordSize(length);
+		m_record++;
+		return true;
+	}
+
+	bool SerializableLogReader::next(Serializable &message) JSRPC_THROWS(Serializable::ParseException)
+	{
+		const unsigned char *payload;
+		size_t size;
+		if (!next(&payload, &size))
+			return false;
+		message.deserialize(payload, size);
+		return true;
+	}
+
+	bool SerializableLogReader::seek(uint64_t record)
+	{
+		const unsigned char *payload;
+		size_t size;
+		size_t low = 0;
+		size_t high = m_index.size();
+
+		if (!m_file)
+			return false;
+
+		// Last index entry at or before record
+		while (low < high)
+		{
+			size_t mid = (low + high) / 2;
+			if (m_index[mid].record <= record)
+				low = mid + 1;
+			else
+				high = mid;
+		}
+		if (low == 0)
+		{
+			m_offset = internal::LOG_HEADER_SIZE;
+			m_record = 0;
+		}
+		else
+		{
+			m_offset = m_index[low - 1].offset;
+			m_record = m_index[low - 1].record;
+		}
+
+		while (m_record < record)
+		{
+			if (!next(&payload, &size))
+				return false;
+		}
+		return internal::logRecordAt(m_file, m_offset) != 0;
+	}
+
+}
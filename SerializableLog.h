@@ -0,0 +1,149 @@
+/*
+* Licensed to the Apache Software Foundation (ASF) under one or more
+* contributor license agreements.  See the NOTICE file distributed with
+* this work for additional information regarding copyright ownership.
+* The ASF licenses this file to You under the Apache License, Version 2.0
+* (the "License"); you may not use this file except in compliance with
+* the License.  You may obtain a copy of the License at
+*
+*    http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+/**
+ * @file	SerializableLog.h
+ * @author	Jichan (development@jc-lab.net / http://ablog.jc-lab.net/ )
+ * @date	2026/10/18
+ * @copyright Copyright (C) 2026 jichan.\n
+ *            This software may be modified and distributed under the terms
+ *            of the Apache License 2.0.  See the LICENSE file for details.
+ */
+
+#pragma once
+
+#include "Serializable.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+namespace JsRPC {
+
+	// Append-only log of encoded Serializable payloads in a memory-mapped file.
+	//   file:   'J' 'L' 'O' 'G', u32 version, u64 reserved
+	//   record: u32 length (little endian, never 0), u32 CRC-32C of the payload,
+	//           payload, zero padding to a multiple of 8 bytes
+	// The file is grown in large steps and the unused tail is zero, so a zero
+	// length marks the end. The length is published last; a record whose CRC
+	// does not match was torn by a crash and ends the log, and the writer
+	// clears it when it reopens the log. A sparse index of (record number, offset) pairs is
+	// kept next to the log in "<path>.idx" and rebuilt from the log if missing.
+
+	namespace internal {
+		class MappedFile;
+
+		struct LogIndexEntry {
+			uint64_t record;
+			uint64_t offset;
+		};
+	}
+
+	class SerializableLogWriter
+	{
+	public:
+		class IOException : public std::exception
+		{ };
+
+	private:
+		internal::MappedFile *m_file;
+		std::string m_indexPath;
+		size_t m_growSize;
+		size_t m_syncInterval;
+		uint32_t m_indexInterval;
+
+		uint64_t m_end;
+		uint64_t m_records;
+		uint64_t m_syncedEnd;
+		std::vector<internal::LogIndexEntry> m_pendingIndex;
+		std::vector<unsigned char> m_buffer;
+
+		SerializableLogWriter(const SerializableLogWriter &obj);
+		SerializableLogWriter& operator=(const SerializableLogWriter &obj);
+
+	public:
+		// syncInterval: bytes appended between automatic sync points (0 = only on sync()/close())
+		// indexInterval: records between sparse index entries
+		SerializableLogWriter(size_t growSize = 64 * 1024 * 1024, size_t syncInterval = 4 * 1024 * 1024, uint32_t indexInterval = 1024);
+		~SerializableLogWriter();
+
+		// Creates the log, or continues after the last record of an existing one
+		void open(const char *path) JSRPC_THROWS(IOException);
+		// Syncs the log. The zero tail is left in place: a reader that mapped it
+		// would fault if the file shrank under it.
+		void close();
+
+		// Returns the record number
+		uint64_t append(const Serializable &message) JSRPC_THROWS(Serializable::UnavailableTypeException, IOException);
+		uint64_t append(const unsigned char *payload, size_t size) JSRPC_THROWS(IOException);
+
+		// Flushes the records written so far and the sparse index to disk
+		void sync() JSRPC_THROWS(IOException);
+
+		uint64_t recordCount() const {
+			return m_records;
+		}
+	};
+
+	// Reads records in place from a read-only mapping of the log. Payload
+	// pointers stay valid until the next refresh() or close().
+	class SerializableLogReader
+	{
+	public:
+		class IOException : public std::exception
+		{ };
+
+	private:
+		internal::MappedFile *m_file;
+		std::string m_path;
+		std::vector<internal::LogIndexEntry> m_index;
+		// Offset/record just past the last record the index covers
+		uint64_t m_scannedOffset;
+		uint64_t m_scannedRecords;
+
+		uint64_t m_offset;
+		uint64_t m_record;
+
+		SerializableLogReader(const SerializableLogReader &obj);
+		SerializableLogReader& operator=(const SerializableLogReader &obj);
+
+	public:
+		SerializableLogReader();
+		~SerializableLogReader();
+
+		void open(const char *path) JSRPC_THROWS(IOException);
+		void close();
+		// Remaps the file to pick up records appended since open()
+		void refresh() JSRPC_THROWS(IOException);
+
+		// Returns false at the end of the log
+		bool next(const unsigned char **payload, size_t *size);
+		bool next(Serializable &message) JSRPC_THROWS(Serializable::ParseException);
+
+		// Positions the reader on record number record. Returns false (and moves
+		// to the end) if the log has fewer records.
+		bool seek(uint64_t record);
+		uint64_t position() const {
+			return m_record;
+		}
+
+	private:
+		void scanIndex();
+	};
+
+}
@@ -0,0 +1,367 @@
+/*
+* Licensed to the Apache Software Foundation (ASF) under one or more
+* contributor license agreements.  See the NOTICE file distributed with
+* this work for additional information regarding copyright ownership.
+* The ASF licenses this file to You under the Apache License, Version 2.0
+* (the "License"); you may not use this file except in compliance with
+* the License.  You may obtain a copy of the License at
+*
+*    http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+/**
+ * @file	StringInterner.cpp
+ * @author	Jichan (development@jc-lab.net / http://ablog.jc-lab.net/ )
+ * @date	2026/10/18
+ * @copyright Copyright (C) 2026 jichan.\n
+ *            This software may be modified and distributed under the terms
+ *            of the Apache License 2.0.  See the LICENSE file for details.
+ */
+
+#include "StringInterner.h"
+#include "Crc32c.h"
+
+#include <string.h>
+
+#include <unordered_map>
+
+namespace JsRPC {
+	namespace internal {
+
+		typedef SerializableMemberInfo::EncapType EncapType;
+
+		struct InternedString {
+			const unsigned char *data;
+			uint32_t length;
+
+			bool operator==(const InternedString &other) const {
+				return (length == other.length) && !memcmp(data, other.data, length);
+			}
+		};
+
+		struct InternedStringHash {
+			size_t operator()(const InternedString &key) const {
+				return MemberNameTable::hash((const char*)key.data, key.length);
+			}
+		};
+
+		// Walks encoded member data the way the JSON transcoder does and copies it
+		// to out, rewriting char strings and the sizes of nested objects.
+		class InternWalker
+		{
+		private:
+			bool m_expand;
+			const unsigned char *m_data;
+			size_t m_end;
+			size_t m_pos;
+			std::vector<unsigned char> &m_out;
+
+			std::unordered_map<InternedString, uint32_t, InternedStringHash> m_index;
+			std::vector<InternedString> m_table;
+			size_t m_references;
+			// Bytes references may still expand to
+			size_t m_expandBudget;
+
+		public:
+			InternWalker(bool expand, const unsigned char *data, size_t size, std::vector<unsigned char> &out) :
+				m_expand(expand), m_data(data), m_end(size), m_pos(0), m_out(out), m_references(0),
+				m_expandBudget(StringInterner::EXPAND_MIN_LIMIT)
+			{
+				if (size > StringInterner::EXPAND_MIN_LIMIT / StringInterner::EXPAND_RATIO)
+					m_expandBudget = (size > (size_t)-1 / StringInterner::EXPAND_RATIO) ? (size_t)-1 : size * StringInterner::EXPAND_RATIO;
+			}
+
+			size_t references() const {
+				return m_references;
+			}
+
+			void members()
+			{
+				while (m_pos < m_end)
+					member();
+			}
+
+		private:
+			const unsigned char *take(size_t length)
+			{
+				const unsigned char *ptr = &m_data[m_pos];
+				if (m_end - m_pos < length)
+					throw Serializable::ParseException();
+				m_pos += length;
+				return ptr;
+			}
+
+			template<typename T>
+			T read()
+			{
+				T value;
+				memcpy(&value, take(sizeof(T)), sizeof(T));
+				return value;
+			}
+
+			void write(const void *data, size_t length)
+			{
+				m_out.insert(m_out.end(), (const unsigned char*)data, (const unsigned char*)data + length);
+			}
+
+			template<typename T>
+			T copy()
+			{
+				T value = read<T>();
+				write(&value, sizeof(T));
+				return value;
+			}
+
+			void copyArray(uint16_t etype)
+			{
+				uint32_t count = copy<uint32_t>();
+				size_t elementSize = nativeElementSize(etype);
+				if (count > (m_end - m_pos) / elementSize)
+					throw Serializable::ParseException();
+				write(take(count * elementSize), count * elementSize);
+			}
+
+			void string(uint16_t etype)
+			{
+				InternedString value;
+				uint32_t length;
+				if ((etype & 0x00FF) != EncapType::ETYPE_CHAR)
+				{
+					copyArray(etype);
+					return;
+				}
+
+				length = read<uint32_t>();
+				if (m_expand && (length & StringInterner::REFERENCE))
+				{
+					uint32_t index = length & ~StringInterner::REFERENCE;
+					if (index >= m_table.size())
+						throw Serializable::ParseException();
+					value = m_table[index];
+					// Each reference costs 4 bytes but may stand for a long string
+					if (value.length > m_expandBudget)
+						throw Serializable::ParseException();
+					m_expandBudget -= value.length;
+					write(&value.length, 4);
+					write(value.data, value.length);
+					return;
+				}
+				if (length & StringInterner::REFERENCE)
+					throw Serializable::ParseException();
+
+				value.data = take(length);
+				value.length = length;
+				if (length > 0)
+				{
+					if (m_expand)
+					{
+						m_table.push_back(value);
+					}
+					else
+					{
+						std::pair<std::unordered_map<InternedString, uint32_t, InternedStringHash>::iterator, bool> result = m_index.insert(std::make_pair(value, (uint32_t)m_index.size()));
+						if (!result.second)
+						{
+							uint32_t reference = StringInterner::REFERENCE | result.first->second;
+							write(&reference, 4);
+							m_references++;
+							return;
+						}
+					}
+				}
+				write(&length, 4);
+				write(value.data, length);
+			}
+
+			void object(size_t size)
+			{
+				size_t headerSize;
+				size_t end = m_end;
+				size_t start = m_out.size();
+				size_t trailer = 0;
+				if ((size > m_end - m_pos) || !Serializable::serializablePeekHeader(&m_data[m_pos], size, NULL, NULL, NULL, &headerSize))
+					throw Serializable::ParseException();
+				// Other flags are only ever set on the outermost object
+				if (m_data[m_pos + 4] & ~Serializable::HEADER_FLAG_CHECKSUM)
+					throw Serializable::ParseException();
+				if (m_data[m_pos + 4])
+				{
+					trailer = 4;
+					if (size - headerSize < trailer)
+						throw Serializable::ParseException();
+				}
+				write(take(headerSize), headerSize);
+
+				m_end = m_pos + size - headerSize - trailer;
+				members();
+				m_end = end;
+
+				if (trailer)
+				{
+					// The member data changed, so the old checksum no longer applies
+					uint32_t crc;
+					take(trailer);
+					crc = Crc32c::compute(&m_out[start], m_out.size() - start);
+					write(&crc, 4);
+				}
+			}
+
+			void nested()
+			{
+				uint32_t size = copy<uint32_t>();
+				size_t sizePos = m_out.size() - 4;
+				if (size == 0)
+					return;
+				object(size);
+				size = (uint32_t)(m_out.size() - sizePos - 4);
+				memcpy(&m_out[sizePos], &size, 4);
+			}
+
+			void columns(uint32_t count)
+			{
+				uint32_t size;
+				size_t sizePos;
+				size_t headerSize;
+				size_t end = m_end;
+				uint32_t i;
+				if (count == 0)
+					return;
+				size = copy<uint32_t>();
+				sizePos = m_out.size() - 4;
+				if ((size > m_end - m_pos) || !Serializable::serializablePeekHeader(&m_data[m_pos], size, NULL, NULL, NULL, &headerSize) || m_data[m_pos + 4])
+					throw Serializable::ParseException();
+				write(take(headerSize), headerSize);
+
+				m_end = m_pos + size - headerSize;
+				while (m_pos < m_end)
+				{
+					unsigned char encoding;
+					uint32_t columnSize;
+					size_t columnSizePos;
+					size_t blockEnd = m_end;
+					copy<uint16_t>();
+					encoding = copy<unsigned char>();
+					columnSize = copy<uint32_t>();
+					columnSizePos = m_out.size() - 4;
+					if (columnSize > m_end - m_pos)
+						throw Serializable::ParseException();
+					if (encoding != COLUMN_ROWS)
+					{
+						write(take(columnSize), columnSize);
+						continue;
+					}
+					m_end = m_pos + columnSize;
+					for (i = 0; i < count; i++)
+						member();
+					if (m_pos != m_end)
+						throw Serializable::ParseException();
+					m_end = blockEnd;
+					columnSize = (uint32_t)(m_out.size() - columnSizePos - 4);
+					memcpy(&m_out[columnSizePos], &columnSize, 4);
+				}
+				m_end = end;
+
+				size = (uint32_t)(m_out.size() - sizePos - 4);
+				memcpy(&m_out[sizePos], &size, 4);
+			}
+
+			void member()
+			{
+				uint16_t etype = copy<uint16_t>();
+				uint16_t elementEtype;
+				uint32_t count;
+				uint32_t i;
+
+				if (etype & EncapType::ETYPE_NULL)
+					return;
+				switch (etype & 0xFF00)
+				{
+				case EncapType::ETYPE_NATIVE:
+					write(take(nativeElementSize(etype)), nativeElementSize(etype));
+					return;
+				case EncapType::ETYPE_NATIVEARRAY:
+					copyArray(etype);
+					return;
+				}
+
+				switch (etype)
+				{
+				case EncapType::ETYPE_STDBASICSTRING:
+					string(copy<uint16_t>());
+					break;
+				case EncapType::ETYPE_STDVECTOR:
+					elementEtype = copy<uint16_t>();
+					if (!(elementEtype & EncapType::ETYPE_NULL))
+						copyArray(elementEtype);
+					break;
+				case EncapType::ETYPE_STDLIST:
+					etype = copy<uint16_t>();
+					elementEtype = copy<uint16_t>();
+					count = copy<uint32_t>();
+					if ((etype == EncapType::ETYPE_SMARTPOINTER) && (elementEtype == EncapType::ETYPE_COLUMNAR))
+					{
+						columns(count);
+						break;
+					}
+					for (i = 0; i < count; i++)
+					{
+						switch (etype)
+						{
+						case EncapType::ETYPE_SMARTPOINTER:
+							if (elementEtype != EncapType::ETYPE_SUBPAYLOAD)
+								throw Serializable::ParseException();
+							nested();
+							break;
+						case EncapType::ETYPE_STDVECTOR:
+							copyArray(elementEtype);
+							break;
+						case EncapType::ETYPE_STDBASICSTRING:
+							string(elementEtype);
+							break;
+						default:
+							throw Serializable::ParseException();
+						}
+					}
+					break;
+				case EncapType::ETYPE_SUBPAYLOAD:
+					nested();
+					break;
+				case EncapType::ETYPE_SMARTPOINTER:
+					elementEtype = copy<uint16_t>();
+					if (elementEtype & EncapType::ETYPE_NULL)
+						break;
+					if (elementEtype != EncapType::ETYPE_SUBPAYLOAD)
+						throw Serializable::ParseException();
+					nested();
+					break;
+				default:
+					throw Serializable::ParseException();
+				}
+			}
+		};
+
+		bool StringInterner::intern(const unsigned char *body, size_t size, std::vector<unsigned char> &out)
+		{
+			try {
+				InternWalker walker(false, body, size, out);
+				walker.members();
+				return walker.references() > 0;
+			} catch (Serializable::ParseException&) {
+				// A string too long to tell apart from a reference; leave it plain
+				return false;
+			}
+		}
+
+		void StringInterner::expand(const unsigned char *body, size_t size, std::vector<unsigned char> &out) JSRPC_THROWS(Serializable::ParseException)
+		{
+			InternWalker walker(true, body, size, out);
+			walker.members();
+		}
+
+	}
+}
@@ -0,0 +1,62 @@
+/*
+* Licensed to the Apache Software Foundation (ASF) under one or more
+* contributor license agreements.  See the NOTICE file distributed with
+* this work for additional information regarding copyright ownership.
+* The ASF licenses this file to You under the Apache License, Version 2.0
+* (the "License"); you may not use this file except in compliance with
+* the License.  You may obtain a copy of the License at
+*
+*    http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+/**
+ * @file	StringInterner.h
+ * @author	Jichan (development@jc-lab.net / http://ablog.jc-lab.net/ )
+ * @date	2026/10/18
+ * @copyright Copyright (C) 2026 jichan.\n
+ *            This software may be modified and distributed under the terms
+ *            of the Apache License 2.0.  See the LICENSE file for details.
+ */
+
+#pragma once
+
+#include "Serializable.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+namespace JsRPC {
+	namespace internal {
+
+		// Rewrites the member data of an encoded object so each repeated char
+		// string is written only once. Every non-empty string written in full is
+		// numbered in encoding order, and a later equal string is written as
+		// REFERENCE | number in place of its length. Nested objects share the
+		// numbering of the outermost object.
+		class StringInterner
+		{
+		public:
+			static const uint32_t REFERENCE = 0x80000000U;
+			// expand() gives up once references have expanded to more than
+			// EXPAND_RATIO bytes per byte of input, or EXPAND_MIN_LIMIT bytes if
+			// that is more
+			static const size_t EXPAND_RATIO = 256;
+			static const size_t EXPAND_MIN_LIMIT = 16 * 1024 * 1024;
+
+			// Appends the interned form of the member data of a plain payload to
+			// out. Returns false (out is then undefined) if no string repeats.
+			static bool intern(const unsigned char *body, size_t size, std::vector<unsigned char> &out);
+			// Appends the plain form of interned member data to out. Throws if the
+			// references expand past the limit above.
+			static void expand(const unsigned char *body, size_t size, std::vector<unsigned char> &out) JSRPC_THROWS(Serializable::ParseException);
+		};
+
+	}
+}
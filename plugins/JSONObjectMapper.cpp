@@ -28,13 +28,32 @@
 #if defined(HAS_RAPIDJSON) && HAS_RAPIDJSON
 #include <rapidjson/stringbuffer.h>
 #include <rapidjson/writer.h>
+#include <rapidjson/reader.h>
+#include <rapidjson/memorystream.h>
+#include <rapidjson/encodedstream.h>
+#include <rapidjson/internal/itoa.h>
+#include <rapidjson/internal/dtoa.h>
 
-#if defined(HAS_JSCPPUTILS) && HAS_JSCPPUTILS
-#include <JsCPPUtils/StringBuffer.h>
-#include <JsCPPUtils/StringEncoding.h>
-#endif
+#include <limits>
+#include <new>
+#include <cmath>
+#include <type_traits>
+#include <typeinfo>
+#include <typeindex>
+
+#include "UTFTranscoder.h"
 
 namespace JsRPC {
+	// UTF-8 text of a wide member, reused across calls on the same thread
+	template<typename CharT>
+	static const std::string &toUTF8(const CharT *data, size_t length)
+	{
+		static thread_local std::string buffer;
+		buffer.clear();
+		internal::UTFTranscoder::appendUTF8(buffer, data, length);
+		return buffer;
+	}
+
 	template<typename T>
 	static T readFromPayload(const rapidjson::Value &jsonValue);
 	template<>
@@ -50,14 +69,9 @@ namespace JsRPC {
 	}
 	template<>
 	static wchar_t readFromPayload<wchar_t>(const rapidjson::Value &jsonValue) {
-#if defined(HAS_JSCPPUTILS) && HAS_JSCPPUTILS
-		std::basic_string<wchar_t> text = JsCPPUtils::StringEncoding::UTF8ToStringW(jsonValue.GetString(), jsonValue.GetStringLength());
-		if (text.length() > 0)
-		{
-			return text.at(0);
-		}
-#endif
-		return 0;
+		if (!jsonValue.IsString())
+			throw JSONObjectMapper::TypeNotMatchException();
+		return internal::UTFTranscoder::firstFromUTF8<wchar_t>(jsonValue.GetString(), jsonValue.GetStringLength());
 	}
 	template<>
 	static int8_t readFromPayload<int8_t>(const rapidjson::Value &jsonValue) {
@@ -131,10 +145,8 @@ namespace JsRPC {
 	}
 	template <typename JsonAllocatorT>
 	static void writeElementToPayload(rapidjson::Value &jsonValue, JsonAllocatorT &jsonAllocator, const wchar_t *data) {
-#if defined(HAS_JSCPPUTILS) && HAS_JSCPPUTILS
-		JsCPPUtils::StringBuffer<char> utf8Text = JsCPPUtils::StringEncoding::StringToUTF8SB(data, 1);
+		const std::string &utf8Text = toUTF8(data, 1);
 		jsonValue.SetString(utf8Text.c_str(), utf8Text.length(), jsonAllocator);
-#endif
 	}
 	template <typename JsonAllocatorT>
 	static void writeElementToPayload(rapidjson::Value &jsonValue, JsonAllocatorT &jsonAllocator, const int8_t *data) {
@@ -179,9 +191,7 @@ namespace JsRPC {
 	template <typename JsonAllocatorT>
 	static void writeElementToPayload(rapidjson::Value &jsonValue, JsonAllocatorT &jsonAllocator, const Serializable *data) {
 		if (data) {
-			rapidjson::Document jsonDoc;
-			JSONObjectMapper::serializeTo(data, jsonDoc);
-			jsonValue.CopyFrom(jsonDoc, jsonAllocator);
+			JSONObjectMapper::serializeToValue(data, jsonValue, jsonAllocator);
 		} else {
 			jsonValue.SetNull();
 		}
@@ -201,6 +211,7 @@ namespace JsRPC {
 	{
 		size_t i;
 		jsonValue.SetArray();
+		jsonValue.Reserve((rapidjson::SizeType)length, jsonAllocator);
 		for (i = 0; i < length; i++) {
 			rapidjson::Value jsonElement;
 			writeElementToPayload(jsonElement, jsonAllocator, &data[i]);
@@ -228,10 +239,8 @@ namespace JsRPC {
 	}
 	template <typename JsonAllocatorT>
 	static void writeElementToPayload(rapidjson::Value &jsonValue, JsonAllocatorT &jsonAllocator, const std::basic_string<wchar_t> *data) {
-#if defined(HAS_JSCPPUTILS) && HAS_JSCPPUTILS
-		JsCPPUtils::StringBuffer<char> sbUtf8Text = JsCPPUtils::StringEncoding::StringToUTF8SB(*data);
-		jsonValue.SetString(sbUtf8Text.c_str(), sbUtf8Text.length(), jsonAllocator);
-#endif
+		const std::string &utf8Text = toUTF8(data->c_str(), data->length());
+		jsonValue.SetString(utf8Text.c_str(), utf8Text.length(), jsonAllocator);
 	}
 	static void readElementFromPayload(const rapidjson::Value &jsonValue, std::basic_string<char> *data)
 	{
@@ -243,13 +252,12 @@ namespace JsRPC {
 	{
 		if (!jsonValue.IsString())
 			throw JSONObjectMapper::TypeNotMatchException();
-#if defined(HAS_JSCPPUTILS) && HAS_JSCPPUTILS
-		*data = JsCPPUtils::StringEncoding::UTF8ToStringW(jsonValue.GetString(), jsonValue.GetStringLength());
-#endif
+		internal::UTFTranscoder::assignFromUTF8(*data, jsonValue.GetString(), jsonValue.GetStringLength());
 	}
 	template <typename T, typename JsonAllocatorT>
 	static void writeStdVectorToPayload(rapidjson::Value &jsonValue, JsonAllocatorT &jsonAllocator, const std::vector<T> *data) {
 		jsonValue.SetArray();
+		jsonValue.Reserve((rapidjson::SizeType)data->size(), jsonAllocator);
 		for (std::vector<T>::const_iterator iter = data->begin(); iter != data->end(); iter++)
 		{
 			rapidjson::Value jsonElement;
@@ -263,6 +271,7 @@ namespace JsRPC {
 		if(!jsonValue.IsArray())
 			throw JSONObjectMapper::TypeNotMatchException();
 		data->clear();
+		data->reserve(jsonValue.Size());
 		for (rapidjson::Value::ConstValueIterator iter = jsonValue.Begin(); iter != jsonValue.End(); iter++)
 		{
 			T value;
@@ -291,8 +300,8 @@ namespace JsRPC {
 		for (std::list< std::basic_string<wchar_t> >::const_iterator iter = data->begin(); iter != data->end(); iter++)
 		{
 			rapidjson::Value jsonElement;
-			JsCPPUtils::StringBuffer<char> sbUtf8Text = JsCPPUtils::StringEncoding::StringToUTF8SB(*iter);
-			jsonElement.SetString(sbUtf8Text.c_str(), sbUtf8Text.length(), jsonAllocator);
+			const std::string &utf8Text = toUTF8(iter->c_str(), iter->length());
+			jsonElement.SetString(utf8Text.c_str(), utf8Text.length(), jsonAllocator);
 			jsonValue.PushBack(jsonElement, jsonAllocator);
 		}
 	}
@@ -303,6 +312,7 @@ namespace JsRPC {
 		for (std::list< std::vector< T > >::const_iterator iter = data->begin(); iter != data->end(); iter++)
 		{
 			rapidjson::Value jsonElement;
+			jsonElement.SetArray();
 			for (std::vector< T >::const_iterator subiter = iter->begin(); subiter != iter->end(); subiter++)
 			{
 				rapidjson::Value jsonSubElement;
@@ -339,6 +349,227 @@ namespace JsRPC {
 		}
 	}
 
+	// Streaming output: tokens are written straight to the writer, no DOM
+	template <typename WriterT>
+	static void writeElementToWriter(WriterT &jsonWriter, const bool *data) {
+		jsonWriter.Bool(*data);
+	}
+	template <typename WriterT>
+	static void writeElementToWriter(WriterT &jsonWriter, const char *data) {
+		jsonWriter.String(data, 1);
+	}
+	template <typename WriterT>
+	static void writeElementToWriter(WriterT &jsonWriter, const wchar_t *data) {
+		const std::string &utf8Text = toUTF8(data, 1);
+		jsonWriter.String(utf8Text.c_str(), utf8Text.length());
+	}
+	template <typename WriterT>
+	static void writeElementToWriter(WriterT &jsonWriter, const int8_t *data) {
+		jsonWriter.Int(*data);
+	}
+	template <typename WriterT>
+	static void writeElementToWriter(WriterT &jsonWriter, const uint8_t *data) {
+		jsonWriter.Uint(*data);
+	}
+	template <typename WriterT>
+	static void writeElementToWriter(WriterT &jsonWriter, const int16_t *data) {
+		jsonWriter.Int(*data);
+	}
+	template <typename WriterT>
+	static void writeElementToWriter(WriterT &jsonWriter, const uint16_t *data) {
+		jsonWriter.Uint(*data);
+	}
+	template <typename WriterT>
+	static void writeElementToWriter(WriterT &jsonWriter, const int32_t *data) {
+		jsonWriter.Int(*data);
+	}
+	template <typename WriterT>
+	static void writeElementToWriter(WriterT &jsonWriter, const uint32_t *data) {
+		jsonWriter.Uint(*data);
+	}
+	template <typename WriterT>
+	static void writeElementToWriter(WriterT &jsonWriter, const int64_t *data) {
+		jsonWriter.Int64(*data);
+	}
+	template <typename WriterT>
+	static void writeElementToWriter(WriterT &jsonWriter, const uint64_t *data) {
+		jsonWriter.Uint64(*data);
+	}
+	template <typename WriterT>
+	static void writeElementToWriter(WriterT &jsonWriter, const float *data) {
+		jsonWriter.Double(*data);
+	}
+	template <typename WriterT>
+	static void writeElementToWriter(WriterT &jsonWriter, const double *data) {
+		jsonWriter.Double(*data);
+	}
+	template <typename WriterT>
+	static void writeElementToWriter(WriterT &jsonWriter, const Serializable *data) {
+		if (data)
+			JSONObjectMapper::serializeTo(data, jsonWriter);
+		else
+			jsonWriter.Null();
+	}
+	template <typename WriterT>
+	static void writeElementToWriter(WriterT &jsonWriter, const std::basic_string<char> *data) {
+		jsonWriter.String(data->c_str(), data->length());
+	}
+	template <typename WriterT>
+	static void writeElementToWriter(WriterT &jsonWriter, const std::basic_string<wchar_t> *data) {
+		const std::string &utf8Text = toUTF8(data->c_str(), data->length());
+		jsonWriter.String(utf8Text.c_str(), utf8Text.length());
+	}
+
+	// Integer and floating point arrays are formatted in one go into a scratch
+	// buffer and handed to the writer as a single raw array.
+	template <typename T>
+	struct IsBulkNumber : std::integral_constant<bool, std::is_arithmetic<T>::value && !std::is_same<T, bool>::value && !std::is_same<T, char>::value && !std::is_same<T, wchar_t>::value>
+	{ };
+
+	static char *formatNumber(char *buffer, int8_t value) { return rapidjson::internal::i32toa(value, buffer); }
+	static char *formatNumber(char *buffer, uint8_t value) { return rapidjson::internal::u32toa(value, buffer); }
+	static char *formatNumber(char *buffer, int16_t value) { return rapidjson::internal::i32toa(value, buffer); }
+	static char *formatNumber(char *buffer, uint16_t value) { return rapidjson::internal::u32toa(value, buffer); }
+	static char *formatNumber(char *buffer, int32_t value) { return rapidjson::internal::i32toa(value, buffer); }
+	static char *formatNumber(char *buffer, uint32_t value) { return rapidjson::internal::u32toa(value, buffer); }
+	static char *formatNumber(char *buffer, int64_t value) { return rapidjson::internal::i64toa(value, buffer); }
+	static char *formatNumber(char *buffer, uint64_t value) { return rapidjson::internal::u64toa(value, buffer); }
+	static char *formatNumber(char *buffer, float value) { return rapidjson::internal::dtoa(value, buffer); }
+	static char *formatNumber(char *buffer, double value) { return rapidjson::internal::dtoa(value, buffer); }
+
+	template <typename T>
+	static bool isFiniteNumber(T value) { return true; }
+	static bool isFiniteNumber(float value) { return std::isfinite(value); }
+	static bool isFiniteNumber(double value) { return std::isfinite(value); }
+
+	template <typename T, typename WriterT>
+	static void writeArrayToWriter(WriterT &jsonWriter, const T* data, size_t length, std::false_type)
+	{
+		size_t i;
+		jsonWriter.StartArray();
+		for (i = 0; i < length; i++)
+			writeElementToWriter(jsonWriter, &data[i]);
+		jsonWriter.EndArray(length);
+	}
+	template <typename T, typename WriterT>
+	static void writeArrayToWriter(WriterT &jsonWriter, const T* data, size_t length, std::true_type)
+	{
+		// Buffers past this size are freed after use rather than kept per thread
+		static const size_t retainSize = 64 * 1024;
+		static thread_local std::vector<char> retained;
+		std::vector<char> buffer;
+		size_t i;
+		char *p;
+		// Shortest round-trip text of a double fits in 25 characters
+		buffer.swap(retained);
+		buffer.resize(length * 26 + 2);
+		p = &buffer[0];
+		*p++ = '[';
+		for (i = 0; i < length; i++)
+		{
+			// NaN/Inf have no JSON form; let the writer reject them as before
+			if (!isFiniteNumber(data[i]))
+				break;
+			if (i > 0)
+				*p++ = ',';
+			p = formatNumber(p, data[i]);
+		}
+		*p++ = ']';
+		if (i == length)
+			jsonWriter.RawValue(&buffer[0], p - &buffer[0], rapidjson::kArrayType);
+		if (buffer.capacity() <= retainSize)
+			buffer.swap(retained);
+		if (i != length)
+			writeArrayToWriter(jsonWriter, data, length, std::false_type());
+	}
+
+	template <typename T, typename WriterT>
+	static void writeElementArrayToWriter(WriterT &jsonWriter, const T* data, size_t length)
+	{
+		writeArrayToWriter(jsonWriter, data, length, IsBulkNumber<T>());
+	}
+	template <typename T, typename WriterT>
+	static void writeStdVectorToWriter(WriterT &jsonWriter, const std::vector<T> *data) {
+		writeArrayToWriter(jsonWriter, data->empty() ? NULL : &(*data)[0], data->size(), IsBulkNumber<T>());
+	}
+	template <typename WriterT>
+	static void writeStdVectorToWriter(WriterT &jsonWriter, const std::vector<bool> *data) {
+		jsonWriter.StartArray();
+		for (std::vector<bool>::const_iterator iter = data->begin(); iter != data->end(); iter++)
+		{
+			bool value = *iter;
+			writeElementToWriter(jsonWriter, &value);
+		}
+		jsonWriter.EndArray(data->size());
+	}
+	template <typename T, typename WriterT>
+	static void writeStdListToWriter(WriterT &jsonWriter, const std::list< std::basic_string<T> > *data)
+	{
+		jsonWriter.StartArray();
+		for (typename std::list< std::basic_string<T> >::const_iterator iter = data->begin(); iter != data->end(); iter++)
+			writeElementToWriter(jsonWriter, &(*iter));
+		jsonWriter.EndArray(data->size());
+	}
+	template <typename T, typename WriterT>
+	static void writeStdListToWriter(WriterT &jsonWriter, const std::list< std::vector<T> > *data)
+	{
+		jsonWriter.StartArray();
+		for (typename std::list< std::vector<T> >::const_iterator iter = data->begin(); iter != data->end(); iter++)
+			writeStdVectorToWriter(jsonWriter, &(*iter));
+		jsonWriter.EndArray(data->size());
+	}
+
+	// Member keys of one class: the names, and the same names already quoted and
+	// escaped for the writer. Built once per class and kept for the life of the
+	// process, so DOM values may reference the names without copying them.
+	class JSONKeyCache
+	{
+	private:
+		std::vector<std::string> m_names;
+		std::vector<std::string> m_quoted;
+
+		explicit JSONKeyCache(const std::list<internal::STypeCommon*> &members)
+		{
+			for (std::list<internal::STypeCommon*>::const_iterator iterMem = members.begin(); iterMem != members.end(); iterMem++)
+			{
+				const std::string &name = (*iterMem)->_memberInfo.name;
+				rapidjson::StringBuffer jsonBuf;
+				rapidjson::Writer<rapidjson::StringBuffer> jsonWriter(jsonBuf);
+				jsonWriter.String(name.c_str(), name.length());
+				m_names.push_back(name);
+				m_quoted.push_back(std::string(jsonBuf.GetString(), jsonBuf.GetLength()));
+			}
+		}
+
+	public:
+		// Kept in the same kind of table as the class name tables of Serializable
+		static const JSONKeyCache *get(const Serializable *serialiable)
+		{
+			static internal::AppendOnlyTable<std::type_index, JSONKeyCache> caches;
+			std::type_index type(typeid(*serialiable));
+			internal::SameClass match(type);
+			const JSONKeyCache *cache = caches.find(match.hash(), match);
+			bool inserted;
+			if (!cache)
+				cache = caches.insert(match.hash(), match, type, JSONKeyCache(serialiable->serializableMembers()), &inserted);
+			return cache;
+		}
+
+		// NULL if this instance's member at ordinal is not the one the class was cached with
+		const std::string *name(size_t ordinal, const std::string &memberName) const
+		{
+			if ((ordinal < m_names.size()) && (m_names[ordinal] == memberName))
+				return &m_names[ordinal];
+			return NULL;
+		}
+		const std::string *quoted(size_t ordinal, const std::string &memberName) const
+		{
+			if ((ordinal < m_names.size()) && (m_names[ordinal] == memberName))
+				return &m_quoted[ordinal];
+			return NULL;
+		}
+	};
+
 	static void _serializeCheckNotEoo(uint16_t *tempEtype, std::list<internal::SerializableMemberInfo::EncapType>::const_iterator *iterEncap, std::list<internal::SerializableMemberInfo::EncapType>::const_iterator endOfEncap)
 	{
 		if ((*iterEncap) == endOfEncap)
@@ -355,21 +586,30 @@ namespace JsRPC {
 
 	void JSONObjectMapper::serializeTo(const Serializable *serialiable, rapidjson::Document &jsonDoc)
 	{
-		rapidjson::Document::AllocatorType &jsonAllocator = jsonDoc.GetAllocator();
+		serializeToValue(serialiable, jsonDoc, jsonDoc.GetAllocator());
+	}
 
+	void JSONObjectMapper::serializeToValue(const Serializable *serialiable, rapidjson::Value &jsonObject, rapidjson::Document::AllocatorType &jsonAllocator)
+	{
 		const std::list<internal::STypeCommon*> &members = serialiable->serializableMembers();
+		const JSONKeyCache *keyCache = JSONKeyCache::get(serialiable);
+		size_t ordinal = 0;
 
-		jsonDoc.SetObject();
+		jsonObject.SetObject();
 
 		// Data
-		for (std::list<internal::STypeCommon*>::const_iterator iterMem = members.begin(); iterMem != members.end(); iterMem++)
+		for (std::list<internal::STypeCommon*>::const_iterator iterMem = members.begin(); iterMem != members.end(); iterMem++, ordinal++)
 		{
 			std::list<internal::SerializableMemberInfo::EncapType>::const_iterator iterEncap = (*iterMem)->_memberInfo.encaps.begin();
 			std::list<internal::SerializableMemberInfo::EncapType>::const_iterator endOfEncap = (*iterMem)->_memberInfo.encaps.end();
+			const std::string *cachedName = keyCache->name(ordinal, (*iterMem)->_memberInfo.name);
 			uint16_t tempEtype;
 			rapidjson::Value jsonName;
 			rapidjson::Value jsonValue;
-			jsonName.SetString((*iterMem)->_memberInfo.name.c_str(), (*iterMem)->_memberInfo.name.length(), jsonAllocator);
+			if (cachedName)
+				jsonName.SetString(rapidjson::StringRef(cachedName->c_str(), cachedName->length()));
+			else
+				jsonName.SetString((*iterMem)->_memberInfo.name.c_str(), (*iterMem)->_memberInfo.name.length(), jsonAllocator);
 			_serializeCheckNotEoo(&tempEtype, &iterEncap, endOfEncap);
 			if ((*iterMem)->isNull())
 			{
@@ -423,6 +663,53 @@ namespace JsRPC {
 						throw Serializable::UnavailableTypeException();
 					}
 				}
+				else if ((tempEtype & 0xFF00) == internal::SerializableMemberInfo::EncapType::ETYPE_NATIVEARRAY)
+				{
+					switch (tempEtype & 0x00FF)
+					{
+					case (internal::SerializableMemberInfo::EncapType::ETYPE_BOOL):
+						writeElementArrayToPayload(jsonValue, jsonAllocator, (const bool*)((*iterMem)->_memberInfo.ptr), (*iterMem)->_memberInfo.length);
+						break;
+					case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 1):
+						writeElementArrayToPayload(jsonValue, jsonAllocator, (const int8_t*)((*iterMem)->_memberInfo.ptr), (*iterMem)->_memberInfo.length);
+						break;
+					case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 1):
+						writeElementArrayToPayload(jsonValue, jsonAllocator, (const uint8_t*)((*iterMem)->_memberInfo.ptr), (*iterMem)->_memberInfo.length);
+						break;
+					case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 2):
+						writeElementArrayToPayload(jsonValue, jsonAllocator, (const int16_t*)((*iterMem)->_memberInfo.ptr), (*iterMem)->_memberInfo.length);
+						break;
+					case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 2):
+						writeElementArrayToPayload(jsonValue, jsonAllocator, (const uint16_t*)((*iterMem)->_memberInfo.ptr), (*iterMem)->_memberInfo.length);
+						break;
+					case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 4):
+						writeElementArrayToPayload(jsonValue, jsonAllocator, (const int32_t*)((*iterMem)->_memberInfo.ptr), (*iterMem)->_memberInfo.length);
+						break;
+					case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 4):
+						writeElementArrayToPayload(jsonValue, jsonAllocator, (const uint32_t*)((*iterMem)->_memberInfo.ptr), (*iterMem)->_memberInfo.length);
+						break;
+					case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 8):
+						writeElementArrayToPayload(jsonValue, jsonAllocator, (const int64_t*)((*iterMem)->_memberInfo.ptr), (*iterMem)->_memberInfo.length);
+						break;
+					case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 8):
+						writeElementArrayToPayload(jsonValue, jsonAllocator, (const uint64_t*)((*iterMem)->_memberInfo.ptr), (*iterMem)->_memberInfo.length);
+						break;
+					case (internal::SerializableMemberInfo::EncapType::ETYPE_CHAR):
+						writeElementArrayToPayload(jsonValue, jsonAllocator, (const char*)((*iterMem)->_memberInfo.ptr), (*iterMem)->_memberInfo.length);
+						break;
+					case (internal::SerializableMemberInfo::EncapType::ETYPE_WCHAR):
+						writeElementArrayToPayload(jsonValue, jsonAllocator, (const wchar_t*)((*iterMem)->_memberInfo.ptr), (*iterMem)->_memberInfo.length);
+						break;
+					case (internal::SerializableMemberInfo::EncapType::ETYPE_FLOAT):
+						writeElementArrayToPayload(jsonValue, jsonAllocator, (const float*)((*iterMem)->_memberInfo.ptr), (*iterMem)->_memberInfo.length);
+						break;
+					case (internal::SerializableMemberInfo::EncapType::ETYPE_DOUBLE):
+						writeElementArrayToPayload(jsonValue, jsonAllocator, (const double*)((*iterMem)->_memberInfo.ptr), (*iterMem)->_memberInfo.length);
+						break;
+					default:
+						throw Serializable::UnavailableTypeException();
+					}
+				}
 				else {
 					switch (tempEtype)
 					{
@@ -566,6 +853,7 @@ namespace JsRPC {
 									writeStdListToPayload(jsonValue, jsonAllocator, (std::list<std::basic_string<wchar_t> >*)(*iterMem)->_memberInfo.ptr);
 								else
 									throw Serializable::UnavailableTypeException();
+								break;
 							default:
 								throw Serializable::UnavailableTypeException();
 							}
@@ -596,354 +884,1339 @@ namespace JsRPC {
 							throw Serializable::UnavailableTypeException();
 						}
 						break;
-					case internal::SerializableMemberInfo::EncapType::ETYPE_NATIVEARRAY:
+					default:
+						throw Serializable::UnavailableTypeException();
+					}
+				}
+			}
+			jsonObject.AddMember(jsonName, jsonValue, jsonAllocator);
+		}
+	}
+
+	void JSONObjectMapper::serializeTo(const Serializable *serialiable, rapidjson::Writer<rapidjson::StringBuffer> &jsonWriter)
+	{
+		const std::list<internal::STypeCommon*> &members = serialiable->serializableMembers();
+		const JSONKeyCache *keyCache = JSONKeyCache::get(serialiable);
+		size_t ordinal = 0;
+
+		jsonWriter.StartObject();
+
+		// Data
+		for (std::list<internal::STypeCommon*>::const_iterator iterMem = members.begin(); iterMem != members.end(); iterMem++, ordinal++)
+		{
+			std::list<internal::SerializableMemberInfo::EncapType>::const_iterator iterEncap = (*iterMem)->_memberInfo.encaps.begin();
+			std::list<internal::SerializableMemberInfo::EncapType>::const_iterator endOfEncap = (*iterMem)->_memberInfo.encaps.end();
+			const std::string *quotedKey = keyCache->quoted(ordinal, (*iterMem)->_memberInfo.name);
+			uint16_t tempEtype;
+			// A pre-escaped key goes out as one raw copy; the writer still adds the separators
+			if (quotedKey)
+				jsonWriter.RawValue(quotedKey->c_str(), quotedKey->length(), rapidjson::kStringType);
+			else
+				jsonWriter.Key((*iterMem)->_memberInfo.name.c_str(), (*iterMem)->_memberInfo.name.length());
+			_serializeCheckNotEoo(&tempEtype, &iterEncap, endOfEncap);
+			if ((*iterMem)->isNull())
+			{
+				jsonWriter.Null();
+			}
+			else if ((tempEtype & 0xFF00) == internal::SerializableMemberInfo::EncapType::ETYPE_NATIVE)
+			{
+				switch (tempEtype & 0x00FF)
+				{
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_BOOL):
+					writeElementToWriter(jsonWriter, (const bool*)((*iterMem)->_memberInfo.ptr));
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 1):
+					writeElementToWriter(jsonWriter, (const int8_t*)((*iterMem)->_memberInfo.ptr));
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 1):
+					writeElementToWriter(jsonWriter, (const uint8_t*)((*iterMem)->_memberInfo.ptr));
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 2):
+					writeElementToWriter(jsonWriter, (const int16_t*)((*iterMem)->_memberInfo.ptr));
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 2):
+					writeElementToWriter(jsonWriter, (const uint16_t*)((*iterMem)->_memberInfo.ptr));
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 4):
+					writeElementToWriter(jsonWriter, (const int32_t*)((*iterMem)->_memberInfo.ptr));
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 4):
+					writeElementToWriter(jsonWriter, (const uint32_t*)((*iterMem)->_memberInfo.ptr));
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 8):
+					writeElementToWriter(jsonWriter, (const int64_t*)((*iterMem)->_memberInfo.ptr));
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 8):
+					writeElementToWriter(jsonWriter, (const uint64_t*)((*iterMem)->_memberInfo.ptr));
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_CHAR):
+					writeElementToWriter(jsonWriter, (const char*)((*iterMem)->_memberInfo.ptr));
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_WCHAR):
+					writeElementToWriter(jsonWriter, (const wchar_t*)((*iterMem)->_memberInfo.ptr));
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_FLOAT):
+					writeElementToWriter(jsonWriter, (const float*)((*iterMem)->_memberInfo.ptr));
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_DOUBLE):
+					writeElementToWriter(jsonWriter, (const double*)((*iterMem)->_memberInfo.ptr));
+					break;
+				default:
+					throw Serializable::UnavailableTypeException();
+				}
+			}
+			else if ((tempEtype & 0xFF00) == internal::SerializableMemberInfo::EncapType::ETYPE_NATIVEARRAY)
+			{
+				switch (tempEtype & 0x00FF)
+				{
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_BOOL):
+					writeElementArrayToWriter(jsonWriter, (const bool*)((*iterMem)->_memberInfo.ptr), (*iterMem)->_memberInfo.length);
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 1):
+					writeElementArrayToWriter(jsonWriter, (const int8_t*)((*iterMem)->_memberInfo.ptr), (*iterMem)->_memberInfo.length);
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 1):
+					writeElementArrayToWriter(jsonWriter, (const uint8_t*)((*iterMem)->_memberInfo.ptr), (*iterMem)->_memberInfo.length);
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 2):
+					writeElementArrayToWriter(jsonWriter, (const int16_t*)((*iterMem)->_memberInfo.ptr), (*iterMem)->_memberInfo.length);
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 2):
+					writeElementArrayToWriter(jsonWriter, (const uint16_t*)((*iterMem)->_memberInfo.ptr), (*iterMem)->_memberInfo.length);
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 4):
+					writeElementArrayToWriter(jsonWriter, (const int32_t*)((*iterMem)->_memberInfo.ptr), (*iterMem)->_memberInfo.length);
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 4):
+					writeElementArrayToWriter(jsonWriter, (const uint32_t*)((*iterMem)->_memberInfo.ptr), (*iterMem)->_memberInfo.length);
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 8):
+					writeElementArrayToWriter(jsonWriter, (const int64_t*)((*iterMem)->_memberInfo.ptr), (*iterMem)->_memberInfo.length);
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 8):
+					writeElementArrayToWriter(jsonWriter, (const uint64_t*)((*iterMem)->_memberInfo.ptr), (*iterMem)->_memberInfo.length);
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_CHAR):
+					writeElementArrayToWriter(jsonWriter, (const char*)((*iterMem)->_memberInfo.ptr), (*iterMem)->_memberInfo.length);
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_WCHAR):
+					writeElementArrayToWriter(jsonWriter, (const wchar_t*)((*iterMem)->_memberInfo.ptr), (*iterMem)->_memberInfo.length);
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_FLOAT):
+					writeElementArrayToWriter(jsonWriter, (const float*)((*iterMem)->_memberInfo.ptr), (*iterMem)->_memberInfo.length);
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_DOUBLE):
+					writeElementArrayToWriter(jsonWriter, (const double*)((*iterMem)->_memberInfo.ptr), (*iterMem)->_memberInfo.length);
+					break;
+				default:
+					throw Serializable::UnavailableTypeException();
+				}
+			}
+			else {
+				switch (tempEtype)
+				{
+				case internal::SerializableMemberInfo::EncapType::ETYPE_STDBASICSTRING:
+					_serializeCheckEoo(&tempEtype, &iterEncap, endOfEncap);
+					if (checkFlagsAll(tempEtype, internal::SerializableMemberInfo::EncapType::ETYPE_CHAR))
+						writeElementToWriter(jsonWriter, (const std::basic_string<char>*)(*iterMem)->_memberInfo.ptr);
+					else if (checkFlagsAll(tempEtype, internal::SerializableMemberInfo::EncapType::ETYPE_WCHAR))
+						writeElementToWriter(jsonWriter, (const std::basic_string<wchar_t>*)(*iterMem)->_memberInfo.ptr);
+					else
+						throw Serializable::UnavailableTypeException();
+					break;
+				case internal::SerializableMemberInfo::EncapType::ETYPE_STDVECTOR:
+					_serializeCheckEoo(&tempEtype, &iterEncap, endOfEncap);
+					switch (tempEtype & 0x00FF)
+					{
+					case (internal::SerializableMemberInfo::EncapType::ETYPE_BOOL):
+						writeStdVectorToWriter(jsonWriter, (const std::vector<bool>*)((*iterMem)->_memberInfo.ptr));
+						break;
+					case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 1):
+						writeStdVectorToWriter(jsonWriter, (const std::vector<int8_t>*)((*iterMem)->_memberInfo.ptr));
+						break;
+					case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 1):
+						writeStdVectorToWriter(jsonWriter, (const std::vector<uint8_t>*)((*iterMem)->_memberInfo.ptr));
+						break;
+					case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 2):
+						writeStdVectorToWriter(jsonWriter, (const std::vector<int16_t>*)((*iterMem)->_memberInfo.ptr));
+						break;
+					case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 2):
+						writeStdVectorToWriter(jsonWriter, (const std::vector<uint16_t>*)((*iterMem)->_memberInfo.ptr));
+						break;
+					case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 4):
+						writeStdVectorToWriter(jsonWriter, (const std::vector<int32_t>*)((*iterMem)->_memberInfo.ptr));
+						break;
+					case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 4):
+						writeStdVectorToWriter(jsonWriter, (const std::vector<uint32_t>*)((*iterMem)->_memberInfo.ptr));
+						break;
+					case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 8):
+						writeStdVectorToWriter(jsonWriter, (const std::vector<int64_t>*)((*iterMem)->_memberInfo.ptr));
+						break;
+					case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 8):
+						writeStdVectorToWriter(jsonWriter, (const std::vector<uint64_t>*)((*iterMem)->_memberInfo.ptr));
+						break;
+					case (internal::SerializableMemberInfo::EncapType::ETYPE_CHAR):
+						writeStdVectorToWriter(jsonWriter, (const std::vector<char>*)((*iterMem)->_memberInfo.ptr));
+						break;
+					case (internal::SerializableMemberInfo::EncapType::ETYPE_WCHAR):
+						writeStdVectorToWriter(jsonWriter, (const std::vector<wchar_t>*)((*iterMem)->_memberInfo.ptr));
+						break;
+					case (internal::SerializableMemberInfo::EncapType::ETYPE_FLOAT):
+						writeStdVectorToWriter(jsonWriter, (const std::vector<float>*)((*iterMem)->_memberInfo.ptr));
+						break;
+					case (internal::SerializableMemberInfo::EncapType::ETYPE_DOUBLE):
+						writeStdVectorToWriter(jsonWriter, (const std::vector<double>*)((*iterMem)->_memberInfo.ptr));
+						break;
+					default:
+						throw Serializable::UnavailableTypeException();
+					}
+					break;
+				case internal::SerializableMemberInfo::EncapType::ETYPE_STDLIST:
+					_serializeCheckNotEoo(&tempEtype, &iterEncap, endOfEncap);
+					if (iterEncap == endOfEncap)
+						throw Serializable::UnavailableTypeException();
+					switch (tempEtype)
+					{
+					case internal::SerializableMemberInfo::EncapType::ETYPE_SMARTPOINTER:
+						_serializeCheckEoo(&tempEtype, &iterEncap, endOfEncap);
+						if (tempEtype != internal::SerializableMemberInfo::EncapType::ETYPE_SUBPAYLOAD)
+							throw Serializable::UnavailableTypeException();
+						{
+							const std::list<JsCPPUtils::SmartPointer<Serializable> > *plist = (const std::list<JsCPPUtils::SmartPointer<Serializable> >*)(*iterMem)->_memberInfo.ptr;
+							jsonWriter.StartArray();
+							for (std::list<JsCPPUtils::SmartPointer<Serializable> >::const_iterator subiter = plist->begin(); subiter != plist->end(); subiter++)
+								writeElementToWriter(jsonWriter, (const Serializable*)subiter->getPtr());
+							jsonWriter.EndArray(plist->size());
+						}
+						break;
+					case internal::SerializableMemberInfo::EncapType::ETYPE_STDVECTOR:
+						_serializeCheckEoo(&tempEtype, &iterEncap, endOfEncap);
 						switch (tempEtype & 0x00FF)
 						{
 						case (internal::SerializableMemberInfo::EncapType::ETYPE_BOOL):
-							writeElementArrayToPayload(jsonValue, jsonAllocator, (const bool*)((*iterMem)->_memberInfo.ptr), (*iterMem)->_memberInfo.length);
+							writeStdListToWriter(jsonWriter, (const std::list< std::vector<bool> >*)((*iterMem)->_memberInfo.ptr));
 							break;
 						case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 1):
-							writeElementArrayToPayload(jsonValue, jsonAllocator, (const int8_t*)((*iterMem)->_memberInfo.ptr), (*iterMem)->_memberInfo.length);
+							writeStdListToWriter(jsonWriter, (const std::list< std::vector<int8_t> >*)((*iterMem)->_memberInfo.ptr));
 							break;
 						case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 1):
-							writeElementArrayToPayload(jsonValue, jsonAllocator, (const uint8_t*)((*iterMem)->_memberInfo.ptr), (*iterMem)->_memberInfo.length);
+							writeStdListToWriter(jsonWriter, (const std::list< std::vector<uint8_t> >*)((*iterMem)->_memberInfo.ptr));
 							break;
 						case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 2):
-							writeElementArrayToPayload(jsonValue, jsonAllocator, (const int16_t*)((*iterMem)->_memberInfo.ptr), (*iterMem)->_memberInfo.length);
+							writeStdListToWriter(jsonWriter, (const std::list< std::vector<int16_t> >*)((*iterMem)->_memberInfo.ptr));
 							break;
 						case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 2):
-							writeElementArrayToPayload(jsonValue, jsonAllocator, (const uint16_t*)((*iterMem)->_memberInfo.ptr), (*iterMem)->_memberInfo.length);
+							writeStdListToWriter(jsonWriter, (const std::list< std::vector<uint16_t> >*)((*iterMem)->_memberInfo.ptr));
 							break;
 						case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 4):
-							writeElementArrayToPayload(jsonValue, jsonAllocator, (const int32_t*)((*iterMem)->_memberInfo.ptr), (*iterMem)->_memberInfo.length);
+							writeStdListToWriter(jsonWriter, (const std::list< std::vector<int32_t> >*)((*iterMem)->_memberInfo.ptr));
 							break;
 						case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 4):
-							writeElementArrayToPayload(jsonValue, jsonAllocator, (const uint32_t*)((*iterMem)->_memberInfo.ptr), (*iterMem)->_memberInfo.length);
+							writeStdListToWriter(jsonWriter, (const std::list< std::vector<uint32_t> >*)((*iterMem)->_memberInfo.ptr));
 							break;
 						case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 8):
-							writeElementArrayToPayload(jsonValue, jsonAllocator, (const int64_t*)((*iterMem)->_memberInfo.ptr), (*iterMem)->_memberInfo.length);
+							writeStdListToWriter(jsonWriter, (const std::list< std::vector<int64_t> >*)((*iterMem)->_memberInfo.ptr));
 							break;
 						case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 8):
-							writeElementArrayToPayload(jsonValue, jsonAllocator, (const uint64_t*)((*iterMem)->_memberInfo.ptr), (*iterMem)->_memberInfo.length);
+							writeStdListToWriter(jsonWriter, (const std::list< std::vector<uint64_t> >*)((*iterMem)->_memberInfo.ptr));
 							break;
 						case (internal::SerializableMemberInfo::EncapType::ETYPE_CHAR):
-							writeElementArrayToPayload(jsonValue, jsonAllocator, (const char*)((*iterMem)->_memberInfo.ptr), (*iterMem)->_memberInfo.length);
+							writeStdListToWriter(jsonWriter, (const std::list< std::vector<char> >*)((*iterMem)->_memberInfo.ptr));
 							break;
 						case (internal::SerializableMemberInfo::EncapType::ETYPE_WCHAR):
-							writeElementArrayToPayload(jsonValue, jsonAllocator, (const wchar_t*)((*iterMem)->_memberInfo.ptr), (*iterMem)->_memberInfo.length);
+							writeStdListToWriter(jsonWriter, (const std::list< std::vector<wchar_t> >*)((*iterMem)->_memberInfo.ptr));
 							break;
 						case (internal::SerializableMemberInfo::EncapType::ETYPE_FLOAT):
-							writeElementArrayToPayload(jsonValue, jsonAllocator, (const float*)((*iterMem)->_memberInfo.ptr), (*iterMem)->_memberInfo.length);
+							writeStdListToWriter(jsonWriter, (const std::list< std::vector<float> >*)((*iterMem)->_memberInfo.ptr));
 							break;
 						case (internal::SerializableMemberInfo::EncapType::ETYPE_DOUBLE):
-							writeElementArrayToPayload(jsonValue, jsonAllocator, (const double*)((*iterMem)->_memberInfo.ptr), (*iterMem)->_memberInfo.length);
+							writeStdListToWriter(jsonWriter, (const std::list< std::vector<double> >*)((*iterMem)->_memberInfo.ptr));
+							break;
 						default:
 							throw Serializable::UnavailableTypeException();
 						}
 						break;
+					case internal::SerializableMemberInfo::EncapType::ETYPE_STDBASICSTRING:
+						_serializeCheckEoo(&tempEtype, &iterEncap, endOfEncap);
+						if (checkFlagsAll(tempEtype, internal::SerializableMemberInfo::EncapType::ETYPE_CHAR))
+							writeStdListToWriter(jsonWriter, (const std::list< std::basic_string<char> > *)(*iterMem)->_memberInfo.ptr);
+						else if (checkFlagsAll(tempEtype, internal::SerializableMemberInfo::EncapType::ETYPE_WCHAR))
+							writeStdListToWriter(jsonWriter, (const std::list< std::basic_string<wchar_t> > *)(*iterMem)->_memberInfo.ptr);
+						else
+							throw Serializable::UnavailableTypeException();
+						break;
 					default:
 						throw Serializable::UnavailableTypeException();
 					}
+					break;
+				case internal::SerializableMemberInfo::EncapType::ETYPE_SUBPAYLOAD:
+					writeElementToWriter(jsonWriter, (const Serializable*)(*iterMem)->_memberInfo.ptr);
+					break;
+				case internal::SerializableMemberInfo::EncapType::ETYPE_SMARTPOINTER:
+					_serializeCheckEoo(&tempEtype, &iterEncap, endOfEncap);
+					if (tempEtype != internal::SerializableMemberInfo::EncapType::ETYPE_SUBPAYLOAD)
+						throw Serializable::UnavailableTypeException();
+					writeElementToWriter(jsonWriter, (const Serializable*)((const JsCPPUtils::SmartPointer<Serializable>*)(*iterMem)->_memberInfo.ptr)->getPtr());
+					break;
+				default:
+					throw Serializable::UnavailableTypeException();
 				}
 			}
-			jsonDoc.AddMember(jsonName, jsonValue, jsonAllocator);
 		}
+
+		jsonWriter.EndObject(members.size());
 	}
 
-	void JSONObjectMapper::deserializeJsonObject(Serializable *serialiable, const rapidjson::Value &jsonObject) throw(JSONObjectMapper::TypeNotMatchException)
+	static void readMemberFromJson(internal::STypeCommon *member, const rapidjson::Value &jsonValue)
 	{
-		const std::list<internal::STypeCommon*> members = serialiable->serializableMembers();
-
-		for(std::list<internal::STypeCommon*>::const_iterator iterMem = members.begin(); iterMem != members.end(); iterMem++)
-		{
-			std::list<internal::SerializableMemberInfo::EncapType>::const_iterator iterEncap = (*iterMem)->_memberInfo.encaps.begin();
-			std::list<internal::SerializableMemberInfo::EncapType>::const_iterator endOfEncap = (*iterMem)->_memberInfo.encaps.end();
-			uint16_t tempEtypeReal;
-			const char *name = (*iterMem)->_memberInfo.name.c_str();
-			_serializeCheckNotEoo(&tempEtypeReal, &iterEncap, endOfEncap);
-			(*iterMem)->clear();
-			if (jsonObject.HasMember(name))
+		std::list<internal::SerializableMemberInfo::EncapType>::const_iterator iterEncap = member->_memberInfo.encaps.begin();
+		std::list<internal::SerializableMemberInfo::EncapType>::const_iterator endOfEncap = member->_memberInfo.encaps.end();
+		uint16_t tempEtypeReal;
+		_serializeCheckNotEoo(&tempEtypeReal, &iterEncap, endOfEncap);
+		if (jsonValue.IsNull()) {
+			member->setNull();
+		} else {
+			member->setNull(false);
+			if ((tempEtypeReal & 0xFF00) == internal::SerializableMemberInfo::EncapType::ETYPE_NATIVE)
+			{
+				switch (tempEtypeReal & 0x00FF)
+				{
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_BOOL):
+					readElementFromPayload<bool>(jsonValue, (bool*)(member->_memberInfo.ptr));
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 1):
+					readElementFromPayload<int8_t>(jsonValue, (int8_t*)(member->_memberInfo.ptr));
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 1):
+					readElementFromPayload<uint8_t>(jsonValue, (uint8_t*)(member->_memberInfo.ptr));
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 2):
+					readElementFromPayload<int16_t>(jsonValue, (int16_t*)(member->_memberInfo.ptr));
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 2):
+					readElementFromPayload<uint16_t>(jsonValue, (uint16_t*)(member->_memberInfo.ptr));
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 4):
+					readElementFromPayload<int32_t>(jsonValue, (int32_t*)(member->_memberInfo.ptr));
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 4):
+					readElementFromPayload<uint32_t>(jsonValue, (uint32_t*)(member->_memberInfo.ptr));
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 8):
+					readElementFromPayload<int64_t>(jsonValue, (int64_t*)(member->_memberInfo.ptr));
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 8):
+					readElementFromPayload<uint64_t>(jsonValue, (uint64_t*)(member->_memberInfo.ptr));
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_CHAR):
+					readElementFromPayload<char>(jsonValue, (char*)(member->_memberInfo.ptr));
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_WCHAR):
+					readElementFromPayload<wchar_t>(jsonValue, (wchar_t*)(member->_memberInfo.ptr));
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_FLOAT):
+					readElementFromPayload<float>(jsonValue, (float*)(member->_memberInfo.ptr));
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_DOUBLE):
+					readElementFromPayload<double>(jsonValue, (double*)(member->_memberInfo.ptr));
+					break;
+				default:
+					throw Serializable::UnavailableTypeException();
+				}
+			}
+			else if ((tempEtypeReal & 0xFF00) == internal::SerializableMemberInfo::EncapType::ETYPE_NATIVEARRAY)
 			{
-				const rapidjson::Value &jsonValue = jsonObject[name];
-				if (jsonValue.IsNull()) {
-					(*iterMem)->setNull();
-				} else {
-					if ((tempEtypeReal & 0xFF00) == internal::SerializableMemberInfo::EncapType::ETYPE_NATIVE)
+				switch (tempEtypeReal & 0x00FF)
+				{
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_BOOL):
+					readElementArrayFromPayload(jsonValue, (int8_t*)(member->_memberInfo.ptr), member->_memberInfo.length);
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 1):
+					readElementArrayFromPayload(jsonValue, (int8_t*)(member->_memberInfo.ptr), member->_memberInfo.length);
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 1):
+					readElementArrayFromPayload(jsonValue, (uint8_t*)(member->_memberInfo.ptr), member->_memberInfo.length);
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 2):
+					readElementArrayFromPayload(jsonValue, (int16_t*)(member->_memberInfo.ptr), member->_memberInfo.length);
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 2):
+					readElementArrayFromPayload(jsonValue, (uint16_t*)(member->_memberInfo.ptr), member->_memberInfo.length);
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 4):
+					readElementArrayFromPayload(jsonValue, (int32_t*)(member->_memberInfo.ptr), member->_memberInfo.length);
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 4):
+					readElementArrayFromPayload(jsonValue, (uint32_t*)(member->_memberInfo.ptr), member->_memberInfo.length);
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 8):
+					readElementArrayFromPayload(jsonValue, (int64_t*)(member->_memberInfo.ptr), member->_memberInfo.length);
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 8):
+					readElementArrayFromPayload(jsonValue, (uint64_t*)(member->_memberInfo.ptr), member->_memberInfo.length);
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_CHAR):
+					readElementArrayFromPayload(jsonValue, (char*)(member->_memberInfo.ptr), member->_memberInfo.length);
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_WCHAR):
+					readElementArrayFromPayload(jsonValue, (wchar_t*)(member->_memberInfo.ptr), member->_memberInfo.length);
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_FLOAT):
+					readElementArrayFromPayload(jsonValue, (float*)(member->_memberInfo.ptr), member->_memberInfo.length);
+					break;
+				case (internal::SerializableMemberInfo::EncapType::ETYPE_DOUBLE):
+					readElementArrayFromPayload(jsonValue, (double*)(member->_memberInfo.ptr), member->_memberInfo.length);
+					break;
+				default:
+					throw Serializable::UnavailableTypeException();
+				}
+			}
+			else {
+				switch (tempEtypeReal)
+				{
+				case internal::SerializableMemberInfo::EncapType::ETYPE_STDBASICSTRING:
+					_serializeCheckEoo(&tempEtypeReal, &iterEncap, endOfEncap);
+					if (iterEncap != endOfEncap)
+						throw Serializable::UnavailableTypeException();
+					if (((tempEtypeReal & internal::SerializableMemberInfo::EncapType::ETYPE_CHAR) == internal::SerializableMemberInfo::EncapType::ETYPE_CHAR))
+						readElementFromPayload(jsonValue, (std::basic_string<char>*)member->_memberInfo.ptr);
+					else if (((tempEtypeReal & internal::SerializableMemberInfo::EncapType::ETYPE_WCHAR) == internal::SerializableMemberInfo::EncapType::ETYPE_WCHAR))
+						readElementFromPayload(jsonValue, (std::basic_string<wchar_t>*)member->_memberInfo.ptr);
+					else
+						throw Serializable::UnavailableTypeException();
+					break;
+				case internal::SerializableMemberInfo::EncapType::ETYPE_STDVECTOR:
+					_serializeCheckNotEoo(&tempEtypeReal, &iterEncap, endOfEncap);
+					if (iterEncap != endOfEncap)
+						throw Serializable::UnavailableTypeException();
+					if (!(tempEtypeReal & internal::SerializableMemberInfo::EncapType::ETYPE_NULL))
 					{
 						switch (tempEtypeReal & 0x00FF)
 						{
 						case (internal::SerializableMemberInfo::EncapType::ETYPE_BOOL):
-							readElementFromPayload<bool>(jsonValue, (bool*)((*iterMem)->_memberInfo.ptr));
+							readStdVectorFromPayload(jsonValue, (std::vector<bool>*)(member->_memberInfo.ptr));
 							break;
 						case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 1):
-							readElementFromPayload<int8_t>(jsonValue, (int8_t*)((*iterMem)->_memberInfo.ptr));
+							readStdVectorFromPayload(jsonValue, (std::vector<int8_t>*)(member->_memberInfo.ptr));
 							break;
 						case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 1):
-							readElementFromPayload<uint8_t>(jsonValue, (uint8_t*)((*iterMem)->_memberInfo.ptr));
+							readStdVectorFromPayload(jsonValue, (std::vector<uint8_t>*)(member->_memberInfo.ptr));
 							break;
 						case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 2):
-							readElementFromPayload<int16_t>(jsonValue, (int16_t*)((*iterMem)->_memberInfo.ptr));
+							readStdVectorFromPayload(jsonValue, (std::vector<int16_t>*)(member->_memberInfo.ptr));
 							break;
 						case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 2):
-							readElementFromPayload<uint16_t>(jsonValue, (uint16_t*)((*iterMem)->_memberInfo.ptr));
+							readStdVectorFromPayload(jsonValue, (std::vector<uint16_t>*)(member->_memberInfo.ptr));
 							break;
 						case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 4):
-							readElementFromPayload<int32_t>(jsonValue, (int32_t*)((*iterMem)->_memberInfo.ptr));
+							readStdVectorFromPayload(jsonValue, (std::vector<int32_t>*)(member->_memberInfo.ptr));
 							break;
 						case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 4):
-							readElementFromPayload<uint32_t>(jsonValue, (uint32_t*)((*iterMem)->_memberInfo.ptr));
+							readStdVectorFromPayload(jsonValue, (std::vector<uint32_t>*)(member->_memberInfo.ptr));
 							break;
 						case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 8):
-							readElementFromPayload<int64_t>(jsonValue, (int64_t*)((*iterMem)->_memberInfo.ptr));
+							readStdVectorFromPayload(jsonValue, (std::vector<int64_t>*)(member->_memberInfo.ptr));
 							break;
 						case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 8):
-							readElementFromPayload<uint64_t>(jsonValue, (uint64_t*)((*iterMem)->_memberInfo.ptr));
+							readStdVectorFromPayload(jsonValue, (std::vector<uint64_t>*)(member->_memberInfo.ptr));
 							break;
 						case (internal::SerializableMemberInfo::EncapType::ETYPE_CHAR):
-							readElementFromPayload<char>(jsonValue, (char*)((*iterMem)->_memberInfo.ptr));
+							readStdVectorFromPayload(jsonValue, (std::vector<char>*)(member->_memberInfo.ptr));
 							break;
 						case (internal::SerializableMemberInfo::EncapType::ETYPE_WCHAR):
-							readElementFromPayload<wchar_t>(jsonValue, (wchar_t*)((*iterMem)->_memberInfo.ptr));
+							readStdVectorFromPayload(jsonValue, (std::vector<wchar_t>*)(member->_memberInfo.ptr));
 							break;
 						case (internal::SerializableMemberInfo::EncapType::ETYPE_FLOAT):
-							readElementFromPayload<float>(jsonValue, (float*)((*iterMem)->_memberInfo.ptr));
+							readStdVectorFromPayload(jsonValue, (std::vector<float>*)(member->_memberInfo.ptr));
 							break;
 						case (internal::SerializableMemberInfo::EncapType::ETYPE_DOUBLE):
-							readElementFromPayload<double>(jsonValue, (double*)((*iterMem)->_memberInfo.ptr));
+							readStdVectorFromPayload(jsonValue, (std::vector<double>*)(member->_memberInfo.ptr));
 							break;
 						default:
 							throw Serializable::UnavailableTypeException();
 						}
 					}
+					break;
+				case internal::SerializableMemberInfo::EncapType::ETYPE_STDLIST:
+					_serializeCheckNotEoo(&tempEtypeReal, &iterEncap, endOfEncap);
+					if (iterEncap == endOfEncap)
+					{
+						throw Serializable::UnavailableTypeException();
+					}
 					else {
 						switch (tempEtypeReal)
 						{
-						case internal::SerializableMemberInfo::EncapType::ETYPE_STDBASICSTRING:
-							_serializeCheckEoo(&tempEtypeReal, &iterEncap, endOfEncap);
-							if (iterEncap != endOfEncap)
-								throw Serializable::UnavailableTypeException();
-							if (checkFlagsAll(tempEtypeReal, internal::SerializableMemberInfo::EncapType::ETYPE_CHAR))
-								readElementFromPayload(jsonValue, (std::basic_string<char>*)(*iterMem)->_memberInfo.ptr);
-							else if (checkFlagsAll(tempEtypeReal, internal::SerializableMemberInfo::EncapType::ETYPE_WCHAR))
-								readElementFromPayload(jsonValue, (std::basic_string<wchar_t>*)(*iterMem)->_memberInfo.ptr);
-							else
-								throw Serializable::UnavailableTypeException();
-							break;
-						case internal::SerializableMemberInfo::EncapType::ETYPE_STDVECTOR:
-							_serializeCheckNotEoo(&tempEtypeReal, &iterEncap, endOfEncap);
-							if (iterEncap != endOfEncap)
-								throw Serializable::UnavailableTypeException();
-							if (!(tempEtypeReal & internal::SerializableMemberInfo::EncapType::ETYPE_NULL))
-							{
-								switch (tempEtypeReal & 0x00FF)
-								{
-								case (internal::SerializableMemberInfo::EncapType::ETYPE_BOOL):
-									readStdVectorFromPayload(jsonValue, (std::vector<bool>*)((*iterMem)->_memberInfo.ptr));
-									break;
-								case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 1):
-									readStdVectorFromPayload(jsonValue, (std::vector<int8_t>*)((*iterMem)->_memberInfo.ptr));
-									break;
-								case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 1):
-									readStdVectorFromPayload(jsonValue, (std::vector<uint8_t>*)((*iterMem)->_memberInfo.ptr));
-									break;
-								case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 2):
-									readStdVectorFromPayload(jsonValue, (std::vector<int16_t>*)((*iterMem)->_memberInfo.ptr));
-									break;
-								case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 2):
-									readStdVectorFromPayload(jsonValue, (std::vector<uint16_t>*)((*iterMem)->_memberInfo.ptr));
-									break;
-								case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 4):
-									readStdVectorFromPayload(jsonValue, (std::vector<int32_t>*)((*iterMem)->_memberInfo.ptr));
-									break;
-								case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 4):
-									readStdVectorFromPayload(jsonValue, (std::vector<uint32_t>*)((*iterMem)->_memberInfo.ptr));
-									break;
-								case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 8):
-									readStdVectorFromPayload(jsonValue, (std::vector<int64_t>*)((*iterMem)->_memberInfo.ptr));
-									break;
-								case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 8):
-									readStdVectorFromPayload(jsonValue, (std::vector<uint64_t>*)((*iterMem)->_memberInfo.ptr));
-									break;
-								case (internal::SerializableMemberInfo::EncapType::ETYPE_CHAR):
-									readStdVectorFromPayload(jsonValue, (std::vector<char>*)((*iterMem)->_memberInfo.ptr));
-									break;
-								case (internal::SerializableMemberInfo::EncapType::ETYPE_WCHAR):
-									readStdVectorFromPayload(jsonValue, (std::vector<wchar_t>*)((*iterMem)->_memberInfo.ptr));
-									break;
-								case (internal::SerializableMemberInfo::EncapType::ETYPE_FLOAT):
-									readStdVectorFromPayload(jsonValue, (std::vector<float>*)((*iterMem)->_memberInfo.ptr));
-									break;
-								case (internal::SerializableMemberInfo::EncapType::ETYPE_DOUBLE):
-									readStdVectorFromPayload(jsonValue, (std::vector<double>*)((*iterMem)->_memberInfo.ptr));
-									break;
-								default:
-									throw Serializable::UnavailableTypeException();
-								}
-							}
-							break;
-						case internal::SerializableMemberInfo::EncapType::ETYPE_STDLIST:
-							_serializeCheckNotEoo(&tempEtypeReal, &iterEncap, endOfEncap);
-							if (iterEncap == endOfEncap)
-							{
-								throw Serializable::UnavailableTypeException();
-							}
-							else {
-								switch (tempEtypeReal)
-								{
-								case internal::SerializableMemberInfo::EncapType::ETYPE_SMARTPOINTER:
-									tempEtypeReal = *(iterEncap++);
-									switch (tempEtypeReal)
-									{
-									case internal::SerializableMemberInfo::EncapType::ETYPE_SUBPAYLOAD:
-										if (iterEncap != endOfEncap)
-											throw Serializable::UnavailableTypeException();
-										{
-											std::list<JsCPPUtils::SmartPointer<Serializable> > *plist = ((std::list<JsCPPUtils::SmartPointer<Serializable> >*)(*iterMem)->_memberInfo.ptr);
-											plist->clear();
-											for(rapidjson::Value::ConstValueIterator iter = jsonValue.Begin(); iter != jsonValue.End(); iter++)
-											{
-												JsCPPUtils::SmartPointer<Serializable> obj = (*iterMem)->_memberInfo.createFactory->create();
-												readElementFromPayload(*iter, obj.getPtr());
-												plist->push_back(obj);
-											}
-										}
-										break;
-									default:
-										throw Serializable::UnavailableTypeException();
-									}
-									break;
-								case internal::SerializableMemberInfo::EncapType::ETYPE_STDVECTOR:
-									_serializeCheckEoo(&tempEtypeReal, &iterEncap, endOfEncap);
-									switch (tempEtypeReal & 0x00FF)
-									{
-									case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 1):
-										readStdListFromPayload(jsonValue, (std::list< std::vector<int8_t> >*)((*iterMem)->_memberInfo.ptr));
-										break;
-									case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 1):
-										readStdListFromPayload(jsonValue, (std::list< std::vector<uint8_t> >*)((*iterMem)->_memberInfo.ptr));
-										break;
-									case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 2):
-										readStdListFromPayload(jsonValue, (std::list< std::vector<int16_t> >*)((*iterMem)->_memberInfo.ptr));
-										break;
-									case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 2):
-										readStdListFromPayload(jsonValue, (std::list< std::vector<uint16_t> >*)((*iterMem)->_memberInfo.ptr));
-										break;
-									case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 4):
-										readStdListFromPayload(jsonValue, (std::list< std::vector<int32_t> >*)((*iterMem)->_memberInfo.ptr));
-										break;
-									case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 4):
-										readStdListFromPayload(jsonValue, (std::list< std::vector<uint32_t> >*)((*iterMem)->_memberInfo.ptr));
-										break;
-									case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 8):
-										readStdListFromPayload(jsonValue, (std::list< std::vector<int64_t> >*)((*iterMem)->_memberInfo.ptr));
-										break;
-									case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 8):
-										readStdListFromPayload(jsonValue, (std::list< std::vector<uint64_t> >*)((*iterMem)->_memberInfo.ptr));
-										break;
-									case (internal::SerializableMemberInfo::EncapType::ETYPE_CHAR):
-										readStdListFromPayload(jsonValue, (std::list< std::vector<char> >*)((*iterMem)->_memberInfo.ptr));
-										break;
-									case (internal::SerializableMemberInfo::EncapType::ETYPE_WCHAR):
-										readStdListFromPayload(jsonValue, (std::list< std::vector<wchar_t> >*)((*iterMem)->_memberInfo.ptr));
-										break;
-									default:
-										throw Serializable::UnavailableTypeException();
-									}
-									break;
-								case internal::SerializableMemberInfo::EncapType::ETYPE_STDBASICSTRING:
-									_serializeCheckEoo(&tempEtypeReal, &iterEncap, endOfEncap);
-									if (checkFlagsAll(tempEtypeReal, internal::SerializableMemberInfo::EncapType::ETYPE_CHAR))
-										readStdListFromPayload(jsonValue, (std::list< std::basic_string<char> > *)(*iterMem)->_memberInfo.ptr);
-									else if (checkFlagsAll(tempEtypeReal, internal::SerializableMemberInfo::EncapType::ETYPE_WCHAR))
-										readStdListFromPayload(jsonValue, (std::list<std::basic_string<wchar_t> >*)(*iterMem)->_memberInfo.ptr);
-									else
-										throw Serializable::UnavailableTypeException();
-								default:
-									throw Serializable::UnavailableTypeException();
-								}
-							}
-							break;
-						case internal::SerializableMemberInfo::EncapType::ETYPE_SUBPAYLOAD:
-							readElementFromPayload(jsonValue, (Serializable*)(*iterMem)->_memberInfo.ptr);
-							break;
 						case internal::SerializableMemberInfo::EncapType::ETYPE_SMARTPOINTER:
 							tempEtypeReal = *(iterEncap++);
-							if (tempEtypeReal & internal::SerializableMemberInfo::EncapType::ETYPE_NULL)
+							switch (tempEtypeReal)
 							{
-								(*iterMem)->setNull();
-							}
-							else {
-								switch (tempEtypeReal & 0xFF00)
+							case internal::SerializableMemberInfo::EncapType::ETYPE_SUBPAYLOAD:
+								if (iterEncap != endOfEncap)
+									throw Serializable::UnavailableTypeException();
 								{
-								case internal::SerializableMemberInfo::EncapType::ETYPE_SUBPAYLOAD:
-									if (!(tempEtypeReal & internal::SerializableMemberInfo::EncapType::ETYPE_NULL))
+									std::list<JsCPPUtils::SmartPointer<Serializable> > *plist = ((std::list<JsCPPUtils::SmartPointer<Serializable> >*)member->_memberInfo.ptr);
+									plist->clear();
+									for(rapidjson::Value::ConstValueIterator iter = jsonValue.Begin(); iter != jsonValue.End(); iter++)
 									{
-										JsCPPUtils::SmartPointer<Serializable> obj = (*iterMem)->_memberInfo.createFactory->create();
-										readElementFromPayload(jsonValue, (Serializable*)obj.getPtr());
+										JsCPPUtils::SmartPointer<Serializable> obj = member->_memberInfo.createFactory->create();
+										readElementFromPayload(*iter, obj.getPtr());
+										plist->push_back(obj);
 									}
-								default:
-									throw Serializable::UnavailableTypeException();
 								}
+								break;
+							default:
+								throw Serializable::UnavailableTypeException();
 							}
 							break;
-						case internal::SerializableMemberInfo::EncapType::ETYPE_NATIVEARRAY:
+						case internal::SerializableMemberInfo::EncapType::ETYPE_STDVECTOR:
+							_serializeCheckEoo(&tempEtypeReal, &iterEncap, endOfEncap);
 							switch (tempEtypeReal & 0x00FF)
 							{
-							case (internal::SerializableMemberInfo::EncapType::ETYPE_BOOL):
-								readElementArrayFromPayload(jsonValue, (int8_t*)((*iterMem)->_memberInfo.ptr), (*iterMem)->_memberInfo.length);
-								break;
 							case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 1):
-								readElementArrayFromPayload(jsonValue, (int8_t*)((*iterMem)->_memberInfo.ptr), (*iterMem)->_memberInfo.length);
+								readStdListFromPayload(jsonValue, (std::list< std::vector<int8_t> >*)(member->_memberInfo.ptr));
 								break;
 							case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 1):
-								readElementArrayFromPayload(jsonValue, (uint8_t*)((*iterMem)->_memberInfo.ptr), (*iterMem)->_memberInfo.length);
+								readStdListFromPayload(jsonValue, (std::list< std::vector<uint8_t> >*)(member->_memberInfo.ptr));
 								break;
 							case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 2):
-								readElementArrayFromPayload(jsonValue, (int16_t*)((*iterMem)->_memberInfo.ptr), (*iterMem)->_memberInfo.length);
+								readStdListFromPayload(jsonValue, (std::list< std::vector<int16_t> >*)(member->_memberInfo.ptr));
 								break;
 							case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 2):
-								readElementArrayFromPayload(jsonValue, (uint16_t*)((*iterMem)->_memberInfo.ptr), (*iterMem)->_memberInfo.length);
+								readStdListFromPayload(jsonValue, (std::list< std::vector<uint16_t> >*)(member->_memberInfo.ptr));
 								break;
 							case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 4):
-								readElementArrayFromPayload(jsonValue, (int32_t*)((*iterMem)->_memberInfo.ptr), (*iterMem)->_memberInfo.length);
+								readStdListFromPayload(jsonValue, (std::list< std::vector<int32_t> >*)(member->_memberInfo.ptr));
 								break;
 							case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 4):
-								readElementArrayFromPayload(jsonValue, (uint32_t*)((*iterMem)->_memberInfo.ptr), (*iterMem)->_memberInfo.length);
+								readStdListFromPayload(jsonValue, (std::list< std::vector<uint32_t> >*)(member->_memberInfo.ptr));
 								break;
 							case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 8):
-								readElementArrayFromPayload(jsonValue, (int64_t*)((*iterMem)->_memberInfo.ptr), (*iterMem)->_memberInfo.length);
+								readStdListFromPayload(jsonValue, (std::list< std::vector<int64_t> >*)(member->_memberInfo.ptr));
 								break;
 							case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 8):
-								readElementArrayFromPayload(jsonValue, (uint64_t*)((*iterMem)->_memberInfo.ptr), (*iterMem)->_memberInfo.length);
+								readStdListFromPayload(jsonValue, (std::list< std::vector<uint64_t> >*)(member->_memberInfo.ptr));
 								break;
 							case (internal::SerializableMemberInfo::EncapType::ETYPE_CHAR):
-								readElementArrayFromPayload(jsonValue, (char*)((*iterMem)->_memberInfo.ptr), (*iterMem)->_memberInfo.length);
+								readStdListFromPayload(jsonValue, (std::list< std::vector<char> >*)(member->_memberInfo.ptr));
 								break;
 							case (internal::SerializableMemberInfo::EncapType::ETYPE_WCHAR):
-								readElementArrayFromPayload(jsonValue, (wchar_t*)((*iterMem)->_memberInfo.ptr), (*iterMem)->_memberInfo.length);
-								break;
-							case (internal::SerializableMemberInfo::EncapType::ETYPE_FLOAT):
-								readElementArrayFromPayload(jsonValue, (float*)((*iterMem)->_memberInfo.ptr), (*iterMem)->_memberInfo.length);
+								readStdListFromPayload(jsonValue, (std::list< std::vector<wchar_t> >*)(member->_memberInfo.ptr));
 								break;
-							case (internal::SerializableMemberInfo::EncapType::ETYPE_DOUBLE):
-								readElementArrayFromPayload(jsonValue, (double*)((*iterMem)->_memberInfo.ptr), (*iterMem)->_memberInfo.length);
 							default:
 								throw Serializable::UnavailableTypeException();
 							}
 							break;
-						case internal::SerializableMemberInfo::EncapType::ETYPE_NULL:
-							(*iterMem)->setNull();
+						case internal::SerializableMemberInfo::EncapType::ETYPE_STDBASICSTRING:
+							_serializeCheckEoo(&tempEtypeReal, &iterEncap, endOfEncap);
+							if (((tempEtypeReal & internal::SerializableMemberInfo::EncapType::ETYPE_CHAR) == internal::SerializableMemberInfo::EncapType::ETYPE_CHAR))
+								readStdListFromPayload(jsonValue, (std::list< std::basic_string<char> > *)member->_memberInfo.ptr);
+							else if (((tempEtypeReal & internal::SerializableMemberInfo::EncapType::ETYPE_WCHAR) == internal::SerializableMemberInfo::EncapType::ETYPE_WCHAR))
+								readStdListFromPayload(jsonValue, (std::list<std::basic_string<wchar_t> >*)member->_memberInfo.ptr);
+							else
+								throw Serializable::UnavailableTypeException();
 							break;
 						default:
 							throw Serializable::UnavailableTypeException();
 						}
 					}
+					break;
+				case internal::SerializableMemberInfo::EncapType::ETYPE_SUBPAYLOAD:
+					readElementFromPayload(jsonValue, (Serializable*)member->_memberInfo.ptr);
+					break;
+				case internal::SerializableMemberInfo::EncapType::ETYPE_SMARTPOINTER:
+					tempEtypeReal = *(iterEncap++);
+					if (tempEtypeReal & internal::SerializableMemberInfo::EncapType::ETYPE_NULL)
+					{
+						member->setNull();
+					}
+					else {
+						switch (tempEtypeReal & 0xFF00)
+						{
+						case internal::SerializableMemberInfo::EncapType::ETYPE_SUBPAYLOAD:
+							if (!(tempEtypeReal & internal::SerializableMemberInfo::EncapType::ETYPE_NULL))
+							{
+								JsCPPUtils::SmartPointer<Serializable> obj = member->_memberInfo.createFactory->create();
+								readElementFromPayload(jsonValue, (Serializable*)obj.getPtr());
+							}
+						default:
+							throw Serializable::UnavailableTypeException();
+						}
+					}
+					break;
+				case internal::SerializableMemberInfo::EncapType::ETYPE_NULL:
+					member->setNull();
+					break;
+				default:
+					throw Serializable::UnavailableTypeException();
 				}
 			}
-			else {
+		}
+	}
+
+	void JSONObjectMapper::deserializeJsonObject(Serializable *serialiable, const rapidjson::Value &jsonObject) JSRPC_THROWS(JSONObjectMapper::TypeNotMatchException)
+	{
+		const std::list<internal::STypeCommon*> &members = serialiable->serializableMembers();
+
+		if (!jsonObject.IsObject())
+			throw TypeNotMatchException();
+
+		// Members missing from the JSON object end up null
+		for (std::list<internal::STypeCommon*>::const_iterator iterMem = members.begin(); iterMem != members.end(); iterMem++)
+		{
+			(*iterMem)->clear();
+			(*iterMem)->setNull();
+		}
+
+		// One pass over the JSON object, each key resolved through the class name table
+		for (rapidjson::Value::ConstMemberIterator iterJson = jsonObject.MemberBegin(); iterJson != jsonObject.MemberEnd(); iterJson++)
+		{
+			internal::STypeCommon *member = serialiable->serializableFindMember(iterJson->name.GetString(), iterJson->name.GetStringLength());
+			if (member)
+				readMemberFromJson(member, iterJson->value);
+		}
+	}
+
+	// Streaming input: SAX events are written straight into the members
+	struct JsonScalar
+	{
+		enum Kind {
+			SCALAR_BOOL,
+			SCALAR_NEGATIVE,
+			SCALAR_UNSIGNED,
+			SCALAR_DOUBLE,
+			SCALAR_STRING,
+		};
+		Kind kind;
+		bool b;
+		int64_t i;
+		uint64_t u;
+		double d;
+		const char *str;
+		rapidjson::SizeType length;
+	};
+
+	template <typename T>
+	static void storeInteger(const JsonScalar &value, T *data) {
+		if (value.kind == JsonScalar::SCALAR_NEGATIVE)
+		{
+			if (!std::numeric_limits<T>::is_signed)
+				throw JSONObjectMapper::TypeNotMatchException();
+			if (value.i < (int64_t)std::numeric_limits<T>::min())
+				throw JSONObjectMapper::DataOverrflowException();
+			*data = (T)value.i;
+		}
+		else if (value.kind == JsonScalar::SCALAR_UNSIGNED)
+		{
+			if (value.u > (uint64_t)std::numeric_limits<T>::max())
+				throw JSONObjectMapper::DataOverrflowException();
+			*data = (T)value.u;
+		}
+		else
+			throw JSONObjectMapper::TypeNotMatchException();
+	}
+	template <typename T>
+	static void storeFloating(const JsonScalar &value, T *data) {
+		if (value.kind == JsonScalar::SCALAR_DOUBLE)
+			*data = (T)value.d;
+		else if (value.kind == JsonScalar::SCALAR_NEGATIVE)
+			*data = (T)value.i;
+		else if (value.kind == JsonScalar::SCALAR_UNSIGNED)
+			*data = (T)value.u;
+		else
+			throw JSONObjectMapper::TypeNotMatchException();
+	}
+	static void storeScalar(const JsonScalar &value, bool *data) {
+		if (value.kind != JsonScalar::SCALAR_BOOL)
+			throw JSONObjectMapper::TypeNotMatchException();
+		*data = value.b;
+	}
+	static void storeScalar(const JsonScalar &value, char *data) {
+		if (value.kind != JsonScalar::SCALAR_STRING)
+			throw JSONObjectMapper::TypeNotMatchException();
+		*data = value.length ? value.str[0] : 0;
+	}
+	static void storeScalar(const JsonScalar &value, wchar_t *data) {
+		if (value.kind != JsonScalar::SCALAR_STRING)
+			throw JSONObjectMapper::TypeNotMatchException();
+		*data = internal::UTFTranscoder::firstFromUTF8<wchar_t>(value.str, value.length);
+	}
+	static void storeScalar(const JsonScalar &value, int8_t *data) { storeInteger(value, data); }
+	static void storeScalar(const JsonScalar &value, uint8_t *data) { storeInteger(value, data); }
+	static void storeScalar(const JsonScalar &value, int16_t *data) { storeInteger(value, data); }
+	static void storeScalar(const JsonScalar &value, uint16_t *data) { storeInteger(value, data); }
+	static void storeScalar(const JsonScalar &value, int32_t *data) { storeInteger(value, data); }
+	static void storeScalar(const JsonScalar &value, uint32_t *data) { storeInteger(value, data); }
+	static void storeScalar(const JsonScalar &value, int64_t *data) { storeInteger(value, data); }
+	static void storeScalar(const JsonScalar &value, uint64_t *data) { storeInteger(value, data); }
+	static void storeScalar(const JsonScalar &value, float *data) { storeFloating(value, data); }
+	static void storeScalar(const JsonScalar &value, double *data) { storeFloating(value, data); }
+	static void storeScalar(const JsonScalar &value, std::basic_string<char> *data) {
+		if (value.kind != JsonScalar::SCALAR_STRING)
+			throw JSONObjectMapper::TypeNotMatchException();
+		data->assign(value.str, value.length);
+	}
+	static void storeScalar(const JsonScalar &value, std::basic_string<wchar_t> *data) {
+		if (value.kind != JsonScalar::SCALAR_STRING)
+			throw JSONObjectMapper::TypeNotMatchException();
+		internal::UTFTranscoder::assignFromUTF8(*data, value.str, value.length);
+	}
+	template <typename T>
+	static void appendScalar(const JsonScalar &value, std::vector<T> *data) {
+		T element;
+		storeScalar(value, &element);
+		data->push_back(element);
+	}
+
+	// etype is a native element type; index is the position inside a native array
+	static void storeScalarAt(uint16_t etype, void *ptr, size_t index, const JsonScalar &value)
+	{
+		switch (etype & 0x00FF)
+		{
+			case (internal::SerializableMemberInfo::EncapType::ETYPE_BOOL):
+				storeScalar(value, (bool*)ptr + index);
+				break;
+			case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 1):
+				storeScalar(value, (int8_t*)ptr + index);
+				break;
+			case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 1):
+				storeScalar(value, (uint8_t*)ptr + index);
+				break;
+			case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 2):
+				storeScalar(value, (int16_t*)ptr + index);
+				break;
+			case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 2):
+				storeScalar(value, (uint16_t*)ptr + index);
+				break;
+			case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 4):
+				storeScalar(value, (int32_t*)ptr + index);
+				break;
+			case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 4):
+				storeScalar(value, (uint32_t*)ptr + index);
+				break;
+			case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 8):
+				storeScalar(value, (int64_t*)ptr + index);
+				break;
+			case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 8):
+				storeScalar(value, (uint64_t*)ptr + index);
+				break;
+			case (internal::SerializableMemberInfo::EncapType::ETYPE_CHAR):
+				storeScalar(value, (char*)ptr + index);
+				break;
+			case (internal::SerializableMemberInfo::EncapType::ETYPE_WCHAR):
+				storeScalar(value, (wchar_t*)ptr + index);
+				break;
+			case (internal::SerializableMemberInfo::EncapType::ETYPE_FLOAT):
+				storeScalar(value, (float*)ptr + index);
+				break;
+			case (internal::SerializableMemberInfo::EncapType::ETYPE_DOUBLE):
+				storeScalar(value, (double*)ptr + index);
+				break;
+			default:
+				throw Serializable::UnavailableTypeException();
+		}
+	}
+	static void appendScalarTo(uint16_t etype, void *ptr, const JsonScalar &value)
+	{
+		switch (etype & 0x00FF)
+		{
+			case (internal::SerializableMemberInfo::EncapType::ETYPE_BOOL):
+				appendScalar(value, (std::vector<bool>*)ptr);
+				break;
+			case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 1):
+				appendScalar(value, (std::vector<int8_t>*)ptr);
+				break;
+			case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 1):
+				appendScalar(value, (std::vector<uint8_t>*)ptr);
+				break;
+			case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 2):
+				appendScalar(value, (std::vector<int16_t>*)ptr);
+				break;
+			case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 2):
+				appendScalar(value, (std::vector<uint16_t>*)ptr);
+				break;
+			case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 4):
+				appendScalar(value, (std::vector<int32_t>*)ptr);
+				break;
+			case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 4):
+				appendScalar(value, (std::vector<uint32_t>*)ptr);
+				break;
+			case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 8):
+				appendScalar(value, (std::vector<int64_t>*)ptr);
+				break;
+			case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 8):
+				appendScalar(value, (std::vector<uint64_t>*)ptr);
+				break;
+			case (internal::SerializableMemberInfo::EncapType::ETYPE_CHAR):
+				appendScalar(value, (std::vector<char>*)ptr);
+				break;
+			case (internal::SerializableMemberInfo::EncapType::ETYPE_WCHAR):
+				appendScalar(value, (std::vector<wchar_t>*)ptr);
+				break;
+			case (internal::SerializableMemberInfo::EncapType::ETYPE_FLOAT):
+				appendScalar(value, (std::vector<float>*)ptr);
+				break;
+			case (internal::SerializableMemberInfo::EncapType::ETYPE_DOUBLE):
+				appendScalar(value, (std::vector<double>*)ptr);
+				break;
+			default:
+				throw Serializable::UnavailableTypeException();
+		}
+	}
+
+	class JSONSaxDecoder
+	{
+	private:
+		enum FrameKind {
+			FRAME_OBJECT,
+			FRAME_NATIVEARRAY,
+			FRAME_VECTOR,
+			FRAME_LIST_STRING,
+			FRAME_LIST_VECTOR,
+			FRAME_LIST_OBJECT,
+			FRAME_SKIP,
+		};
+		enum ErrorKind {
+			ERROR_NONE,
+			ERROR_TYPENOTMATCH,
+			ERROR_DATAOVERFLOW,
+			ERROR_UNAVAILABLETYPE,
+		};
+		enum EventKind {
+			EVENT_SCALAR,
+			EVENT_NULL,
+			EVENT_START_OBJECT,
+			EVENT_START_ARRAY,
+		};
+		struct Frame {
+			FrameKind kind;
+			Serializable *object;
+			// FRAME_OBJECT: member the next value belongs to (NULL: unknown key)
+			internal::STypeCommon *member;
+			// Element type and the container being filled
+			uint16_t etype;
+			void *target;
+			size_t index;
+			size_t depth;
+		};
+
+		Serializable *m_root;
+		std::vector<Frame> m_stack;
+		ErrorKind m_error;
+
+	public:
+		explicit JSONSaxDecoder(Serializable *root) :
+			m_root(root), m_error(ERROR_NONE)
+		{
+		}
+
+		// Keeps the frame stack storage for the next document
+		void reset(Serializable *root)
+		{
+			m_root = root;
+			m_stack.clear();
+			m_error = ERROR_NONE;
+		}
+
+		void throwIfFailed() const
+		{
+			switch (m_error)
+			{
+			case ERROR_TYPENOTMATCH:
+				throw JSONObjectMapper::TypeNotMatchException();
+			case ERROR_DATAOVERFLOW:
+				throw JSONObjectMapper::DataOverrflowException();
+			case ERROR_UNAVAILABLETYPE:
+				throw Serializable::UnavailableTypeException();
+			default:
+				break;
+			}
+		}
+
+		bool Null() { return event(EVENT_NULL, NULL); }
+		bool Bool(bool b) {
+			JsonScalar value;
+			value.kind = JsonScalar::SCALAR_BOOL;
+			value.b = b;
+			return event(EVENT_SCALAR, &value);
+		}
+		bool Int(int i) { return Int64(i); }
+		bool Uint(unsigned u) { return Uint64(u); }
+		bool Int64(int64_t i) {
+			JsonScalar value;
+			if (i >= 0)
+				return Uint64((uint64_t)i);
+			value.kind = JsonScalar::SCALAR_NEGATIVE;
+			value.i = i;
+			return event(EVENT_SCALAR, &value);
+		}
+		bool Uint64(uint64_t u) {
+			JsonScalar value;
+			value.kind = JsonScalar::SCALAR_UNSIGNED;
+			value.u = u;
+			return event(EVENT_SCALAR, &value);
+		}
+		bool Double(double d) {
+			JsonScalar value;
+			value.kind = JsonScalar::SCALAR_DOUBLE;
+			value.d = d;
+			return event(EVENT_SCALAR, &value);
+		}
+		bool RawNumber(const char *str, rapidjson::SizeType length, bool copy) {
+			return false;
+		}
+		bool String(const char *str, rapidjson::SizeType length, bool copy) {
+			JsonScalar value;
+			value.kind = JsonScalar::SCALAR_STRING;
+			value.str = str;
+			value.length = length;
+			return event(EVENT_SCALAR, &value);
+		}
+		bool StartObject() { return event(EVENT_START_OBJECT, NULL); }
+		bool StartArray() { return event(EVENT_START_ARRAY, NULL); }
+		bool Key(const char *str, rapidjson::SizeType length, bool copy) {
+			Frame &frame = m_stack.back();
+			if (frame.kind == FRAME_SKIP)
+				return true;
+			frame.member = frame.object->serializableFindMember(str, length);
+			return true;
+		}
+		bool EndObject(rapidjson::SizeType memberCount) {
+			return endContainer();
+		}
+		bool EndArray(rapidjson::SizeType elementCount) {
+			return endContainer();
+		}
+
+	private:
+		bool event(EventKind kind, const JsonScalar *value)
+		{
+			try {
+				if (m_stack.empty())
+				{
+					if (kind != EVENT_START_OBJECT)
+						throw JSONObjectMapper::TypeNotMatchException();
+					pushObject(m_root);
+				}
+				else
+				{
+					Frame &frame = m_stack.back();
+					switch (frame.kind)
+					{
+					case FRAME_OBJECT:
+						if (frame.member)
+							memberValue(frame.member, kind, value);
+						else
+							skipValue(kind);
+						break;
+					case FRAME_NATIVEARRAY:
+						if (kind != EVENT_SCALAR)
+							throw JSONObjectMapper::TypeNotMatchException();
+						if (frame.index >= (size_t)frame.member->_memberInfo.length)
+							throw JSONObjectMapper::TypeNotMatchException();
+						storeScalarAt(frame.etype, frame.target, frame.index++, *value);
+						break;
+					case FRAME_VECTOR:
+						if (kind != EVENT_SCALAR)
+							throw JSONObjectMapper::TypeNotMatchException();
+						appendScalarTo(frame.etype, frame.target, *value);
+						break;
+					case FRAME_LIST_STRING:
+						if (kind != EVENT_SCALAR)
+							throw JSONObjectMapper::TypeNotMatchException();
+						if (checkFlagsAll(frame.etype, internal::SerializableMemberInfo::EncapType::ETYPE_CHAR))
+						{
+							std::list< std::basic_string<char> > *plist = (std::list< std::basic_string<char> >*)frame.target;
+							plist->push_back(std::basic_string<char>());
+							storeScalar(*value, &plist->back());
+						}
+						else
+						{
+							std::list< std::basic_string<wchar_t> > *plist = (std::list< std::basic_string<wchar_t> >*)frame.target;
+							plist->push_back(std::basic_string<wchar_t>());
+							storeScalar(*value, &plist->back());
+						}
+						break;
+					case FRAME_LIST_VECTOR:
+						if (kind != EVENT_START_ARRAY)
+							throw JSONObjectMapper::TypeNotMatchException();
+						pushListVectorElement(frame.etype, frame.target);
+						break;
+					case FRAME_LIST_OBJECT:
+						if (kind == EVENT_NULL)
+						{
+							((std::list< JsCPPUtils::SmartPointer<Serializable> >*)frame.target)->push_back(JsCPPUtils::SmartPointer<Serializable>());
+						}
+						else
+						{
+							if (kind != EVENT_START_OBJECT)
+								throw JSONObjectMapper::TypeNotMatchException();
+							if (!frame.member->_memberInfo.createFactory)
+								throw Serializable::UnavailableTypeException();
+							JsCPPUtils::SmartPointer<Serializable> obj = frame.member->_memberInfo.createFactory->create();
+							((std::list< JsCPPUtils::SmartPointer<Serializable> >*)frame.target)->push_back(obj);
+							pushObject(obj.getPtr());
+						}
+						break;
+					case FRAME_SKIP:
+						if ((kind == EVENT_START_OBJECT) || (kind == EVENT_START_ARRAY))
+							frame.depth++;
+						break;
+					}
+				}
+			} catch (JSONObjectMapper::TypeNotMatchException &) {
+				m_error = ERROR_TYPENOTMATCH;
+			} catch (JSONObjectMapper::DataOverrflowException &) {
+				m_error = ERROR_DATAOVERFLOW;
+			} catch (Serializable::UnavailableTypeException &) {
+				m_error = ERROR_UNAVAILABLETYPE;
+			}
+			return m_error == ERROR_NONE;
+		}
+
+		bool endContainer()
+		{
+			Frame &frame = m_stack.back();
+			if ((frame.kind == FRAME_SKIP) && (--frame.depth > 0))
+				return true;
+			if ((frame.kind == FRAME_NATIVEARRAY) && (frame.index != (size_t)frame.member->_memberInfo.length))
+			{
+				m_error = ERROR_TYPENOTMATCH;
+				return false;
+			}
+			m_stack.pop_back();
+			return true;
+		}
+
+		void pushFrame(FrameKind kind, Serializable *object, internal::STypeCommon *member, uint16_t etype, void *target)
+		{
+			Frame frame;
+			frame.kind = kind;
+			frame.object = object;
+			frame.member = member;
+			frame.etype = etype;
+			frame.target = target;
+			frame.index = 0;
+			frame.depth = 1;
+			m_stack.push_back(frame);
+		}
+
+		void pushObject(Serializable *object)
+		{
+			// Members missing from the JSON object end up null
+			const std::list<internal::STypeCommon*> &members = object->serializableMembers();
+			for (std::list<internal::STypeCommon*>::const_iterator iterMem = members.begin(); iterMem != members.end(); iterMem++)
+			{
+				(*iterMem)->clear();
 				(*iterMem)->setNull();
 			}
+			pushFrame(FRAME_OBJECT, object, NULL, 0, NULL);
+		}
+
+		void skipValue(EventKind kind)
+		{
+			if ((kind == EVENT_START_OBJECT) || (kind == EVENT_START_ARRAY))
+				pushFrame(FRAME_SKIP, NULL, NULL, 0, NULL);
+		}
+
+		void pushListVectorElement(uint16_t etype, void *target)
+		{
+			void *element;
+			switch (etype & 0x00FF)
+			{
+			case (internal::SerializableMemberInfo::EncapType::ETYPE_BOOL):
+				((std::list< std::vector<bool> >*)target)->push_back(std::vector<bool>());
+				element = &((std::list< std::vector<bool> >*)target)->back();
+				break;
+			case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 1):
+				((std::list< std::vector<int8_t> >*)target)->push_back(std::vector<int8_t>());
+				element = &((std::list< std::vector<int8_t> >*)target)->back();
+				break;
+			case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 1):
+				((std::list< std::vector<uint8_t> >*)target)->push_back(std::vector<uint8_t>());
+				element = &((std::list< std::vector<uint8_t> >*)target)->back();
+				break;
+			case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 2):
+				((std::list< std::vector<int16_t> >*)target)->push_back(std::vector<int16_t>());
+				element = &((std::list< std::vector<int16_t> >*)target)->back();
+				break;
+			case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 2):
+				((std::list< std::vector<uint16_t> >*)target)->push_back(std::vector<uint16_t>());
+				element = &((std::list< std::vector<uint16_t> >*)target)->back();
+				break;
+			case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 4):
+				((std::list< std::vector<int32_t> >*)target)->push_back(std::vector<int32_t>());
+				element = &((std::list< std::vector<int32_t> >*)target)->back();
+				break;
+			case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 4):
+				((std::list< std::vector<uint32_t> >*)target)->push_back(std::vector<uint32_t>());
+				element = &((std::list< std::vector<uint32_t> >*)target)->back();
+				break;
+			case (internal::SerializableMemberInfo::EncapType::ETYPE_SINT | 8):
+				((std::list< std::vector<int64_t> >*)target)->push_back(std::vector<int64_t>());
+				element = &((std::list< std::vector<int64_t> >*)target)->back();
+				break;
+			case (internal::SerializableMemberInfo::EncapType::ETYPE_UINT | 8):
+				((std::list< std::vector<uint64_t> >*)target)->push_back(std::vector<uint64_t>());
+				element = &((std::list< std::vector<uint64_t> >*)target)->back();
+				break;
+			case (internal::SerializableMemberInfo::EncapType::ETYPE_CHAR):
+				((std::list< std::vector<char> >*)target)->push_back(std::vector<char>());
+				element = &((std::list< std::vector<char> >*)target)->back();
+				break;
+			case (internal::SerializableMemberInfo::EncapType::ETYPE_WCHAR):
+				((std::list< std::vector<wchar_t> >*)target)->push_back(std::vector<wchar_t>());
+				element = &((std::list< std::vector<wchar_t> >*)target)->back();
+				break;
+			case (internal::SerializableMemberInfo::EncapType::ETYPE_FLOAT):
+				((std::list< std::vector<float> >*)target)->push_back(std::vector<float>());
+				element = &((std::list< std::vector<float> >*)target)->back();
+				break;
+			case (internal::SerializableMemberInfo::EncapType::ETYPE_DOUBLE):
+				((std::list< std::vector<double> >*)target)->push_back(std::vector<double>());
+				element = &((std::list< std::vector<double> >*)target)->back();
+				break;
+			default:
+				throw Serializable::UnavailableTypeException();
+			}
+			pushFrame(FRAME_VECTOR, NULL, NULL, etype, element);
+		}
+
+		void memberValue(internal::STypeCommon *member, EventKind kind, const JsonScalar *value)
+		{
+			std::list<internal::SerializableMemberInfo::EncapType>::const_iterator iterEncap = member->_memberInfo.encaps.begin();
+			std::list<internal::SerializableMemberInfo::EncapType>::const_iterator endOfEncap = member->_memberInfo.encaps.end();
+			uint16_t tempEtypeReal;
+			void *ptr = member->_memberInfo.ptr;
+
+			_serializeCheckNotEoo(&tempEtypeReal, &iterEncap, endOfEncap);
+			if (kind == EVENT_NULL)
+			{
+				member->setNull();
+				return;
+			}
+			member->setNull(false);
+
+			if ((tempEtypeReal & 0xFF00) == internal::SerializableMemberInfo::EncapType::ETYPE_NATIVE)
+			{
+				if (kind != EVENT_SCALAR)
+					throw JSONObjectMapper::TypeNotMatchException();
+				storeScalarAt(tempEtypeReal, ptr, 0, *value);
+				return;
+			}
+			if ((tempEtypeReal & 0xFF00) == internal::SerializableMemberInfo::EncapType::ETYPE_NATIVEARRAY)
+			{
+				if (kind != EVENT_START_ARRAY)
+					throw JSONObjectMapper::TypeNotMatchException();
+				pushFrame(FRAME_NATIVEARRAY, NULL, member, tempEtypeReal, ptr);
+				return;
+			}
+			switch (tempEtypeReal)
+			{
+			case internal::SerializableMemberInfo::EncapType::ETYPE_STDBASICSTRING:
+				_serializeCheckEoo(&tempEtypeReal, &iterEncap, endOfEncap);
+				if (kind != EVENT_SCALAR)
+					throw JSONObjectMapper::TypeNotMatchException();
+				if (checkFlagsAll(tempEtypeReal, internal::SerializableMemberInfo::EncapType::ETYPE_CHAR))
+					storeScalar(*value, (std::basic_string<char>*)ptr);
+				else if (checkFlagsAll(tempEtypeReal, internal::SerializableMemberInfo::EncapType::ETYPE_WCHAR))
+					storeScalar(*value, (std::basic_string<wchar_t>*)ptr);
+				else
+					throw Serializable::UnavailableTypeException();
+				break;
+			case internal::SerializableMemberInfo::EncapType::ETYPE_STDVECTOR:
+				_serializeCheckEoo(&tempEtypeReal, &iterEncap, endOfEncap);
+				if (kind != EVENT_START_ARRAY)
+					throw JSONObjectMapper::TypeNotMatchException();
+				pushFrame(FRAME_VECTOR, NULL, member, tempEtypeReal, ptr);
+				break;
+			case internal::SerializableMemberInfo::EncapType::ETYPE_STDLIST:
+				_serializeCheckNotEoo(&tempEtypeReal, &iterEncap, endOfEncap);
+				if (iterEncap == endOfEncap)
+					throw Serializable::UnavailableTypeException();
+				if (kind != EVENT_START_ARRAY)
+					throw JSONObjectMapper::TypeNotMatchException();
+				switch (tempEtypeReal)
+				{
+				case internal::SerializableMemberInfo::EncapType::ETYPE_SMARTPOINTER:
+					_serializeCheckEoo(&tempEtypeReal, &iterEncap, endOfEncap);
+					if (tempEtypeReal != internal::SerializableMemberInfo::EncapType::ETYPE_SUBPAYLOAD)
+						throw Serializable::UnavailableTypeException();
+					pushFrame(FRAME_LIST_OBJECT, NULL, member, tempEtypeReal, ptr);
+					break;
+				case internal::SerializableMemberInfo::EncapType::ETYPE_STDVECTOR:
+					_serializeCheckEoo(&tempEtypeReal, &iterEncap, endOfEncap);
+					pushFrame(FRAME_LIST_VECTOR, NULL, member, tempEtypeReal, ptr);
+					break;
+				case internal::SerializableMemberInfo::EncapType::ETYPE_STDBASICSTRING:
+					_serializeCheckEoo(&tempEtypeReal, &iterEncap, endOfEncap);
+					if (!checkFlagsAll(tempEtypeReal, internal::SerializableMemberInfo::EncapType::ETYPE_CHAR) && !checkFlagsAll(tempEtypeReal, internal::SerializableMemberInfo::EncapType::ETYPE_WCHAR))
+						throw Serializable::UnavailableTypeException();
+					pushFrame(FRAME_LIST_STRING, NULL, member, tempEtypeReal, ptr);
+					break;
+				default:
+					throw Serializable::UnavailableTypeException();
+				}
+				break;
+			case internal::SerializableMemberInfo::EncapType::ETYPE_SUBPAYLOAD:
+				if (kind != EVENT_START_OBJECT)
+					throw JSONObjectMapper::TypeNotMatchException();
+				pushObject((Serializable*)ptr);
+				break;
+			case internal::SerializableMemberInfo::EncapType::ETYPE_SMARTPOINTER:
+				_serializeCheckEoo(&tempEtypeReal, &iterEncap, endOfEncap);
+				if (tempEtypeReal != internal::SerializableMemberInfo::EncapType::ETYPE_SUBPAYLOAD)
+					throw Serializable::UnavailableTypeException();
+				if (kind != EVENT_START_OBJECT)
+					throw JSONObjectMapper::TypeNotMatchException();
+				if (!member->_memberInfo.createFactory)
+					throw Serializable::UnavailableTypeException();
+				{
+					JsCPPUtils::SmartPointer<Serializable> obj = member->_memberInfo.createFactory->create();
+					*(JsCPPUtils::SmartPointer<Serializable>*)ptr = obj;
+					pushObject(obj.getPtr());
+				}
+				break;
+			default:
+				throw Serializable::UnavailableTypeException();
+			}
+		}
+
+		static bool checkFlagsAll(int value, int type)
+		{
+			return (value & type) == type;
+		}
+	};
+
+	std::string JSONObjectMapper::serialize(const Serializable *serialiable)
+	{
+		return JSONMapperContext::current().serialize(serialiable);
+	}
+
+	void JSONObjectMapper::deserialize(Serializable *serialiable, const std::string &json) JSRPC_THROWS(TypeNotMatchException, DataOverrflowException, ParseException, Serializable::UnavailableTypeException)
+	{
+		JSONMapperContext::current().deserialize(serialiable, json);
+	}
+
+	void JSONObjectMapper::deserializeInsitu(Serializable *serialiable, char *json) JSRPC_THROWS(TypeNotMatchException, DataOverrflowException, ParseException, Serializable::UnavailableTypeException)
+	{
+		JSONMapperContext::current().deserializeInsitu(serialiable, json);
+	}
+
+	class JSONMapperContextBusy
+	{
+	private:
+		bool &m_busy;
+
+	public:
+		explicit JSONMapperContextBusy(bool &busy) : m_busy(busy) { m_busy = true; }
+		~JSONMapperContextBusy() { m_busy = false; }
+	};
+
+	JSONMapperContext::JSONMapperContext(size_t chunkSize) :
+		m_writer(m_buffer),
+		m_decoder(new JSONSaxDecoder(NULL)),
+		m_chunk(chunkSize),
+		m_allocator(&m_chunk[0], m_chunk.size()),
+		m_document(&m_allocator),
+		m_busy(false)
+	{
+	}
+
+	JSONMapperContext::~JSONMapperContext()
+	{
+		delete m_decoder;
+	}
+
+	JSONMapperContext &JSONMapperContext::current()
+	{
+		static thread_local JSONMapperContext context;
+		return context;
+	}
+
+	std::string JSONMapperContext::serialize(const Serializable *serialiable)
+	{
+		std::string json;
+		serialize(serialiable, json);
+		return json;
+	}
+
+	void JSONMapperContext::serialize(const Serializable *serialiable, std::string &json)
+	{
+		if (m_busy)
+		{
+			JSONMapperContext nested;
+			nested.serialize(serialiable, json);
+			return;
+		}
+		JSONMapperContextBusy busy(m_busy);
+		m_buffer.Clear();
+		m_writer.Reset(m_buffer);
+		JSONObjectMapper::serializeTo(serialiable, m_writer);
+		json.assign(m_buffer.GetString(), m_buffer.GetSize());
+	}
+
+	void JSONMapperContext::deserialize(Serializable *serialiable, const std::string &json) JSRPC_THROWS(JSONObjectMapper::TypeNotMatchException, JSONObjectMapper::DataOverrflowException, JSONObjectMapper::ParseException, Serializable::UnavailableTypeException)
+	{
+		if (m_busy)
+		{
+			JSONMapperContext nested;
+			nested.deserialize(serialiable, json);
+			return;
+		}
+		JSONMapperContextBusy busy(m_busy);
+		// Bounded by length, so an embedded NUL is a parse error rather than the end
+		rapidjson::MemoryStream memoryStream(json.data(), json.length());
+		rapidjson::EncodedInputStream<rapidjson::UTF8<>, rapidjson::MemoryStream> jsonStream(memoryStream);
+		m_decoder->reset(serialiable);
+		if (m_reader.Parse(jsonStream, *m_decoder).IsError())
+		{
+			m_decoder->throwIfFailed();
+			throw JSONObjectMapper::ParseException();
+		}
+	}
+
+	void JSONMapperContext::deserializeInsitu(Serializable *serialiable, char *json) JSRPC_THROWS(JSONObjectMapper::TypeNotMatchException, JSONObjectMapper::DataOverrflowException, JSONObjectMapper::ParseException, Serializable::UnavailableTypeException)
+	{
+		if (m_busy)
+		{
+			JSONMapperContext nested;
+			nested.deserializeInsitu(serialiable, json);
+			return;
+		}
+		JSONMapperContextBusy busy(m_busy);
+		rapidjson::InsituStringStream jsonStream(json);
+		m_decoder->reset(serialiable);
+		if (m_reader.Parse<rapidjson::kParseInsituFlag>(jsonStream, *m_decoder).IsError())
+		{
+			m_decoder->throwIfFailed();
+			throw JSONObjectMapper::ParseException();
+		}
+	}
+
+	rapidjson::Document &JSONMapperContext::document() JSRPC_THROWS(JSONMapperContext::ContextBusyException)
+	{
+		typedef rapidjson::Document::AllocatorType AllocatorType;
+		size_t capacity;
+		if (m_busy)
+			throw ContextBusyException();
+		// Pool allocator frees nothing per value, so dropping the tree first is safe
+		m_document.SetNull();
+		capacity = m_allocator.Capacity();
+		if (capacity > m_chunk.size())
+		{
+			// Clear() would hand back the chunks grown past m_chunk. Grow m_chunk
+			// to the whole pool instead, so a document of the same size again
+			// allocates nothing. m_document keeps pointing at m_allocator.
+			std::vector<char> chunk(capacity);
+			m_allocator.~AllocatorType();
+			m_chunk.swap(chunk);
+			new (&m_allocator) AllocatorType(&m_chunk[0], m_chunk.size());
+		}
+		else
+		{
+			m_allocator.Clear();
 		}
+		return m_document;
 	}
 }
 
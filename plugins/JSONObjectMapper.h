@@ -29,13 +29,18 @@
 
 #if defined(HAS_RAPIDJSON) && HAS_RAPIDJSON
 #include <rapidjson/document.h>
+#include <rapidjson/reader.h>
 #include <rapidjson/stringbuffer.h>
 #include <rapidjson/writer.h>
 #endif
 
 #include <string>
+#include <vector>
 
 namespace JsRPC {
+#if defined(HAS_RAPIDJSON) && HAS_RAPIDJSON
+	class JSONSaxDecoder;
+#endif
 
 	class JSONObjectMapper
 	{
@@ -44,26 +49,33 @@ namespace JsRPC {
 		{ };
 		class DataOverrflowException : public std::exception
 		{ };
+		class ParseException : public std::exception
+		{ };
 
 #if defined(HAS_RAPIDJSON) && HAS_RAPIDJSON
 		static void serializeTo(const Serializable *serialiable, rapidjson::Document &jsonDoc);
-		static void deserializeJsonObject(Serializable *serialiable, const rapidjson::Value &jsonObject);
+		// Builds the object into jsonObject using the allocator of the enclosing document
+		static void serializeToValue(const Serializable *serialiable, rapidjson::Value &jsonObject, rapidjson::Document::AllocatorType &jsonAllocator);
+		// Writes the object straight to jsonWriter without building a DOM
+		static void serializeTo(const Serializable *serialiable, rapidjson::Writer<rapidjson::StringBuffer> &jsonWriter);
+		// Every deserialize function first clears each member and sets it null, as
+		// the DOM decoder always has: a member missing from the JSON object ends
+		// up null, not with the value it held before.
+		static void deserializeJsonObject(Serializable *serialiable, const rapidjson::Value &jsonObject) JSRPC_THROWS(TypeNotMatchException);
 
-		static std::string serialize(const Serializable *serialiable)
-		{
-			rapidjson::Document jsonDoc;
-			rapidjson::StringBuffer jsonBuf;
-			rapidjson::Writer<rapidjson::StringBuffer> jsonWriter(jsonBuf);
-			serializeTo(serialiable, jsonDoc);
-			jsonDoc.Accept(jsonWriter);
-			return std::string(jsonBuf.GetString(), jsonBuf.GetLength());
-		}
+		// serialize/deserialize(Insitu) run on JSONMapperContext::current()
+		static std::string serialize(const Serializable *serialiable);
 
-		static void deserialize(Serializable *serialiable, const std::string &json)
+		// Single pass over the text; members are filled as the tokens are read
+		static void deserialize(Serializable *serialiable, const std::string &json) JSRPC_THROWS(TypeNotMatchException, DataOverrflowException, ParseException, Serializable::UnavailableTypeException);
+		// Same as deserialize, but strings are unescaped in place inside json.
+		// json must be null-terminated and is left unusable afterwards.
+		static void deserializeInsitu(Serializable *serialiable, char *json) JSRPC_THROWS(TypeNotMatchException, DataOverrflowException, ParseException, Serializable::UnavailableTypeException);
+		static void deserializeInsitu(Serializable *serialiable, std::vector<char> &json) JSRPC_THROWS(TypeNotMatchException, DataOverrflowException, ParseException, Serializable::UnavailableTypeException)
 		{
-			rapidjson::Document jsonDoc;
-			jsonDoc.Parse(json.c_str(), json.length());
-			deserializeJsonObject(serialiable, jsonDoc);
+			if (json.empty() || json.back() != 0)
+				json.push_back(0);
+			deserializeInsitu(serialiable, &json[0]);
 		}
 
 	private:
@@ -74,4 +86,50 @@ namespace JsRPC {
 #endif
 	};
 
+#if defined(HAS_RAPIDJSON) && HAS_RAPIDJSON
+	// Output buffer, writer, reader, decoder stack and a DOM allocator pool kept
+	// between calls. A context is not thread-safe; use current() for the
+	// calling thread's one or keep one per worker.
+	class JSONMapperContext
+	{
+	public:
+		enum {
+			DEFAULT_CHUNK_SIZE = 64 * 1024
+		};
+
+		class ContextBusyException : public std::exception
+		{ };
+
+		explicit JSONMapperContext(size_t chunkSize = DEFAULT_CHUNK_SIZE);
+		~JSONMapperContext();
+
+		static JSONMapperContext &current();
+
+		std::string serialize(const Serializable *serialiable);
+		void serialize(const Serializable *serialiable, std::string &json);
+		void deserialize(Serializable *serialiable, const std::string &json) JSRPC_THROWS(JSONObjectMapper::TypeNotMatchException, JSONObjectMapper::DataOverrflowException, JSONObjectMapper::ParseException, Serializable::UnavailableTypeException);
+		void deserializeInsitu(Serializable *serialiable, char *json) JSRPC_THROWS(JSONObjectMapper::TypeNotMatchException, JSONObjectMapper::DataOverrflowException, JSONObjectMapper::ParseException, Serializable::UnavailableTypeException);
+
+		// Empty document on the pooled allocator. Values taken from an earlier
+		// call are invalidated. The pool keeps what earlier documents grew to.
+		// Throws while a call on this context is running, since the document
+		// that call may be using cannot be swapped for a temporary one.
+		rapidjson::Document &document() JSRPC_THROWS(ContextBusyException);
+
+	private:
+		JSONMapperContext(const JSONMapperContext &obj);
+		JSONMapperContext &operator=(const JSONMapperContext &obj);
+
+		rapidjson::StringBuffer m_buffer;
+		rapidjson::Writer<rapidjson::StringBuffer> m_writer;
+		rapidjson::Reader m_reader;
+		JSONSaxDecoder *m_decoder;
+		std::vector<char> m_chunk;
+		rapidjson::Document::AllocatorType m_allocator;
+		rapidjson::Document m_document;
+		// Set while a call is running; re-entrant calls get a temporary context
+		bool m_busy;
+	};
+#endif
+
 }
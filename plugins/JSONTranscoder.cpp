@@ -0,0 +1,1189 @@
+/*
+* Licensed to the Apache Software Foundation (ASF) under one or more
+* contributor license agreements.  See the NOTICE file distributed with
+* this work for additional information regarding copyright ownership.
+* The ASF licenses this file to You under the Apache License, Version 2.0
+* (the "License"); you may not use this file except in compliance with
+* the License.  You may obtain a copy of the License at
+*
+*    http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+/**
+ * @file	JSONTranscoder.cpp
+ * @author	Jichan (development@jc-lab.net / http://ablog.jc-lab.net/ )
+ * @date	2026/10/18
+ * @copyright Copyright (C) 2026 jichan.\n
+ *            This software may be modified and distributed under the terms
+ *            of the Apache License 2.0.  See the LICENSE file for details.
+ */
+
+#include "JSONTranscoder.h"
+
+#if defined(HAS_RAPIDJSON) && HAS_RAPIDJSON
+
+#include "UTFTranscoder.h"
+
+#include <rapidjson/reader.h>
+#include <rapidjson/memorystream.h>
+#include <rapidjson/encodedstream.h>
+
+#include <limits>
+
+namespace JsRPC {
+
+	typedef internal::SerializableMemberInfo::EncapType EncapType;
+
+	SerializableSchema::SerializableSchema(const Serializable &prototype) :
+		m_name(prototype.serializableGetName()),
+		m_serialVersionUID(prototype.serializableGetSerialVersionUID())
+	{
+		const std::list<internal::STypeCommon*> &members = prototype.serializableMembers();
+		std::vector<std::string> names;
+		for (std::list<internal::STypeCommon*>::const_iterator iterMem = members.begin(); iterMem != members.end(); iterMem++)
+		{
+			const internal::SerializableMemberInfo &info = (*iterMem)->_memberInfo;
+			Member member;
+			rapidjson::StringBuffer jsonBuf;
+			rapidjson::Writer<rapidjson::StringBuffer> jsonWriter(jsonBuf);
+
+			member.name = info.name;
+			jsonWriter.String(info.name.c_str(), info.name.length());
+			member.quotedName.assign(jsonBuf.GetString(), jsonBuf.GetSize());
+			for (std::list<EncapType>::const_iterator iterEncap = info.encaps.begin(); iterEncap != info.encaps.end(); iterEncap++)
+				member.encaps.push_back((uint16_t)*iterEncap);
+			member.length = info.length;
+			m_members.push_back(member);
+			names.push_back(info.name);
+		}
+		m_nameTable.reset(new internal::MemberNameTable(names));
+	}
+
+	// Prototype of the class a nested member holds, NULL if it cannot be known.
+	// *owned is set when the caller has to delete it.
+	static Serializable *nestedPrototype(const internal::STypeCommon *member, bool *owned)
+	{
+		const internal::SerializableMemberInfo &info = member->_memberInfo;
+		*owned = false;
+		switch (info.encaps.front())
+		{
+		case EncapType::ETYPE_SUBPAYLOAD:
+			return (Serializable*)info.ptr;
+		case EncapType::ETYPE_SMARTPOINTER:
+		case EncapType::ETYPE_STDLIST:
+			if (info.encaps.back() != EncapType::ETYPE_SUBPAYLOAD)
+				break;
+			if (info.createFactory)
+			{
+				*owned = true;
+				return info.createFactory->create();
+			}
+			if (info.encaps.front() == EncapType::ETYPE_SMARTPOINTER)
+				return ((JsCPPUtils::SmartPointer<Serializable>*)info.ptr)->getPtr();
+			break;
+		default:
+			break;
+		}
+		return NULL;
+	}
+
+	void JSONTranscoder::registerType(const Serializable &prototype)
+	{
+		const std::list<internal::STypeCommon*> &members = prototype.serializableMembers();
+		std::unique_ptr<SerializableSchema> &entry = m_schemas[prototype.serializableGetName()];
+		SerializableSchema *schema;
+		size_t ordinal = 0;
+		if (entry)
+			return;
+		// Stored before recursing so self-referencing classes terminate
+		entry.reset(new SerializableSchema(prototype));
+		schema = entry.get();
+		for (std::list<internal::STypeCommon*>::const_iterator iterMem = members.begin(); iterMem != members.end(); iterMem++, ordinal++)
+		{
+			bool owned;
+			Serializable *nested = nestedPrototype(*iterMem, &owned);
+			if (!nested)
+				continue;
+			schema->m_members[ordinal].nestedName = nested->serializableGetName();
+			registerType(*nested);
+			if (owned)
+				delete nested;
+		}
+	}
+
+	const SerializableSchema *JSONTranscoder::findSchema(const char *name, size_t length) const
+	{
+		std::map<std::string, std::unique_ptr<SerializableSchema> >::const_iterator iter = m_schemas.find(std::string(name, length));
+		if (iter == m_schemas.end())
+			return NULL;
+		return iter->second.get();
+	}
+
+	// Binary -> JSON
+
+	class TranscodeReader
+	{
+	private:
+		const unsigned char *m_data;
+		size_t m_size;
+		size_t m_pos;
+
+	public:
+		TranscodeReader(const unsigned char *data, size_t size) :
+			m_data(data), m_size(size), m_pos(0)
+		{
+		}
+
+		size_t remain() const {
+			return m_size - m_pos;
+		}
+
+		template<typename T>
+		T read()
+		{
+			T value;
+			memcpy(&value, take(sizeof(T)), sizeof(T));
+			return value;
+		}
+
+		const unsigned char *take(size_t length)
+		{
+			const unsigned char *ptr = &m_data[m_pos];
+			if (remain() < length)
+				throw Serializable::ParseException();
+			m_pos += length;
+			return ptr;
+		}
+	};
+
+	template <typename WriterT>
+	static void writeWideString(WriterT &jsonWriter, const unsigned char *data, size_t length)
+	{
+		static thread_local std::basic_string<wchar_t> wideText;
+		static thread_local std::string utf8Text;
+		wideText.resize(length);
+		if (length > 0)
+			memcpy(&wideText[0], data, length * sizeof(wchar_t));
+		utf8Text.clear();
+		internal::UTFTranscoder::appendUTF8(utf8Text, wideText.c_str(), length);
+		jsonWriter.String(utf8Text.c_str(), utf8Text.length());
+	}
+
+	template <typename WriterT>
+	static void transcodeNative(TranscodeReader &reader, uint16_t etype, WriterT &jsonWriter)
+	{
+		switch (etype & 0x00FF)
+		{
+		case (EncapType::ETYPE_BOOL):
+			jsonWriter.Bool(reader.read<unsigned char>() ? true : false);
+			break;
+		case (EncapType::ETYPE_SINT | 1):
+			jsonWriter.Int(reader.read<int8_t>());
+			break;
+		case (EncapType::ETYPE_UINT | 1):
+			jsonWriter.Uint(reader.read<uint8_t>());
+			break;
+		case (EncapType::ETYPE_SINT | 2):
+			jsonWriter.Int(reader.read<int16_t>());
+			break;
+		case (EncapType::ETYPE_UINT | 2):
+			jsonWriter.Uint(reader.read<uint16_t>());
+			break;
+		case (EncapType::ETYPE_SINT | 4):
+			jsonWriter.Int(reader.read<int32_t>());
+			break;
+		case (EncapType::ETYPE_UINT | 4):
+			jsonWriter.Uint(reader.read<uint32_t>());
+			break;
+		case (EncapType::ETYPE_SINT | 8):
+			jsonWriter.Int64(reader.read<int64_t>());
+			break;
+		case (EncapType::ETYPE_UINT | 8):
+			jsonWriter.Uint64(reader.read<uint64_t>());
+			break;
+		case (EncapType::ETYPE_CHAR):
+			jsonWriter.String((const char*)reader.take(1), 1);
+			break;
+		case (EncapType::ETYPE_WCHAR):
+			writeWideString(jsonWriter, reader.take(sizeof(wchar_t)), 1);
+			break;
+		case (EncapType::ETYPE_FLOAT):
+			jsonWriter.Double(reader.read<float>());
+			break;
+		case (EncapType::ETYPE_DOUBLE):
+			jsonWriter.Double(reader.read<double>());
+			break;
+		default:
+			throw Serializable::ParseException();
+		}
+	}
+
+	template <typename WriterT>
+	static void transcodeNativeArray(TranscodeReader &reader, uint16_t etype, WriterT &jsonWriter)
+	{
+		uint32_t count = reader.read<uint32_t>();
+		uint32_t i;
+		jsonWriter.StartArray();
+		for (i = 0; i < count; i++)
+			transcodeNative(reader, etype, jsonWriter);
+		jsonWriter.EndArray(count);
+	}
+
+	template <typename WriterT>
+	static void transcodeString(TranscodeReader &reader, uint16_t etype, WriterT &jsonWriter)
+	{
+		uint32_t length = reader.read<uint32_t>();
+		if ((etype & EncapType::ETYPE_WCHAR) == EncapType::ETYPE_WCHAR)
+			writeWideString(jsonWriter, reader.take(length * sizeof(wchar_t)), length);
+		else if ((etype & EncapType::ETYPE_CHAR) == EncapType::ETYPE_CHAR)
+			jsonWriter.String((const char*)reader.take(length), length);
+		else
+			throw Serializable::ParseException();
+	}
+
+	static uint64_t readVarint(TranscodeReader &reader)
+	{
+		uint64_t value = 0;
+		int shift;
+		for (shift = 0; shift < 64; shift += 7)
+		{
+			unsigned char b = reader.read<unsigned char>();
+			value |= (uint64_t)(b & 0x7F) << shift;
+			if (!(b & 0x80))
+				return value;
+		}
+		throw Serializable::ParseException();
+	}
+
+	struct TranscodeColumn
+	{
+		uint16_t etype;
+		unsigned char encoding;
+		bool nulls;
+		const unsigned char *bitmap;
+		TranscodeReader reader;
+		// Running value of a delta-coded column
+		uint64_t value;
+
+		TranscodeColumn(uint16_t _etype, unsigned char _encoding, const unsigned char *data, size_t size) :
+			etype(_etype & ~EncapType::ETYPE_NULL), encoding(_encoding),
+			nulls(((_etype & 0x7F00) == EncapType::ETYPE_NATIVE) && (_etype & EncapType::ETYPE_NULL)),
+			bitmap(NULL), reader(data, size), value(0)
+		{
+		}
+	};
+
+	class TranscodeToJson
+	{
+	private:
+		const JSONTranscoder *m_transcoder;
+		rapidjson::Writer<rapidjson::StringBuffer> &m_writer;
+
+	public:
+		TranscodeToJson(const JSONTranscoder *transcoder, rapidjson::Writer<rapidjson::StringBuffer> &jsonWriter) :
+			m_transcoder(transcoder), m_writer(jsonWriter)
+		{
+		}
+
+		void object(const unsigned char *data, size_t size)
+		{
+			const char *name;
+			size_t nameLength;
+			int64_t serialVersionUID;
+			size_t headerSize;
+			const SerializableSchema *schema;
+			std::vector<unsigned char> plain;
+
+			if (!Serializable::serializablePeekHeader(data, size, &name, &nameLength, &serialVersionUID, &headerSize))
+				throw Serializable::ParseException();
+			if (Serializable::serializableExpand(data, size, plain))
+			{
+				object(&plain[0], plain.size());
+				return;
+			}
+			schema = m_transcoder->findSchema(name, nameLength);
+			if (!schema)
+				throw JSONTranscoder::TypeNotRegisteredException();
+			if (schema->serialVersionUID() != serialVersionUID)
+				throw Serializable::ParseException();
+
+			TranscodeReader reader(data + headerSize, size - headerSize);
+			const std::vector<SerializableSchema::Member> &members = schema->members();
+			m_writer.StartObject();
+			for (std::vector<SerializableSchema::Member>::const_iterator iterMem = members.begin(); iterMem != members.end() && reader.remain() > 0; iterMem++)
+			{
+				m_writer.RawValue(iterMem->quotedName.c_str(), iterMem->quotedName.length(), rapidjson::kStringType);
+				member(reader);
+			}
+			m_writer.EndObject();
+		}
+
+	private:
+		void nested(TranscodeReader &reader)
+		{
+			uint32_t size = reader.read<uint32_t>();
+			if (size == 0)
+				m_writer.Null();
+			else
+				object(reader.take(size), size);
+		}
+
+		// Rows of a columnar list are written one at a time; every column keeps
+		// its own read position and yields the value of the next row in turn.
+		void columns(TranscodeReader &reader, uint32_t count)
+		{
+			const char *name;
+			size_t nameLength;
+			int64_t serialVersionUID;
+			size_t headerSize;
+			const SerializableSchema *schema;
+			const unsigned char *block;
+			uint32_t size;
+			std::vector<TranscodeColumn> columns;
+			uint32_t i;
+			size_t j;
+
+			m_writer.StartArray();
+			if (count == 0)
+			{
+				m_writer.EndArray(0);
+				return;
+			}
+			size = reader.read<uint32_t>();
+			block = reader.take(size);
+			if (!Serializable::serializablePeekHeader(block, size, &name, &nameLength, &serialVersionUID, &headerSize) || block[4])
+				throw Serializable::ParseException();
+			schema = m_transcoder->findSchema(name, nameLength);
+			if (!schema)
+				throw JSONTranscoder::TypeNotRegisteredException();
+			if (schema->serialVersionUID() != serialVersionUID)
+				throw Serializable::ParseException();
+
+			TranscodeReader blockReader(block + headerSize, size - headerSize);
+			while (blockReader.remain() > 0)
+			{
+				uint16_t etype = blockReader.read<uint16_t>();
+				unsigned char encoding = blockReader.read<unsigned char>();
+				uint32_t columnSize = blockReader.read<uint32_t>();
+				columns.push_back(TranscodeColumn(etype, encoding, blockReader.take(columnSize), columnSize));
+				if (columns.back().nulls)
+					columns.back().bitmap = columns.back().reader.take((count + 7) / 8);
+			}
+			const std::vector<SerializableSchema::Member> &members = schema->members();
+			if (columns.size() > members.size())
+				throw Serializable::ParseException();
+
+			for (i = 0; i < count; i++)
+			{
+				m_writer.StartObject();
+				for (j = 0; j < columns.size(); j++)
+				{
+					TranscodeColumn &column = columns[j];
+					m_writer.RawValue(members[j].quotedName.c_str(), members[j].quotedName.length(), rapidjson::kStringType);
+					if ((column.etype & 0xFF00) != EncapType::ETYPE_NATIVE)
+					{
+						if (column.encoding != internal::COLUMN_ROWS)
+							throw Serializable::ParseException();
+						member(column.reader);
+					}
+					else if (column.nulls && (column.bitmap[i / 8] & (1 << (i % 8))))
+					{
+						m_writer.Null();
+						if (column.encoding == internal::COLUMN_RAW)
+							column.reader.take(internal::nativeElementSize(column.etype));
+					}
+					else if (column.encoding == internal::COLUMN_RAW)
+					{
+						transcodeNative(column.reader, column.etype, m_writer);
+					}
+					else if (column.encoding == internal::COLUMN_DELTA)
+					{
+						column.value += internal::zigzagDecode(readVarint(column.reader));
+						TranscodeReader valueReader((const unsigned char*)&column.value, internal::nativeElementSize(column.etype));
+						transcodeNative(valueReader, column.etype, m_writer);
+					}
+					else
+					{
+						throw Serializable::ParseException();
+					}
+				}
+				m_writer.EndObject();
+			}
+			for (j = 0; j < columns.size(); j++)
+			{
+				if (columns[j].reader.remain() != 0)
+					throw Serializable::ParseException();
+			}
+			m_writer.EndArray(count);
+		}
+
+		void member(TranscodeReader &reader)
+		{
+			uint16_t etype = reader.read<uint16_t>();
+			uint16_t elementEtype;
+			uint32_t count;
+			uint32_t i;
+
+			if (etype & EncapType::ETYPE_NULL)
+			{
+				m_writer.Null();
+				return;
+			}
+			switch (etype & 0xFF00)
+			{
+			case EncapType::ETYPE_NATIVE:
+				transcodeNative(reader, etype, m_writer);
+				return;
+			case EncapType::ETYPE_NATIVEARRAY:
+				transcodeNativeArray(reader, etype, m_writer);
+				return;
+			}
+
+			switch (etype)
+			{
+			case EncapType::ETYPE_STDBASICSTRING:
+				transcodeString(reader, reader.read<uint16_t>(), m_writer);
+				break;
+			case EncapType::ETYPE_STDVECTOR:
+				elementEtype = reader.read<uint16_t>();
+				if (elementEtype & EncapType::ETYPE_NULL)
+					m_writer.Null();
+				else
+					transcodeNativeArray(reader, elementEtype, m_writer);
+				break;
+			case EncapType::ETYPE_STDLIST:
+				etype = reader.read<uint16_t>();
+				elementEtype = reader.read<uint16_t>();
+				count = reader.read<uint32_t>();
+				if ((etype == EncapType::ETYPE_SMARTPOINTER) && (elementEtype == EncapType::ETYPE_COLUMNAR))
+				{
+					columns(reader, count);
+					break;
+				}
+				m_writer.StartArray();
+				for (i = 0; i < count; i++)
+				{
+					switch (etype)
+					{
+					case EncapType::ETYPE_SMARTPOINTER:
+						if (elementEtype != EncapType::ETYPE_SUBPAYLOAD)
+							throw Serializable::ParseException();
+						nested(reader);
+						break;
+					case EncapType::ETYPE_STDVECTOR:
+						transcodeNativeArray(reader, elementEtype, m_writer);
+						break;
+					case EncapType::ETYPE_STDBASICSTRING:
+						transcodeString(reader, elementEtype, m_writer);
+						break;
+					default:
+						throw Serializable::ParseException();
+					}
+				}
+				m_writer.EndArray(count);
+				break;
+			case EncapType::ETYPE_SUBPAYLOAD:
+				nested(reader);
+				break;
+			case EncapType::ETYPE_SMARTPOINTER:
+				elementEtype = reader.read<uint16_t>();
+				if (elementEtype & EncapType::ETYPE_NULL)
+					m_writer.Null();
+				else if (elementEtype == EncapType::ETYPE_SUBPAYLOAD)
+					nested(reader);
+				else
+					throw Serializable::ParseException();
+				break;
+			default:
+				throw Serializable::ParseException();
+			}
+		}
+	};
+
+	void JSONTranscoder::toJson(const unsigned char *payload, size_t size, rapidjson::Writer<rapidjson::StringBuffer> &jsonWriter) const JSRPC_THROWS(Serializable::ParseException, TypeNotRegisteredException)
+	{
+		TranscodeToJson transcode(this, jsonWriter);
+		transcode.object(payload, size);
+	}
+
+	std::string JSONTranscoder::toJson(const std::vector<unsigned char> &payload) const JSRPC_THROWS(Serializable::ParseException, TypeNotRegisteredException)
+	{
+		rapidjson::StringBuffer jsonBuf;
+		rapidjson::Writer<rapidjson::StringBuffer> jsonWriter(jsonBuf);
+		toJson(payload.empty() ? NULL : &payload[0], payload.size(), jsonWriter);
+		return std::string(jsonBuf.GetString(), jsonBuf.GetSize());
+	}
+
+	// JSON -> binary
+
+	template <typename T>
+	static void appendRaw(std::vector<unsigned char> &payload, const T &value)
+	{
+		size_t pos = payload.size();
+		payload.resize(pos + sizeof(T));
+		memcpy(&payload[pos], &value, sizeof(T));
+	}
+
+	template <typename T>
+	static void appendInteger(std::vector<unsigned char> &payload, const rapidjson::Value &jsonValue)
+	{
+		T value;
+		if (jsonValue.IsUint64())
+		{
+			if (jsonValue.GetUint64() > (uint64_t)std::numeric_limits<T>::max())
+				throw JSONObjectMapper::DataOverrflowException();
+			value = (T)jsonValue.GetUint64();
+		}
+		else if (jsonValue.IsInt64())
+		{
+			if (!std::numeric_limits<T>::is_signed)
+				throw JSONObjectMapper::TypeNotMatchException();
+			if (jsonValue.GetInt64() < (int64_t)std::numeric_limits<T>::min())
+				throw JSONObjectMapper::DataOverrflowException();
+			value = (T)jsonValue.GetInt64();
+		}
+		else
+			throw JSONObjectMapper::TypeNotMatchException();
+		appendRaw(payload, value);
+	}
+
+	template <typename T>
+	static void appendFloating(std::vector<unsigned char> &payload, const rapidjson::Value &jsonValue)
+	{
+		if (!jsonValue.IsNumber())
+			throw JSONObjectMapper::TypeNotMatchException();
+		appendRaw(payload, (T)jsonValue.GetDouble());
+	}
+
+	static void appendNative(std::vector<unsigned char> &payload, uint16_t etype, const rapidjson::Value &jsonValue)
+	{
+		switch (etype & 0x00FF)
+		{
+		case (EncapType::ETYPE_BOOL):
+			if (!jsonValue.IsBool())
+				throw JSONObjectMapper::TypeNotMatchException();
+			payload.push_back(jsonValue.GetBool() ? 1 : 0);
+			break;
+		case (EncapType::ETYPE_SINT | 1):
+			appendInteger<int8_t>(payload, jsonValue);
+			break;
+		case (EncapType::ETYPE_UINT | 1):
+			appendInteger<uint8_t>(payload, jsonValue);
+			break;
+		case (EncapType::ETYPE_SINT | 2):
+			appendInteger<int16_t>(payload, jsonValue);
+			break;
+		case (EncapType::ETYPE_UINT | 2):
+			appendInteger<uint16_t>(payload, jsonValue);
+			break;
+		case (EncapType::ETYPE_SINT | 4):
+			appendInteger<int32_t>(payload, jsonValue);
+			break;
+		case (EncapType::ETYPE_UINT | 4):
+			appendInteger<uint32_t>(payload, jsonValue);
+			break;
+		case (EncapType::ETYPE_SINT | 8):
+			appendInteger<int64_t>(payload, jsonValue);
+			break;
+		case (EncapType::ETYPE_UINT | 8):
+			appendInteger<uint64_t>(payload, jsonValue);
+			break;
+		case (EncapType::ETYPE_CHAR):
+			if (!jsonValue.IsString())
+				throw JSONObjectMapper::TypeNotMatchException();
+			payload.push_back(jsonValue.GetStringLength() ? (unsigned char)jsonValue.GetString()[0] : 0);
+			break;
+		case (EncapType::ETYPE_WCHAR):
+			if (!jsonValue.IsString())
+				throw JSONObjectMapper::TypeNotMatchException();
+			appendRaw(payload, internal::UTFTranscoder::firstFromUTF8<wchar_t>(jsonValue.GetString(), jsonValue.GetStringLength()));
+			break;
+		case (EncapType::ETYPE_FLOAT):
+			appendFloating<float>(payload, jsonValue);
+			break;
+		case (EncapType::ETYPE_DOUBLE):
+			appendFloating<double>(payload, jsonValue);
+			break;
+		default:
+			throw Serializable::UnavailableTypeException();
+		}
+	}
+
+	static void appendNativeArray(std::vector<unsigned char> &payload, uint16_t etype, const rapidjson::Value &jsonValue)
+	{
+		if (!jsonValue.IsArray())
+			throw JSONObjectMapper::TypeNotMatchException();
+		appendRaw(payload, (uint32_t)jsonValue.Size());
+		for (rapidjson::Value::ConstValueIterator iter = jsonValue.Begin(); iter != jsonValue.End(); iter++)
+			appendNative(payload, etype, *iter);
+	}
+
+	static void appendString(std::vector<unsigned char> &payload, uint16_t etype, const rapidjson::Value &jsonValue)
+	{
+		if (!jsonValue.IsString())
+			throw JSONObjectMapper::TypeNotMatchException();
+		if ((etype & EncapType::ETYPE_WCHAR) == EncapType::ETYPE_WCHAR)
+		{
+			static thread_local std::basic_string<wchar_t> wideText;
+			internal::UTFTranscoder::assignFromUTF8(wideText, jsonValue.GetString(), jsonValue.GetStringLength());
+			appendRaw(payload, (uint32_t)wideText.length());
+			payload.insert(payload.end(), (const unsigned char*)wideText.c_str(), (const unsigned char*)(wideText.c_str() + wideText.length()));
+		}
+		else if ((etype & EncapType::ETYPE_CHAR) == EncapType::ETYPE_CHAR)
+		{
+			appendRaw(payload, (uint32_t)jsonValue.GetStringLength());
+			payload.insert(payload.end(), (const unsigned char*)jsonValue.GetString(), (const unsigned char*)jsonValue.GetString() + jsonValue.GetStringLength());
+		}
+		else
+			throw Serializable::UnavailableTypeException();
+	}
+
+	static void appendNull(std::vector<unsigned char> &payload, const SerializableSchema::Member &member)
+	{
+		uint16_t etype = member.encaps[0];
+		// An empty SmartPointer is encoded like Serializable::serialize does it
+		if (etype == EncapType::ETYPE_SMARTPOINTER)
+		{
+			appendRaw(payload, etype);
+			etype = member.encaps[1];
+		}
+		appendRaw(payload, (uint16_t)(etype | EncapType::ETYPE_NULL));
+	}
+
+	// Writes the payload straight from parser events. A member is written as
+	// soon as every member declared before it is in the payload; one whose key
+	// comes earlier waits in its object's frame until then. A key seen again
+	// replaces the earlier value, as it does in a DOM.
+	class TranscodeFromJson
+	{
+	private:
+		enum FrameKind {
+			FRAME_OBJECT,
+			FRAME_NATIVEARRAY,
+			FRAME_VECTOR,
+			FRAME_LIST,
+			FRAME_SKIP,
+		};
+		enum ErrorKind {
+			ERROR_NONE,
+			ERROR_TYPENOTMATCH,
+			ERROR_DATAOVERFLOW,
+			ERROR_UNAVAILABLETYPE,
+			ERROR_NOTREGISTERED,
+		};
+		enum EventKind {
+			EVENT_SCALAR,
+			EVENT_NULL,
+			EVENT_START_OBJECT,
+			EVENT_START_ARRAY,
+		};
+		enum SlotState {
+			SLOT_EMPTY,
+			SLOT_WRITTEN,
+			SLOT_DEFERRED,
+		};
+		// Where the bytes of one member are: in the frame's output or its deferred buffer
+		struct Slot {
+			SlotState state;
+			size_t begin;
+			size_t end;
+		};
+		struct Frame {
+			FrameKind kind;
+			// Frame whose deferred buffer this frame writes to, -1 for the payload
+			int output;
+			// Offset of the u32 size or count filled in when the frame closes
+			size_t sizePos;
+			uint32_t count;
+			size_t depth;
+			// FRAME_OBJECT: member the next value belongs to (-1: unknown key),
+			// first member not yet in the output and the object's slots in m_slots
+			const SerializableSchema *schema;
+			int32_t ordinal;
+			size_t next;
+			size_t slotBase;
+			std::vector<unsigned char> deferred;
+			// Arrays and lists: the member, and the etype of the elements
+			const SerializableSchema::Member *member;
+			uint16_t etype;
+		};
+
+		const JSONTranscoder *m_transcoder;
+		const SerializableSchema *m_root;
+		std::vector<unsigned char> &m_payload;
+		std::vector<Frame> m_stack;
+		std::vector<Slot> m_slots;
+		ErrorKind m_error;
+
+	public:
+		TranscodeFromJson(const JSONTranscoder *transcoder, const SerializableSchema *root, std::vector<unsigned char> &payload) :
+			m_transcoder(transcoder), m_root(root), m_payload(payload), m_error(ERROR_NONE)
+		{
+			m_payload.clear();
+		}
+
+		void throwIfFailed() const
+		{
+			switch (m_error)
+			{
+			case ERROR_TYPENOTMATCH:
+				throw JSONObjectMapper::TypeNotMatchException();
+			case ERROR_DATAOVERFLOW:
+				throw JSONObjectMapper::DataOverrflowException();
+			case ERROR_UNAVAILABLETYPE:
+				throw Serializable::UnavailableTypeException();
+			case ERROR_NOTREGISTERED:
+				throw JSONTranscoder::TypeNotRegisteredException();
+			default:
+				break;
+			}
+		}
+
+		// Scalars are wrapped in a Value so the DOM conversion rules apply as they are
+		bool Null() { return event(EVENT_NULL, NULL); }
+		bool Bool(bool b) {
+			rapidjson::Value value;
+			value.SetBool(b);
+			return event(EVENT_SCALAR, &value);
+		}
+		bool Int(int i) {
+			rapidjson::Value value;
+			value.SetInt(i);
+			return event(EVENT_SCALAR, &value);
+		}
+		bool Uint(unsigned u) {
+			rapidjson::Value value;
+			value.SetUint(u);
+			return event(EVENT_SCALAR, &value);
+		}
+		bool Int64(int64_t i) {
+			rapidjson::Value value;
+			value.SetInt64(i);
+			return event(EVENT_SCALAR, &value);
+		}
+		bool Uint64(uint64_t u) {
+			rapidjson::Value value;
+			value.SetUint64(u);
+			return event(EVENT_SCALAR, &value);
+		}
+		bool Double(double d) {
+			rapidjson::Value value;
+			value.SetDouble(d);
+			return event(EVENT_SCALAR, &value);
+		}
+		bool RawNumber(const char *str, rapidjson::SizeType length, bool copy) {
+			return false;
+		}
+		bool String(const char *str, rapidjson::SizeType length, bool copy) {
+			rapidjson::Value value;
+			value.SetString(rapidjson::StringRef(str, length));
+			return event(EVENT_SCALAR, &value);
+		}
+		bool StartObject() { return event(EVENT_START_OBJECT, NULL); }
+		bool StartArray() { return event(EVENT_START_ARRAY, NULL); }
+		bool Key(const char *str, rapidjson::SizeType length, bool copy) {
+			if (m_error != ERROR_NONE)
+				return false;
+			Frame &frame = m_stack.back();
+			if (frame.kind == FRAME_SKIP)
+				return true;
+			frame.ordinal = frame.schema->findMember(str, length);
+			if ((frame.ordinal >= 0) && ((size_t)frame.ordinal < frame.next))
+				rewind(frame);
+			return true;
+		}
+		bool EndObject(rapidjson::SizeType memberCount) {
+			return endContainer();
+		}
+		bool EndArray(rapidjson::SizeType elementCount) {
+			return endContainer();
+		}
+
+	private:
+		std::vector<unsigned char> &output(int index)
+		{
+			if (index < 0)
+				return m_payload;
+			return m_stack[index].deferred;
+		}
+
+		bool event(EventKind kind, const rapidjson::Value *value)
+		{
+			if (m_error != ERROR_NONE)
+				return false;
+			try {
+				if (m_stack.empty())
+				{
+					if (kind != EVENT_START_OBJECT)
+						throw JSONObjectMapper::TypeNotMatchException();
+					pushObject(-1, m_root, std::string::npos);
+				}
+				else
+				{
+					Frame &frame = m_stack.back();
+					switch (frame.kind)
+					{
+					case FRAME_OBJECT:
+						if (frame.ordinal >= 0)
+							memberValue(kind, value);
+						else if ((kind == EVENT_START_OBJECT) || (kind == EVENT_START_ARRAY))
+							pushFrame(FRAME_SKIP, -1, std::string::npos, NULL, 0);
+						break;
+					case FRAME_NATIVEARRAY:
+						if ((kind != EVENT_SCALAR) || (++frame.count > (uint32_t)frame.member->length))
+							throw JSONObjectMapper::TypeNotMatchException();
+						appendNative(output(frame.output), frame.etype, *value);
+						break;
+					case FRAME_VECTOR:
+						if (kind != EVENT_SCALAR)
+							throw JSONObjectMapper::TypeNotMatchException();
+						frame.count++;
+						appendNative(output(frame.output), frame.etype, *value);
+						break;
+					case FRAME_LIST:
+						frame.count++;
+						listElement(kind, value);
+						break;
+					case FRAME_SKIP:
+						if ((kind == EVENT_START_OBJECT) || (kind == EVENT_START_ARRAY))
+							frame.depth++;
+						break;
+					}
+				}
+			} catch (JSONObjectMapper::TypeNotMatchException &) {
+				m_error = ERROR_TYPENOTMATCH;
+			} catch (JSONObjectMapper::DataOverrflowException &) {
+				m_error = ERROR_DATAOVERFLOW;
+			} catch (Serializable::UnavailableTypeException &) {
+				m_error = ERROR_UNAVAILABLETYPE;
+			} catch (JSONTranscoder::TypeNotRegisteredException &) {
+				m_error = ERROR_NOTREGISTERED;
+			}
+			return m_error == ERROR_NONE;
+		}
+
+		bool endContainer()
+		{
+			if (m_error != ERROR_NONE)
+				return false;
+			Frame &frame = m_stack.back();
+			if ((frame.kind == FRAME_SKIP) && (--frame.depth > 0))
+				return true;
+			switch (frame.kind)
+			{
+			case FRAME_OBJECT:
+				finishObject(frame);
+				break;
+			case FRAME_NATIVEARRAY:
+				if (frame.count != (uint32_t)frame.member->length)
+				{
+					m_error = ERROR_TYPENOTMATCH;
+					return false;
+				}
+				memcpy(&output(frame.output)[frame.sizePos], &frame.count, sizeof(frame.count));
+				break;
+			case FRAME_VECTOR:
+			case FRAME_LIST:
+				memcpy(&output(frame.output)[frame.sizePos], &frame.count, sizeof(frame.count));
+				break;
+			case FRAME_SKIP:
+				break;
+			}
+			m_stack.pop_back();
+			// Containers opened for a member value complete it when they close
+			if (!m_stack.empty() && (m_stack.back().kind == FRAME_OBJECT))
+				memberDone(m_stack.back());
+			return true;
+		}
+
+		void pushFrame(FrameKind kind, int output, size_t sizePos, const SerializableSchema::Member *member, uint16_t etype)
+		{
+			Frame frame;
+			frame.kind = kind;
+			frame.output = output;
+			frame.sizePos = sizePos;
+			frame.count = 0;
+			frame.depth = 1;
+			frame.schema = NULL;
+			frame.ordinal = -1;
+			frame.next = 0;
+			frame.slotBase = m_slots.size();
+			frame.member = member;
+			frame.etype = etype;
+			m_stack.push_back(frame);
+		}
+
+		// Arrays and lists start with a u32 count that is filled in at the end
+		void pushArray(FrameKind kind, int output, const SerializableSchema::Member *member, uint16_t etype)
+		{
+			std::vector<unsigned char> &payload = this->output(output);
+			size_t sizePos = payload.size();
+			appendRaw(payload, (uint32_t)0);
+			pushFrame(kind, output, sizePos, member, etype);
+		}
+
+		void pushObject(int output, const SerializableSchema *schema, size_t sizePos)
+		{
+			// Same bytes as Serializable::header
+			static const unsigned char header[] = { 'J', 0x18, 'R', 'S', 0x00, 0x01 };
+			static const Slot emptySlot = { SLOT_EMPTY, 0, 0 };
+			std::vector<unsigned char> &payload = this->output(output);
+			uint64_t serialVersionUID = (uint64_t)schema->serialVersionUID();
+			int i;
+
+			payload.insert(payload.end(), header, header + sizeof(header));
+			payload.push_back((unsigned char)schema->name().length());
+			payload.insert(payload.end(), schema->name().begin(), schema->name().end());
+			for (i = 0; i < 8; i++)
+				payload.push_back((unsigned char)(serialVersionUID >> (i * 8)));
+
+			pushFrame(FRAME_OBJECT, output, sizePos, NULL, 0);
+			m_stack.back().schema = schema;
+			m_slots.resize(m_slots.size() + schema->members().size(), emptySlot);
+		}
+
+		// A nested object is a u32 size followed by its payload; size 0 is null.
+		// Returns false if no frame was opened.
+		bool startNested(int output, const std::string &typeName, EventKind kind)
+		{
+			std::vector<unsigned char> &payload = this->output(output);
+			size_t sizePos = payload.size();
+			appendRaw(payload, (uint32_t)0);
+			if (kind == EVENT_NULL)
+				return false;
+			const SerializableSchema *schema = m_transcoder->findSchema(typeName.c_str(), typeName.length());
+			if (!schema)
+				throw JSONTranscoder::TypeNotRegisteredException();
+			if (kind != EVENT_START_OBJECT)
+				throw JSONObjectMapper::TypeNotMatchException();
+			pushObject(output, schema, sizePos);
+			return true;
+		}
+
+		void memberValue(EventKind kind, const rapidjson::Value *value)
+		{
+			int index = (int)m_stack.size() - 1;
+			Frame &frame = m_stack.back();
+			const SerializableSchema::Member &member = frame.schema->members()[frame.ordinal];
+			Slot &slot = m_slots[frame.slotBase + frame.ordinal];
+			int output;
+			bool done = true;
+
+			if ((size_t)frame.ordinal == frame.next)
+			{
+				output = frame.output;
+				slot.state = SLOT_WRITTEN;
+			}
+			else
+			{
+				// A repeated key that is still waiting just gets a fresh copy
+				output = index;
+				slot.state = SLOT_DEFERRED;
+			}
+			std::vector<unsigned char> &payload = this->output(output);
+			slot.begin = payload.size();
+
+			if (kind == EVENT_NULL)
+			{
+				appendNull(payload, member);
+				memberDone(frame);
+				return;
+			}
+			uint16_t etype = member.encaps[0];
+			switch (etype & 0xFF00)
+			{
+			case EncapType::ETYPE_NATIVE:
+				if (kind != EVENT_SCALAR)
+					throw JSONObjectMapper::TypeNotMatchException();
+				appendRaw(payload, etype);
+				appendNative(payload, etype, *value);
+				memberDone(frame);
+				return;
+			case EncapType::ETYPE_NATIVEARRAY:
+				if (kind != EVENT_START_ARRAY)
+					throw JSONObjectMapper::TypeNotMatchException();
+				appendRaw(payload, etype);
+				pushArray(FRAME_NATIVEARRAY, output, &member, etype);
+				return;
+			}
+
+			// Frames opened below may move the frame and its buffer
+			switch (etype)
+			{
+			case EncapType::ETYPE_STDBASICSTRING:
+				if (kind != EVENT_SCALAR)
+					throw JSONObjectMapper::TypeNotMatchException();
+				appendRaw(payload, etype);
+				appendRaw(payload, member.encaps[1]);
+				appendString(payload, member.encaps[1], *value);
+				break;
+			case EncapType::ETYPE_STDVECTOR:
+				if (kind != EVENT_START_ARRAY)
+					throw JSONObjectMapper::TypeNotMatchException();
+				appendRaw(payload, etype);
+				appendRaw(payload, member.encaps[1]);
+				pushArray(FRAME_VECTOR, output, &member, member.encaps[1]);
+				done = false;
+				break;
+			case EncapType::ETYPE_STDLIST:
+				if (kind != EVENT_START_ARRAY)
+					throw JSONObjectMapper::TypeNotMatchException();
+				appendRaw(payload, etype);
+				appendRaw(payload, member.encaps[1]);
+				appendRaw(payload, member.encaps[2]);
+				pushArray(FRAME_LIST, output, &member, member.encaps[2]);
+				done = false;
+				break;
+			case EncapType::ETYPE_SUBPAYLOAD:
+				appendRaw(payload, etype);
+				done = !startNested(output, member.nestedName, kind);
+				break;
+			case EncapType::ETYPE_SMARTPOINTER:
+				appendRaw(payload, etype);
+				appendRaw(payload, member.encaps[1]);
+				done = !startNested(output, member.nestedName, kind);
+				break;
+			default:
+				throw Serializable::UnavailableTypeException();
+			}
+			if (done)
+				memberDone(m_stack[index]);
+		}
+
+		void listElement(EventKind kind, const rapidjson::Value *value)
+		{
+			Frame &frame = m_stack.back();
+			const SerializableSchema::Member *member = frame.member;
+			int output = frame.output;
+			switch (member->encaps[1])
+			{
+			case EncapType::ETYPE_SMARTPOINTER:
+				startNested(output, member->nestedName, kind);
+				break;
+			case EncapType::ETYPE_STDVECTOR:
+				if (kind != EVENT_START_ARRAY)
+					throw JSONObjectMapper::TypeNotMatchException();
+				pushArray(FRAME_VECTOR, output, member, member->encaps[2]);
+				break;
+			case EncapType::ETYPE_STDBASICSTRING:
+				if (kind != EVENT_SCALAR)
+					throw JSONObjectMapper::TypeNotMatchException();
+				appendString(this->output(output), member->encaps[2], *value);
+				break;
+			default:
+				throw Serializable::UnavailableTypeException();
+			}
+		}
+
+		// Called once the value of frame.ordinal is complete
+		void memberDone(Frame &frame)
+		{
+			if (frame.ordinal < 0)
+				return;
+			Slot &slot = m_slots[frame.slotBase + frame.ordinal];
+			if (slot.state == SLOT_DEFERRED)
+			{
+				slot.end = frame.deferred.size();
+				return;
+			}
+			slot.end = output(frame.output).size();
+			frame.next++;
+			flush(frame, frame.schema->members().size());
+		}
+
+		// Moves waiting members whose turn has come into the output
+		void flush(Frame &frame, size_t until)
+		{
+			std::vector<unsigned char> &payload = output(frame.output);
+			while (frame.next < until)
+			{
+				Slot &slot = m_slots[frame.slotBase + frame.next];
+				if (slot.state != SLOT_DEFERRED)
+					break;
+				size_t begin = payload.size();
+				payload.insert(payload.end(), frame.deferred.begin() + slot.begin, frame.deferred.begin() + slot.end);
+				slot.state = SLOT_WRITTEN;
+				slot.begin = begin;
+				slot.end = payload.size();
+				frame.next++;
+			}
+		}
+
+		// frame.ordinal was already written: it and every member after it go
+		// back to the deferred buffer so the new value can take its place
+		void rewind(Frame &frame)
+		{
+			std::vector<unsigned char> &payload = output(frame.output);
+			size_t from = m_slots[frame.slotBase + frame.ordinal].begin;
+			size_t base = frame.deferred.size();
+			size_t i;
+			frame.deferred.insert(frame.deferred.end(), payload.begin() + from, payload.end());
+			payload.resize(from);
+			for (i = frame.ordinal + 1; i < frame.next; i++)
+			{
+				Slot &slot = m_slots[frame.slotBase + i];
+				slot.state = SLOT_DEFERRED;
+				slot.begin = slot.begin - from + base;
+				slot.end = slot.end - from + base;
+			}
+			m_slots[frame.slotBase + frame.ordinal].state = SLOT_EMPTY;
+			frame.next = frame.ordinal;
+		}
+
+		void finishObject(Frame &frame)
+		{
+			const std::vector<SerializableSchema::Member> &members = frame.schema->members();
+			std::vector<unsigned char> &payload = output(frame.output);
+			uint32_t size;
+			while (frame.next < members.size())
+			{
+				flush(frame, members.size());
+				if (frame.next >= members.size())
+					break;
+				// Members missing from the JSON object are null
+				appendNull(payload, members[frame.next]);
+				frame.next++;
+			}
+			if (frame.sizePos != std::string::npos)
+			{
+				size = (uint32_t)(payload.size() - frame.sizePos - sizeof(size));
+				memcpy(&payload[frame.sizePos], &size, sizeof(size));
+			}
+			m_slots.resize(frame.slotBase);
+		}
+	};
+
+	void JSONTranscoder::fromJson(const std::string &typeName, const rapidjson::Value &jsonObject, std::vector<unsigned char> &payload) const JSRPC_THROWS(JSONObjectMapper::TypeNotMatchException, JSONObjectMapper::DataOverrflowException, TypeNotRegisteredException)
+	{
+		const SerializableSchema *schema = findSchema(typeName.c_str(), typeName.length());
+		if (!schema)
+			throw TypeNotRegisteredException();
+		TranscodeFromJson transcode(this, schema, payload);
+		jsonObject.Accept(transcode);
+		transcode.throwIfFailed();
+	}
+
+	void JSONTranscoder::fromJson(const std::string &typeName, const std::string &json, std::vector<unsigned char> &payload) const JSRPC_THROWS(JSONObjectMapper::TypeNotMatchException, JSONObjectMapper::DataOverrflowException, JSONObjectMapper::ParseException, TypeNotRegisteredException)
+	{
+		const SerializableSchema *schema = findSchema(typeName.c_str(), typeName.length());
+		if (!schema)
+			throw TypeNotRegisteredException();
+		// Bounded by length, so an embedded NUL is a parse error rather than the end
+		rapidjson::MemoryStream memoryStream(json.data(), json.length());
+		rapidjson::EncodedInputStream<rapidjson::UTF8<>, rapidjson::MemoryStream> jsonStream(memoryStream);
+		rapidjson::Reader reader;
+		TranscodeFromJson transcode(this, schema, payload);
+		if (reader.Parse(jsonStream, transcode).IsError())
+		{
+			transcode.throwIfFailed();
+			throw JSONObjectMapper::ParseException();
+		}
+	}
+}
+
+#endif
@@ -0,0 +1,121 @@
+/*
+* Licensed to the Apache Software Foundation (ASF) under one or more
+* contributor license agreements.  See the NOTICE file distributed with
+* this work for additional information regarding copyright ownership.
+* The ASF licenses this file to You under the Apache License, Version 2.0
+* (the "License"); you may not use this file except in compliance with
+* the License.  You may obtain a copy of the License at
+*
+*    http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+/**
+ * @file	JSONTranscoder.h
+ * @author	Jichan (development@jc-lab.net / http://ablog.jc-lab.net/ )
+ * @date	2026/10/18
+ * @copyright Copyright (C) 2026 jichan.\n
+ *            This software may be modified and distributed under the terms
+ *            of the Apache License 2.0.  See the LICENSE file for details.
+ */
+
+#pragma once
+
+#include "../Serializable.h"
+#include "JSONObjectMapper.h"
+
+#if defined(HAS_RAPIDJSON) && HAS_RAPIDJSON
+#include <rapidjson/document.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+#endif
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace JsRPC {
+
+#if defined(HAS_RAPIDJSON) && HAS_RAPIDJSON
+	// Member layout of a Serializable class, read once from a prototype instance
+	class SerializableSchema
+	{
+	public:
+		struct Member {
+			std::string name;
+			// Member name already quoted and escaped for JSON output
+			std::string quotedName;
+			std::vector<uint16_t> encaps;
+			// NATIVEARRAY element count
+			int32_t length;
+			// Class of a nested object member (or list element), empty if unknown
+			std::string nestedName;
+		};
+
+	private:
+		friend class JSONTranscoder;
+
+		std::string m_name;
+		int64_t m_serialVersionUID;
+		std::vector<Member> m_members;
+		std::unique_ptr<internal::MemberNameTable> m_nameTable;
+
+	public:
+		explicit SerializableSchema(const Serializable &prototype);
+
+		const std::string &name() const {
+			return m_name;
+		}
+		int64_t serialVersionUID() const {
+			return m_serialVersionUID;
+		}
+		const std::vector<Member> &members() const {
+			return m_members;
+		}
+		// Returns -1 if there is no member of this name
+		int32_t findMember(const char *name, size_t length) const {
+			return m_nameTable->find(name, length);
+		}
+	};
+
+	// Converts between the binary payload and the JSON form JSONObjectMapper
+	// produces, using registered schemas instead of Serializable instances.
+	// Register every type before the transcoder is shared between threads;
+	// after that all methods are const and may run concurrently.
+	class JSONTranscoder
+	{
+	public:
+		class TypeNotRegisteredException : public std::exception
+		{ };
+
+	private:
+		std::map<std::string, std::unique_ptr<SerializableSchema> > m_schemas;
+
+	public:
+		// Also registers the classes of nested object members. Elements held by
+		// SmartPointer are only known when the member has a create factory.
+		void registerType(const Serializable &prototype);
+		template<class T>
+		void registerType()
+		{
+			T prototype;
+			registerType(prototype);
+		}
+
+		const SerializableSchema *findSchema(const char *name, size_t length) const;
+
+		void toJson(const unsigned char *payload, size_t size, rapidjson::Writer<rapidjson::StringBuffer> &jsonWriter) const JSRPC_THROWS(Serializable::ParseException, TypeNotRegisteredException);
+		std::string toJson(const std::vector<unsigned char> &payload) const JSRPC_THROWS(Serializable::ParseException, TypeNotRegisteredException);
+
+		void fromJson(const std::string &typeName, const rapidjson::Value &jsonObject, std::vector<unsigned char> &payload) const JSRPC_THROWS(JSONObjectMapper::TypeNotMatchException, JSONObjectMapper::DataOverrflowException, TypeNotRegisteredException);
+		void fromJson(const std::string &typeName, const std::string &json, std::vector<unsigned char> &payload) const JSRPC_THROWS(JSONObjectMapper::TypeNotMatchException, JSONObjectMapper::DataOverrflowException, JSONObjectMapper::ParseException, TypeNotRegisteredException);
+
+	};
+#endif
+
+}
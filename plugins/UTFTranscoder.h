@@ -0,0 +1,252 @@
+/*
+* Licensed to the Apache Software Foundation (ASF) under one or more
+* contributor license agreements.  See the NOTICE file distributed with
+* this work for additional information regarding copyright ownership.
+* The ASF licenses this file to You under the Apache License, Version 2.0
+* (the "License"); you may not use this file except in compliance with
+* the License.  You may obtain a copy of the License at
+*
+*    http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+/**
+ * @file	UTFTranscoder.h
+ * @author	Jichan (development@jc-lab.net / http://ablog.jc-lab.net/ )
+ * @date	2026/10/18
+ * @copyright Copyright (C) 2026 jichan.\n
+ *            This software may be modified and distributed under the terms
+ *            of the Apache License 2.0.  See the LICENSE file for details.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <string>
+
+namespace JsRPC {
+	namespace internal {
+
+		// UTF-8 <-> UTF-16/UTF-32 conversion without temporaries.
+		// The code unit width is taken from sizeof(CharT), so wchar_t is UTF-16
+		// on Windows and UTF-32 elsewhere. Malformed input becomes U+FFFD.
+		class UTFTranscoder
+		{
+		public:
+			enum {
+				REPLACEMENT_CHARACTER = 0xFFFD
+			};
+
+			// Worst case UTF-8 size of length code units
+			template<typename CharT>
+			static size_t maxUTF8Length(size_t length)
+			{
+				return length * ((sizeof(CharT) == 2) ? 3 : 4);
+			}
+
+			// Worst case code units for length bytes of UTF-8
+			static size_t maxWideLength(size_t length)
+			{
+				return length;
+			}
+
+			// Writes at most maxUTF8Length<CharT>(length) bytes, returns the end
+			template<typename CharT>
+			static char *encodeUTF8(char *dest, const CharT *src, size_t length)
+			{
+				const CharT *end = src + length;
+				while (src < end)
+				{
+					// ASCII fast path: 8 bytes of source per step
+					while ((size_t)(end - src) >= 8 / sizeof(CharT))
+					{
+						uint64_t block;
+						memcpy(&block, src, 8);
+						if (block & wideNonAsciiMask<sizeof(CharT)>())
+							break;
+						for (size_t i = 0; i < 8 / sizeof(CharT); i++)
+							*dest++ = (char)src[i];
+						src += 8 / sizeof(CharT);
+					}
+					if (src >= end)
+						break;
+
+					uint32_t cp = (uint32_t)src[0];
+					if (sizeof(CharT) == 2)
+						cp &= 0xFFFF;
+					src++;
+					if (cp < 0x80)
+					{
+						*dest++ = (char)cp;
+						continue;
+					}
+					if (sizeof(CharT) == 2 && cp >= 0xD800 && cp < 0xE000)
+					{
+						uint32_t low = (src < end) ? ((uint32_t)src[0] & 0xFFFF) : 0;
+						if (cp < 0xDC00 && low >= 0xDC00 && low < 0xE000)
+						{
+							cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+							src++;
+						}
+						else
+						{
+							cp = REPLACEMENT_CHARACTER;
+						}
+					}
+					else if (cp > 0x10FFFF || (cp >= 0xD800 && cp < 0xE000))
+					{
+						cp = REPLACEMENT_CHARACTER;
+					}
+					dest = putUTF8(dest, cp);
+				}
+				return dest;
+			}
+
+			// Writes at most maxWideLength(length) code units, returns the end
+			template<typename CharT>
+			static CharT *decodeUTF8(CharT *dest, const char *src, size_t length)
+			{
+				const unsigned char *p = (const unsigned char*)src;
+				const unsigned char *end = p + length;
+				while (p < end)
+				{
+					while (end - p >= 8)
+					{
+						uint64_t block;
+						memcpy(&block, p, 8);
+						if (block & 0x8080808080808080ULL)
+							break;
+						for (int i = 0; i < 8; i++)
+							*dest++ = (CharT)p[i];
+						p += 8;
+					}
+					if (p >= end)
+						break;
+
+					uint32_t cp = *p;
+					size_t extra;
+					uint32_t minimum;
+					if (cp < 0x80)
+					{
+						*dest++ = (CharT)cp;
+						p++;
+						continue;
+					}
+					else if ((cp & 0xE0) == 0xC0)
+					{
+						extra = 1;
+						minimum = 0x80;
+						cp &= 0x1F;
+					}
+					else if ((cp & 0xF0) == 0xE0)
+					{
+						extra = 2;
+						minimum = 0x800;
+						cp &= 0x0F;
+					}
+					else if ((cp & 0xF8) == 0xF0)
+					{
+						extra = 3;
+						minimum = 0x10000;
+						cp &= 0x07;
+					}
+					else
+					{
+						*dest++ = (CharT)REPLACEMENT_CHARACTER;
+						p++;
+						continue;
+					}
+					p++;
+
+					size_t i;
+					for (i = 0; i < extra && p < end && (*p & 0xC0) == 0x80; i++, p++)
+						cp = (cp << 6) | (*p & 0x3F);
+					if (i < extra || cp < minimum || cp > 0x10FFFF || (cp >= 0xD800 && cp < 0xE000))
+						cp = REPLACEMENT_CHARACTER;
+
+					if (sizeof(CharT) == 2 && cp >= 0x10000)
+					{
+						cp -= 0x10000;
+						*dest++ = (CharT)(0xD800 + (cp >> 10));
+						*dest++ = (CharT)(0xDC00 + (cp & 0x3FF));
+					}
+					else
+					{
+						*dest++ = (CharT)cp;
+					}
+				}
+				return dest;
+			}
+
+			template<typename CharT>
+			static void appendUTF8(std::string &out, const CharT *src, size_t length)
+			{
+				size_t base = out.size();
+				out.resize(base + maxUTF8Length<CharT>(length));
+				char *begin = &out[0];
+				char *end = encodeUTF8(begin + base, src, length);
+				out.resize(end - begin);
+			}
+
+			template<typename CharT>
+			static void assignFromUTF8(std::basic_string<CharT> &out, const char *src, size_t length)
+			{
+				out.resize(maxWideLength(length));
+				if (length == 0)
+					return;
+				CharT *begin = &out[0];
+				CharT *end = decodeUTF8(begin, src, length);
+				out.resize(end - begin);
+			}
+
+			// First code unit of the text, 0 if empty
+			template<typename CharT>
+			static CharT firstFromUTF8(const char *src, size_t length)
+			{
+				CharT buffer[4] = { 0 };
+				size_t n = 0;
+				// One code point is at most 4 bytes of UTF-8
+				while (n < length && n < 4 && (n == 0 || ((unsigned char)src[n] & 0xC0) == 0x80))
+					n++;
+				decodeUTF8(buffer, src, n);
+				return buffer[0];
+			}
+
+		private:
+			template<size_t UnitSize>
+			static uint64_t wideNonAsciiMask()
+			{
+				return (UnitSize == 2) ? 0xFF80FF80FF80FF80ULL : 0xFFFFFF80FFFFFF80ULL;
+			}
+
+			static char *putUTF8(char *dest, uint32_t cp)
+			{
+				if (cp < 0x800)
+				{
+					*dest++ = (char)(0xC0 | (cp >> 6));
+				}
+				else if (cp < 0x10000)
+				{
+					*dest++ = (char)(0xE0 | (cp >> 12));
+					*dest++ = (char)(0x80 | ((cp >> 6) & 0x3F));
+				}
+				else
+				{
+					*dest++ = (char)(0xF0 | (cp >> 18));
+					*dest++ = (char)(0x80 | ((cp >> 12) & 0x3F));
+					*dest++ = (char)(0x80 | ((cp >> 6) & 0x3F));
+				}
+				*dest++ = (char)(0x80 | (cp & 0x3F));
+				return dest;
+			}
+		};
+
+	}
+}
@@ -0,0 +1,293 @@
+/*
+* Licensed to the Apache Software Foundation (ASF) under one or more
+* contributor license agreements.  See the NOTICE file distributed with
+* this work for additional information regarding copyright ownership.
+* The ASF licenses this file to You under the Apache License, Version 2.0
+* (the "License"); you may not use this file except in compliance with
+* the License.  You may obtain a copy of the License at
+*
+*    http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+/**
+ * @file	BlockCompressorTest.cpp
+ * @author	Jichan (development@jc-lab.net / http://ablog.jc-lab.net/ )
+ * @date	2026/10/18
+ * @copyright Copyright (C) 2026 jichan.\n
+ *            This software may be modified and distributed under the terms
+ *            of the Apache License 2.0.  See the LICENSE file for details.
+ */
+
+// The block codec on its own, then compressed payloads of several blocks
+// (one of them stored) through serialize()/deserialize(). Truncated or
+// damaged input must be refused without writing past the output.
+// Exits with a non-zero status on the first failed check.
+
+#include "../Serializable.h"
+#include "../BlockCompressor.h"
+
+#include <stdio.h>
+
+using namespace JsRPC;
+using namespace JsRPC::internal;
+
+#define CHECK(expr) do { if (!(expr)) { fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #expr); return 1; } } while (0)
+
+static uint32_t randomState = 0x12345678;
+
+static uint32_t nextRandom()
+{
+	randomState ^= randomState << 13;
+	randomState ^= randomState >> 17;
+	randomState ^= randomState << 5;
+	return randomState;
+}
+
+static void fillRandom(std::vector<unsigned char> &data, size_t size)
+{
+	size_t i;
+	data.resize(size);
+	for (i = 0; i < size; i++)
+		data[i] = (unsigned char)nextRandom();
+}
+
+// Text-like data: words from a small vocabulary with random bytes in between
+static void fillMixed(std::vector<unsigned char> &data, size_t size)
+{
+	static const char *words[] = { "serializable ", "payload ", "member ", "x", "compress " };
+	data.clear();
+	while (data.size() < size)
+	{
+		const char *word = words[nextRandom() % 5];
+		data.insert(data.end(), word, word + strlen(word));
+		if (!(nextRandom() % 7))
+			data.push_back((unsigned char)nextRandom());
+	}
+	data.resize(size);
+}
+
+static const size_t GUARD_SIZE = 16;
+
+// Decodes into a buffer with guard bytes behind it; false if the codec
+// refused the input or wrote past size
+static bool decode(const std::vector<unsigned char> &compressed, size_t compressedSize, std::vector<unsigned char> &plain, size_t size)
+{
+	bool ok;
+	size_t i;
+	plain.assign(size + GUARD_SIZE, 0xA5);
+	ok = BlockCompressor::decompress(compressed.empty() ? NULL : &compressed[0], compressedSize, &plain[0], size);
+	for (i = size; i < plain.size(); i++)
+	{
+		if (plain[i] != 0xA5)
+			return false;
+	}
+	plain.resize(size);
+	return ok;
+}
+
+static bool roundTrip(const std::vector<unsigned char> &data)
+{
+	std::vector<unsigned char> compressed(BlockCompressor::bound(data.size()));
+	std::vector<unsigned char> plain;
+	unsigned char none = 0;
+	size_t size = BlockCompressor::compress(data.empty() ? &none : &data[0], data.size(), &compressed[0], compressed.size());
+	if (!size || (size > BlockCompressor::bound(data.size())))
+		return false;
+	return decode(compressed, size, plain, data.size()) && (plain == data);
+}
+
+class Blob : public Serializable
+{
+public:
+	SType<std::string> text;
+	SType<std::string> noise;
+	SType<std::vector<int32_t> > numbers;
+	Blob() : Serializable("Blob", 1) {
+		serializableMapMember("text", text);
+		serializableMapMember("noise", noise);
+		serializableMapMember("numbers", numbers);
+	}
+};
+
+template<typename T>
+static bool rejected(const std::vector<unsigned char> &payload)
+{
+	T target;
+	try {
+		target.deserialize(payload);
+	} catch (Serializable::ParseException&) {
+		return true;
+	}
+	return false;
+}
+
+int main()
+{
+	size_t i;
+
+	// Round trips: empty, shorter than the match window, runs where the match
+	// overlaps itself, text, random and a full block
+	{
+		std::vector<unsigned char> data;
+		CHECK(roundTrip(data));
+		data.assign(1, 'a');
+		CHECK(roundTrip(data));
+		data.assign(13, 'a');
+		CHECK(roundTrip(data));
+		data.assign(BlockCompressor::MAX_BLOCK_SIZE, 0);
+		CHECK(roundTrip(data));
+		data.clear();
+		for (i = 0; i < 1000; i++)
+			data.push_back((unsigned char)"abc"[i % 3]);
+		CHECK(roundTrip(data));
+		fillMixed(data, 40000);
+		CHECK(roundTrip(data));
+		fillRandom(data, 300);
+		CHECK(roundTrip(data));
+		fillRandom(data, BlockCompressor::MAX_BLOCK_SIZE);
+		CHECK(roundTrip(data));
+		for (i = 1; i < 600; i += 37)
+		{
+			fillMixed(data, i);
+			CHECK(roundTrip(data));
+		}
+	}
+
+	// compress() refuses oversized input and output it cannot fit
+	{
+		std::vector<unsigned char> data;
+		std::vector<unsigned char> compressed;
+		fillRandom(data, BlockCompressor::MAX_BLOCK_SIZE + 1);
+		compressed.resize(BlockCompressor::bound(data.size()));
+		CHECK(BlockCompressor::compress(&data[0], data.size(), &compressed[0], compressed.size()) == 0);
+		data.resize(4096);
+		CHECK(BlockCompressor::compress(&data[0], data.size(), &compressed[0], data.size() - 1) == 0);
+		fillMixed(data, 4096);
+		size_t size = BlockCompressor::compress(&data[0], data.size(), &compressed[0], compressed.size());
+		CHECK(size > 0 && size < data.size());
+		CHECK(BlockCompressor::compress(&data[0], data.size(), &compressed[0], size - 1) == 0);
+	}
+
+	// Malformed blocks
+	{
+		std::vector<unsigned char> data;
+		std::vector<unsigned char> compressed;
+		std::vector<unsigned char> plain;
+		size_t size;
+		fillMixed(data, 8192);
+		compressed.resize(BlockCompressor::bound(data.size()));
+		size = BlockCompressor::compress(&data[0], data.size(), &compressed[0], compressed.size());
+		compressed.resize(size);
+		CHECK(decode(compressed, size, plain, data.size()) && (plain == data));
+
+		// Every truncation, and a size one short or one over
+		for (i = 0; i < size; i++)
+			CHECK(!decode(compressed, i, plain, data.size()));
+		CHECK(!decode(compressed, size, plain, data.size() - 1));
+		CHECK(!decode(compressed, size, plain, data.size() + 1));
+
+		// A match offset of 0, or reaching in front of the output
+		std::vector<unsigned char> bad;
+		static const unsigned char zeroOffset[] = { 0x14, 'a', 0x00, 0x00, 0x00 };
+		static const unsigned char farOffset[] = { 0x14, 'a', 0x02, 0x00, 0x00 };
+		bad.assign(zeroOffset, zeroOffset + sizeof(zeroOffset));
+		CHECK(!decode(bad, bad.size(), plain, 5));
+		bad.assign(farOffset, farOffset + sizeof(farOffset));
+		CHECK(!decode(bad, bad.size(), plain, 5));
+
+		// Random damage: whatever comes out, nothing is written past the end
+		for (i = 0; i < 2000; i++)
+		{
+			bad = compressed;
+			bad[nextRandom() % bad.size()] = (unsigned char)nextRandom();
+			bad[nextRandom() % bad.size()] ^= (unsigned char)(1 << (nextRandom() % 8));
+			decode(bad, bad.size(), plain, data.size());
+			CHECK(plain.size() == data.size());
+		}
+	}
+
+	// Compressed payloads: several blocks, the random one stored as is
+	{
+		std::vector<unsigned char> noise;
+		std::vector<unsigned char> text;
+		Blob source;
+		std::vector<unsigned char> plain;
+		std::vector<unsigned char> packed;
+		std::vector<unsigned char> expanded;
+		SerializeOptions options;
+		size_t headerSize;
+		uint32_t word;
+
+		fillMixed(text, 3 * BlockCompressor::MAX_BLOCK_SIZE + 100);
+		fillRandom(noise, BlockCompressor::MAX_BLOCK_SIZE);
+		source.text = std::string(text.begin(), text.end());
+		source.noise = std::string(noise.begin(), noise.end());
+		for (i = 0; i < 5000; i++)
+			(*source.numbers).push_back((int32_t)(i * i));
+		source.serialize(plain);
+		options.compressThreshold = 1;
+		source.serialize(packed, options);
+		CHECK(packed[4] & Serializable::HEADER_FLAG_COMPRESSED);
+		CHECK(packed.size() < plain.size());
+		CHECK(Serializable::serializableExpand(&packed[0], packed.size(), expanded));
+		CHECK(expanded == plain);
+		{
+			Blob decoded;
+			std::vector<unsigned char> again;
+			decoded.deserialize(packed);
+			decoded.serialize(again);
+			CHECK(again == plain);
+		}
+
+		// The noise block went out stored
+		bool stored = false;
+		CHECK(Serializable::serializablePeekHeader(&packed[0], packed.size(), NULL, NULL, NULL, &headerSize));
+		size_t pos = headerSize + 4;
+		while (pos + 4 <= packed.size())
+		{
+			memcpy(&word, &packed[pos], 4);
+			if (word & 0x80000000U)
+				stored = true;
+			pos += 4 + (word & ~0x80000000U);
+		}
+		CHECK(pos == packed.size());
+		CHECK(stored);
+
+		// Truncations, a body size that disagrees with the blocks, a block
+		// size word pointing past the end and a trailing byte
+		for (i = headerSize; i < packed.size(); i += 211)
+		{
+			std::vector<unsigned char> bad(packed.begin(), packed.begin() + i);
+			CHECK(rejected<Blob>(bad));
+		}
+		std::vector<unsigned char> bad(packed);
+		memcpy(&word, &bad[headerSize], 4);
+		word += 1;
+		memcpy(&bad[headerSize], &word, 4);
+		CHECK(rejected<Blob>(bad));
+		word -= 2;
+		memcpy(&bad[headerSize], &word, 4);
+		CHECK(rejected<Blob>(bad));
+		word = 0xFFFFFFF0U;
+		memcpy(&bad[headerSize], &word, 4);
+		CHECK(rejected<Blob>(bad));
+		bad = packed;
+		word = 0x7FFFFFFFU;
+		memcpy(&bad[headerSize + 4], &word, 4);
+		CHECK(rejected<Blob>(bad));
+		bad = packed;
+		bad[headerSize + 7] ^= 0x80;
+		CHECK(rejected<Blob>(bad));
+		bad = packed;
+		bad.push_back(0);
+		CHECK(rejected<Blob>(bad));
+	}
+
+	printf("BlockCompressorTest: ok\n");
+	return 0;
+}
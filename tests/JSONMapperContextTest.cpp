@@ -0,0 +1,128 @@
+/*
+* Licensed to the Apache Software Foundation (ASF) under one or more
+* contributor license agreements.  See the NOTICE file distributed with
+* this work for additional information regarding copyright ownership.
+* The ASF licenses this file to You under the Apache License, Version 2.0
+* (the "License"); you may not use this file except in compliance with
+* the License.  You may obtain a copy of the License at
+*
+*    http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+/**
+ * @file	JSONMapperContextTest.cpp
+ * @author	Jichan (development@jc-lab.net / http://ablog.jc-lab.net/ )
+ * @date	2026/10/18
+ * @copyright Copyright (C) 2026 jichan.\n
+ *            This software may be modified and distributed under the terms
+ *            of the Apache License 2.0.  See the LICENSE file for details.
+ */
+
+// The per-thread JSON context: its document can be taken again after use,
+// a mapper call made while a call is running falls back to a temporary
+// context, and document() refuses to reset the pool under a running call.
+// Exits with a non-zero status on the first failed check.
+
+#include "../Serializable.h"
+#include "../plugins/JSONObjectMapper.h"
+
+#include <stdio.h>
+
+using namespace JsRPC;
+
+#define CHECK(expr) do { if (!(expr)) { fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #expr); return 1; } } while (0)
+
+class Item : public Serializable
+{
+public:
+	SType<int32_t> number;
+	SType<std::string> text;
+	Item() : Serializable("Item", 1) {
+		serializableMapMember("number", number);
+		serializableMapMember("text", text);
+	}
+};
+
+// Runs inside deserialize() on the thread's context
+struct ReentrantFactory : public SerializableCreateFactory
+{
+	bool takeDocument;
+	bool busy;
+	std::string nested;
+
+	ReentrantFactory() : takeDocument(false), busy(false) { }
+
+	Serializable *create() {
+		Item *item = new Item();
+		item->number = 5;
+		nested = JSONObjectMapper::serialize(item);
+		if (takeDocument)
+		{
+			try {
+				JSONMapperContext::current().document();
+			} catch (JSONMapperContext::ContextBusyException&) {
+				busy = true;
+			}
+		}
+		return item;
+	}
+};
+static ReentrantFactory factory;
+
+class Holder : public Serializable
+{
+public:
+	SType<std::list<JsCPPUtils::SmartPointer<Serializable> > > items;
+	Holder() : Serializable("Holder", 1) {
+		serializableMapMember("items", items);
+		items.setCreateFactory(&factory);
+	}
+};
+
+int main()
+{
+	JSONMapperContext &context = JSONMapperContext::current();
+
+	// The document is empty each time it is taken
+	{
+		Item item;
+		item.number = 3;
+		item.text = std::string("first");
+		rapidjson::Document &document = context.document();
+		JSONObjectMapper::serializeTo(&item, document);
+		Item decoded;
+		JSONObjectMapper::deserializeJsonObject(&decoded, document);
+		CHECK(*decoded.number == 3);
+
+		rapidjson::Document &again = context.document();
+		CHECK(&again == &document);
+		CHECK(again.IsNull());
+	}
+
+	// A nested mapper call gets a temporary context; document() is refused
+	{
+		const std::string json = "{\"items\":[{\"number\":1,\"text\":\"a\"},{\"number\":2,\"text\":\"b\"}]}";
+		Holder holder;
+		JSONObjectMapper::deserialize(&holder, json);
+		CHECK((*holder.items).size() == 2);
+		CHECK(factory.nested.find("\"number\":5") != std::string::npos);
+		CHECK(!factory.busy);
+
+		factory.takeDocument = true;
+		Holder busy;
+		JSONObjectMapper::deserialize(&busy, json);
+		CHECK(factory.busy);
+		CHECK((*busy.items).size() == 2);
+	}
+
+	// Usable again once the call has returned
+	CHECK(context.document().IsNull());
+
+	printf("JSONMapperContextTest: ok\n");
+	return 0;
+}
@@ -0,0 +1,265 @@
+/*
+* Licensed to the Apache Software Foundation (ASF) under one or more
+* contributor license agreements.  See the NOTICE file distributed with
+* this work for additional information regarding copyright ownership.
+* The ASF licenses this file to You under the Apache License, Version 2.0
+* (the "License"); you may not use this file except in compliance with
+* the License.  You may obtain a copy of the License at
+*
+*    http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+/**
+ * @file	JSONTranscoderTest.cpp
+ * @author	Jichan (development@jc-lab.net / http://ablog.jc-lab.net/ )
+ * @date	2026/10/18
+ * @copyright Copyright (C) 2026 jichan.\n
+ *            This software may be modified and distributed under the terms
+ *            of the Apache License 2.0.  See the LICENSE file for details.
+ */
+
+// Binary <-> JSON through registered schemas: both directions must give the
+// bytes and text Serializable and JSONObjectMapper give, whatever the key
+// order, and malformed input on either side must be rejected.
+// Exits with a non-zero status on the first failed check.
+
+#include "../Serializable.h"
+#include "../plugins/JSONObjectMapper.h"
+#include "../plugins/JSONTranscoder.h"
+
+#include <stdio.h>
+
+using namespace JsRPC;
+
+#define CHECK(expr) do { if (!(expr)) { fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #expr); return 1; } } while (0)
+
+class Inner : public Serializable
+{
+public:
+	SType<int32_t> number;
+	SType<std::string> text;
+	Inner() : Serializable("Inner", 1) {
+		serializableMapMember("number", number);
+		serializableMapMember("text", text);
+	}
+};
+
+struct InnerFactory : public SerializableCreateFactory
+{
+	Serializable *create() {
+		return new Inner();
+	}
+};
+static InnerFactory innerFactory;
+
+class Message : public Serializable
+{
+public:
+	SType<int32_t> id;
+	SType<uint64_t> big;
+	SType<double> ratio;
+	SType<bool> flag;
+	SType<std::string> name;
+	SType<std::wstring> wideName;
+	SSerializableType<Inner> inner;
+	SType<std::list<JsCPPUtils::SmartPointer<Serializable> > > items;
+	SType<std::vector<double> > values;
+	SType<std::list<std::string> > tags;
+	SType<std::list<std::vector<int32_t> > > groups;
+	SArrayType<double, 3> point;
+	SType<int8_t> small;
+	SType<int32_t> missing;
+
+	Message() : Serializable("Message", 3) {
+		serializableMapMember("id", id);
+		serializableMapMember("big", big);
+		serializableMapMember("ratio", ratio);
+		serializableMapMember("flag", flag);
+		serializableMapMember("name", name);
+		serializableMapMember("wideName", wideName);
+		serializableMapMember("inner", inner);
+		serializableMapMember("items", items);
+		items.setCreateFactory(&innerFactory);
+		serializableMapMember("values", values);
+		serializableMapMember("tags", tags);
+		serializableMapMember("groups", groups);
+		serializableMapMember("point", point);
+		serializableMapMember("small", small);
+		serializableMapMember("missing", missing);
+	}
+
+	void fill(bool columnar) {
+		int i;
+		id = -42;
+		big = 18000000000000000000ULL;
+		ratio = 0.1;
+		flag = true;
+		name = std::string("say \"hi\"\n");
+		wideName = std::wstring(L"\xD55C\xAE00");
+		(*inner).number = 7;
+		(*inner).text = std::string("inner");
+		for (i = 0; i < 3; i++)
+		{
+			Inner *item = new Inner();
+			item->number = i;
+			item->text = std::string(i % 2 ? "odd" : "even");
+			(*items).push_back(JsCPPUtils::SmartPointer<Serializable>(item));
+		}
+		if (columnar)
+			items.setColumnar();
+		(*values).push_back(1.5);
+		(*values).push_back(-2.25);
+		(*tags).push_back("a");
+		(*tags).push_back("b");
+		(*groups).push_back(std::vector<int32_t>(2, 9));
+		(*groups).push_back(std::vector<int32_t>());
+		point[0] = 1.0;
+		point[1] = -0.5;
+		point[2] = 1e300;
+		small = -3;
+		missing.setNull();
+	}
+};
+
+static const char *fromJson(const JSONTranscoder &transcoder, const char *json, std::vector<unsigned char> &payload)
+{
+	try {
+		transcoder.fromJson("Message", std::string(json), payload);
+	} catch (JSONObjectMapper::TypeNotMatchException&) {
+		return "type";
+	} catch (JSONObjectMapper::DataOverrflowException&) {
+		return "overflow";
+	} catch (JSONObjectMapper::ParseException&) {
+		return "parse";
+	} catch (JSONTranscoder::TypeNotRegisteredException&) {
+		return "unregistered";
+	}
+	return "ok";
+}
+
+static bool sameAs(const JSONTranscoder &transcoder, const char *json, const char *expected)
+{
+	std::vector<unsigned char> left;
+	std::vector<unsigned char> right;
+	return !strcmp(fromJson(transcoder, json, left), "ok")
+		&& !strcmp(fromJson(transcoder, expected, right), "ok")
+		&& (left == right);
+}
+
+int main()
+{
+	JSONTranscoder transcoder;
+	transcoder.registerType<Message>();
+	CHECK(transcoder.findSchema("Inner", 5) != NULL);
+
+	Message source;
+	Message columnar;
+	std::vector<unsigned char> payload;
+	std::vector<unsigned char> columnarPayload;
+	source.fill(false);
+	columnar.fill(true);
+	source.serialize(payload);
+	columnar.serialize(columnarPayload);
+	std::string json = JSONObjectMapper::serialize(&source);
+
+	// Binary -> JSON, plain, columnar, compressed and interned
+	{
+		SerializeOptions options;
+		std::vector<unsigned char> packed;
+		options.compressThreshold = 1;
+		options.internStrings = true;
+		columnar.serialize(packed, options);
+		CHECK(transcoder.toJson(payload) == json);
+		CHECK(transcoder.toJson(columnarPayload) == json);
+		CHECK(transcoder.toJson(packed) == json);
+	}
+
+	// JSON -> binary, from text and from a DOM
+	{
+		std::vector<unsigned char> encoded;
+		CHECK(!strcmp(fromJson(transcoder, json.c_str(), encoded), "ok"));
+		CHECK(encoded == payload);
+
+		rapidjson::Document document;
+		JSONObjectMapper::serializeTo(&source, document);
+		encoded.clear();
+		transcoder.fromJson("Message", document, encoded);
+		CHECK(encoded == payload);
+
+		Message decoded;
+		decoded.deserialize(encoded);
+		CHECK(JSONObjectMapper::serialize(&decoded) == json);
+	}
+
+	// Key order, unknown keys, missing members and repeated keys
+	{
+		CHECK(sameAs(transcoder,
+			"{\"small\":1,\"inner\":{\"text\":\"t\",\"number\":2},\"unknown\":[{\"a\":[1]}],\"id\":3}",
+			"{\"id\":3,\"inner\":{\"number\":2,\"text\":\"t\"},\"small\":1}"));
+		CHECK(sameAs(transcoder,
+			"{\"id\":1,\"big\":2,\"id\":5,\"items\":[{\"number\":1,\"number\":2}],\"big\":6}",
+			"{\"id\":5,\"big\":6,\"items\":[{\"number\":2}]}"));
+		CHECK(sameAs(transcoder, "{\"missing\":null,\"inner\":null}", "{}"));
+	}
+
+	// Malformed JSON
+	{
+		std::vector<unsigned char> encoded;
+		CHECK(!strcmp(fromJson(transcoder, "{\"id\":", encoded), "parse"));
+		CHECK(!strcmp(fromJson(transcoder, "{\"id\":1}x", encoded), "parse"));
+		CHECK(!strcmp(fromJson(transcoder, "[]", encoded), "type"));
+		CHECK(!strcmp(fromJson(transcoder, "{\"id\":\"1\"}", encoded), "type"));
+		CHECK(!strcmp(fromJson(transcoder, "{\"id\":1.5}", encoded), "type"));
+		CHECK(!strcmp(fromJson(transcoder, "{\"big\":-1}", encoded), "type"));
+		CHECK(!strcmp(fromJson(transcoder, "{\"small\":200}", encoded), "overflow"));
+		CHECK(!strcmp(fromJson(transcoder, "{\"point\":[1,2]}", encoded), "type"));
+		CHECK(!strcmp(fromJson(transcoder, "{\"point\":[1,2,3,4]}", encoded), "type"));
+		CHECK(!strcmp(fromJson(transcoder, "{\"inner\":[]}", encoded), "type"));
+		CHECK(!strcmp(fromJson(transcoder, "{\"items\":[1]}", encoded), "type"));
+		CHECK(!strcmp(fromJson(transcoder, "{\"groups\":[[\"x\"]]}", encoded), "type"));
+		try {
+			transcoder.fromJson("Unknown", std::string("{}"), encoded);
+			CHECK(false);
+		} catch (JSONTranscoder::TypeNotRegisteredException&) {
+		}
+	}
+
+	// Malformed binary: every truncation and a wrong serialVersionUID
+	{
+		size_t size;
+		for (size = 0; size < payload.size(); size++)
+		{
+			std::vector<unsigned char> truncated(payload.begin(), payload.begin() + size);
+			try {
+				transcoder.toJson(truncated);
+			} catch (Serializable::ParseException&) {
+			}
+		}
+		std::vector<unsigned char> wrong(payload);
+		wrong[6 + 1 + 7] ^= 1;
+		try {
+			transcoder.toJson(wrong);
+			CHECK(false);
+		} catch (Serializable::ParseException&) {
+		}
+	}
+
+	// Parsing does not touch a document the caller took from the thread's context
+	{
+		rapidjson::Document &document = JSONMapperContext::current().document();
+		JSONObjectMapper::serializeTo(&source, document);
+		std::vector<unsigned char> encoded;
+		CHECK(!strcmp(fromJson(transcoder, "{\"id\":1}", encoded), "ok"));
+		Message decoded;
+		JSONObjectMapper::deserializeJsonObject(&decoded, document);
+		CHECK(JSONObjectMapper::serialize(&decoded) == json);
+	}
+
+	printf("JSONTranscoderTest: ok\n");
+	return 0;
+}
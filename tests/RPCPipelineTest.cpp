@@ -0,0 +1,176 @@
+/*
+* Licensed to the Apache Software Foundation (ASF) under one or more
+* contributor license agreements.  See the NOTICE file distributed with
+* this work for additional information regarding copyright ownership.
+* The ASF licenses this file to You under the Apache License, Version 2.0
+* (the "License"); you may not use this file except in compliance with
+* the License.  You may obtain a copy of the License at
+*
+*    http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+/**
+ * @file	RPCPipelineTest.cpp
+ * @author	Jichan (development@jc-lab.net / http://ablog.jc-lab.net/ )
+ * @date	2026/10/18
+ * @copyright Copyright (C) 2026 jichan.\n
+ *            This software may be modified and distributed under the terms
+ *            of the Apache License 2.0.  See the LICENSE file for details.
+ */
+
+// Round trip of RPCPipeline against RPCDispatcher::dispatchEnvelope over
+// RPCMemoryTransport. Exits with a non-zero status on the first failed check.
+
+#include "../RPCPipeline.h"
+#include "../RPCDispatcher.h"
+
+#include <stdio.h>
+
+#include <thread>
+
+using namespace JsRPC;
+
+#define CHECK(expr) do { if (!(expr)) { fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #expr); return 1; } } while (0)
+
+class EchoRequest : public Serializable
+{
+public:
+	SType<int32_t> value;
+	EchoRequest() : Serializable("EchoRequest", 1) {
+		serializableMapMember("value", value);
+	}
+};
+
+class EchoResponse : public Serializable
+{
+public:
+	SType<int32_t> value;
+	EchoResponse() : Serializable("EchoResponse", 1) {
+		serializableMapMember("value", value);
+	}
+};
+
+class NoticeRequest : public Serializable
+{
+public:
+	SType<int32_t> value;
+	NoticeRequest() : Serializable("NoticeRequest", 1) {
+		serializableMapMember("value", value);
+	}
+};
+
+template<class TResponse>
+static int waitStatus(std::future< std::shared_ptr<TResponse> > &future)
+{
+	try {
+		future.get();
+		return RPCPipeline::STATUS_OK;
+	} catch (RPCPipeline::RemoteErrorException&) {
+		return RPCPipeline::STATUS_REMOTE_ERROR;
+	} catch (RPCPipeline::ConnectionClosedException&) {
+		return RPCPipeline::STATUS_CLOSED;
+	}
+}
+
+// The checks run while the reader thread of main() is receiving
+static int runChecks(RPCMemoryTransport &server, RPCDispatcher &dispatcher, RPCPipeline &pipeline, const int &notices)
+{
+	std::vector< std::future< std::shared_ptr<EchoResponse> > > futures;
+	std::vector<unsigned char> frame;
+	std::vector<unsigned char> response;
+	std::vector< std::vector<unsigned char> > responses;
+	int i;
+
+	// Requests are answered in reverse order
+	for (i = 0; i < 4; i++)
+	{
+		EchoRequest request;
+		request.value = i;
+		futures.push_back(pipeline.call<EchoResponse>(request));
+	}
+	for (i = 0; i < 4; i++)
+	{
+		CHECK(server.receiveFrame(frame));
+		CHECK(dispatcher.dispatchEnvelope(&frame[0], frame.size(), response));
+		responses.push_back(response);
+	}
+	for (i = 3; i >= 0; i--)
+		CHECK(server.sendFrame(&responses[i][0], responses[i].size()));
+	for (i = 3; i >= 0; i--)
+		CHECK(futures[i].get()->value.get() == i * 2);
+
+	// One-way request sent as a notification
+	{
+		NoticeRequest request;
+		request.value = 5;
+		pipeline.notify(request);
+		CHECK(server.receiveFrame(frame));
+		CHECK(!dispatcher.dispatchEnvelope(&frame[0], frame.size(), response));
+		CHECK(notices == 5);
+	}
+
+	// One-way handler, but the caller waits for a response
+	{
+		NoticeRequest request;
+		request.value = 1;
+		std::future< std::shared_ptr<EchoResponse> > future = pipeline.call<EchoResponse>(request);
+		CHECK(server.receiveFrame(frame));
+		CHECK(dispatcher.dispatchEnvelope(&frame[0], frame.size(), response));
+		CHECK(server.sendFrame(&response[0], response.size()));
+		CHECK(waitStatus(future) == RPCPipeline::STATUS_REMOTE_ERROR);
+	}
+
+	// close() fails what is still in flight and rejects new requests
+	{
+		EchoRequest request;
+		request.value = 7;
+		std::future< std::shared_ptr<EchoResponse> > future = pipeline.call<EchoResponse>(request);
+		CHECK(server.receiveFrame(frame));
+		pipeline.close();
+		CHECK(waitStatus(future) == RPCPipeline::STATUS_CLOSED);
+		CHECK(pipeline.pendingCount() == 0);
+		try {
+			pipeline.call<EchoResponse>(request);
+			CHECK(false);
+		} catch (RPCPipeline::ConnectionClosedException&) {
+		}
+	}
+	return 0;
+}
+
+int main()
+{
+	RPCMemoryTransport client;
+	RPCMemoryTransport server;
+	RPCDispatcher dispatcher;
+	RPCPipeline pipeline(client);
+	int notices = 0;
+	int result;
+
+	client.connect(server);
+	dispatcher.registerHandler<EchoRequest, EchoResponse>([](const EchoRequest &request, EchoResponse &response) {
+		response.value = *request.value * 2;
+	});
+	dispatcher.registerHandler<NoticeRequest>([&notices](const NoticeRequest &request) {
+		notices += *request.value;
+	});
+
+	std::thread reader([&pipeline]() {
+		while (pipeline.receive());
+	});
+
+	result = runChecks(server, dispatcher, pipeline, notices);
+
+	// The reader is joined whether or not a check failed
+	pipeline.close();
+	client.close();
+	reader.join();
+	if (!result)
+		printf("RPCPipelineTest: ok\n");
+	return result;
+}
@@ -0,0 +1,119 @@
+/*
+* Licensed to the Apache Software Foundation (ASF) under one or more
+* contributor license agreements.  See the NOTICE file distributed with
+* this work for additional information regarding copyright ownership.
+* The ASF licenses this file to You under the Apache License, Version 2.0
+* (the "License"); you may not use this file except in compliance with
+* the License.  You may obtain a copy of the License at
+*
+*    http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+/**
+ * @file	SerializableArrayTest.cpp
+ * @author	Jichan (development@jc-lab.net / http://ablog.jc-lab.net/ )
+ * @date	2026/10/18
+ * @copyright Copyright (C) 2026 jichan.\n
+ *            This software may be modified and distributed under the terms
+ *            of the Apache License 2.0.  See the LICENSE file for details.
+ */
+
+// Native array members through the binary codec and through both JSON paths
+// (string writer and DOM), including a double array large enough that the
+// formatting buffer is not kept afterwards.
+// Exits with a non-zero status on the first failed check.
+
+#include "../Serializable.h"
+#include "../plugins/JSONObjectMapper.h"
+
+#include <stdio.h>
+
+using namespace JsRPC;
+
+#define CHECK(expr) do { if (!(expr)) { fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #expr); return 1; } } while (0)
+
+class Arrays : public Serializable
+{
+public:
+	SArrayType<double, 3> point;
+	SArrayType<float, 2> pair;
+	SArrayType<int32_t, 4> counts;
+	SArrayType<uint8_t, 2> flags;
+	SArrayType<double, 4096> samples;
+
+	Arrays() : Serializable("Arrays", 1) {
+		serializableMapMember("point", point);
+		serializableMapMember("pair", pair);
+		serializableMapMember("counts", counts);
+		serializableMapMember("flags", flags);
+		serializableMapMember("samples", samples);
+	}
+
+	void fill() {
+		int i;
+		point[0] = 1.5;
+		point[1] = -0.1;
+		point[2] = 6.02214076e23;
+		pair[0] = 0.25f;
+		pair[1] = -3.0f;
+		for (i = 0; i < 4; i++)
+			counts[i] = i * 1000 - 7;
+		flags[0] = 0;
+		flags[1] = 255;
+		for (i = 0; i < 4096; i++)
+			samples[i] = i / 3.0;
+	}
+
+	bool same(const Arrays &other) const {
+		return memcmp(*point, *other.point, sizeof(*point)) == 0
+			&& memcmp(*pair, *other.pair, sizeof(*pair)) == 0
+			&& memcmp(*counts, *other.counts, sizeof(*counts)) == 0
+			&& memcmp(*flags, *other.flags, sizeof(*flags)) == 0
+			&& memcmp(*samples, *other.samples, sizeof(*samples)) == 0;
+	}
+};
+
+int main()
+{
+	Arrays source;
+	source.fill();
+
+	// Binary
+	{
+		std::vector<unsigned char> payload;
+		std::vector<unsigned char> again;
+		Arrays decoded;
+		source.serialize(payload);
+		decoded.deserialize(payload);
+		CHECK(decoded.same(source));
+		decoded.serialize(again);
+		CHECK(again == payload);
+	}
+
+	// JSON through the string writer, twice so the second call starts from
+	// whatever the first left behind
+	{
+		std::string json = JSONObjectMapper::serialize(&source);
+		CHECK(JSONObjectMapper::serialize(&source) == json);
+		Arrays decoded;
+		JSONObjectMapper::deserialize(&decoded, json);
+		CHECK(decoded.same(source));
+	}
+
+	// JSON through the DOM
+	{
+		rapidjson::Document document;
+		JSONObjectMapper::serializeTo(&source, document);
+		Arrays decoded;
+		JSONObjectMapper::deserializeJsonObject(&decoded, document);
+		CHECK(decoded.same(source));
+	}
+
+	printf("SerializableArrayTest: ok\n");
+	return 0;
+}
@@ -0,0 +1,111 @@
+/*
+* Licensed to the Apache Software Foundation (ASF) under one or more
+* contributor license agreements.  See the NOTICE file distributed with
+* this work for additional information regarding copyright ownership.
+* The ASF licenses this file to You under the Apache License, Version 2.0
+* (the "License"); you may not use this file except in compliance with
+* the License.  You may obtain a copy of the License at
+*
+*    http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+/**
+ * @file	SerializableCacheTest.cpp
+ * @author	Jichan (development@jc-lab.net / http://ablog.jc-lab.net/ )
+ * @date	2026/10/18
+ * @copyright Copyright (C) 2026 jichan.\n
+ *            This software may be modified and distributed under the terms
+ *            of the Apache License 2.0.  See the LICENSE file for details.
+ */
+
+// Encoded-bytes cache: invalidation through the member wrappers, references
+// kept across serialize(), and toggling the cache while another thread encodes.
+// Exits with a non-zero status on the first failed check.
+
+#include "../Serializable.h"
+
+#include <stdio.h>
+
+#include <atomic>
+#include <thread>
+
+using namespace JsRPC;
+
+#define CHECK(expr) do { if (!(expr)) { fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #expr); return 1; } } while (0)
+
+class Row : public Serializable
+{
+public:
+	SType<int32_t> number;
+	SType<std::string> text;
+	Row() : Serializable("Row", 1) {
+		serializableMapMember("number", number);
+		serializableMapMember("text", text);
+	}
+};
+
+static bool decodesTo(const std::vector<unsigned char> &payload, int32_t number, const char *text)
+{
+	Row row;
+	row.deserialize(payload);
+	return (*row.number == number) && (*row.text == text);
+}
+
+int main()
+{
+	Row row;
+	std::vector<unsigned char> payload;
+
+	row.serializableSetCacheEnabled(true);
+	row.number = 1;
+	row.text = std::string("x");
+	row.serialize(payload);
+	CHECK(decodesTo(payload, 1, "x"));
+
+	// A reference taken after serialize() invalidates when it is handed out
+	*row.number = 7;
+	*row.text = "changed";
+	row.serialize(payload);
+	CHECK(decodesTo(payload, 7, "changed"));
+
+	// A reference kept across serialize() needs an explicit invalidation
+	{
+		int32_t &number = *row.number;
+		std::string &text = *row.text;
+		row.serialize(payload);
+		number = 8;
+		text = "kept";
+		row.serializableInvalidateCache();
+		row.serialize(payload);
+		CHECK(decodesTo(payload, 8, "kept"));
+	}
+
+	// Toggling the cache while another thread encodes
+	{
+		std::atomic<bool> done(false);
+		std::atomic<int> wrong(0);
+		std::thread encoder([&row, &done, &wrong]() {
+			std::vector<unsigned char> encoded;
+			while (!done.load())
+			{
+				row.freeze();
+				row.serialize(encoded);
+				if (!decodesTo(encoded, 8, "kept"))
+					wrong++;
+			}
+		});
+		for (int i = 0; i < 10000; i++)
+			row.serializableSetCacheEnabled((i & 1) != 0);
+		done = true;
+		encoder.join();
+		CHECK(wrong.load() == 0);
+	}
+
+	printf("SerializableCacheTest: ok\n");
+	return 0;
+}
@@ -0,0 +1,326 @@
+/*
+* Licensed to the Apache Software Foundation (ASF) under one or more
+* contributor license agreements.  See the NOTICE file distributed with
+* this work for additional information regarding copyright ownership.
+* The ASF licenses this file to You under the Apache License, Version 2.0
+* (the "License"); you may not use this file except in compliance with
+* the License.  You may obtain a copy of the License at
+*
+*    http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+/**
+ * @file	SerializableColumnarTest.cpp
+ * @author	Jichan (development@jc-lab.net / http://ablog.jc-lab.net/ )
+ * @date	2026/10/18
+ * @copyright Copyright (C) 2026 jichan.\n
+ *            This software may be modified and distributed under the terms
+ *            of the Apache License 2.0.  See the LICENSE file for details.
+ */
+
+// Columnar lists: each column encoding (raw, delta, rows, with a null
+// bitmap) decodes to the same objects as the row-wise encoding, lists that
+// cannot be written by column fall back to rows, and damaged counts, column
+// headers and varints are rejected.
+// Exits with a non-zero status on the first failed check.
+
+#include "../Serializable.h"
+
+#include <stdio.h>
+
+using namespace JsRPC;
+
+#define CHECK(expr) do { if (!(expr)) { fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #expr); return 1; } } while (0)
+
+class Sample : public Serializable
+{
+public:
+	SType<int64_t> time;
+	SType<int32_t> value;
+	SType<double> ratio;
+	SType<bool> flag;
+	SType<int32_t> maybe;
+	SType<std::string> name;
+	SType<std::vector<int16_t> > points;
+	Sample() : Serializable("Sample", 1) {
+		serializableMapMember("time", time);
+		serializableMapMember("value", value);
+		serializableMapMember("ratio", ratio);
+		serializableMapMember("flag", flag);
+		serializableMapMember("maybe", maybe);
+		serializableMapMember("name", name);
+		serializableMapMember("points", points);
+	}
+};
+
+class Other : public Serializable
+{
+public:
+	SType<int32_t> value;
+	Other() : Serializable("Other", 1) {
+		serializableMapMember("value", value);
+	}
+};
+
+struct SampleFactory : public SerializableCreateFactory
+{
+	Serializable *create() {
+		return new Sample();
+	}
+};
+static SampleFactory sampleFactory;
+
+class Batch : public Serializable
+{
+public:
+	SType<std::list<JsCPPUtils::SmartPointer<Serializable> > > samples;
+	SType<int32_t> after;
+	Batch(bool columnar = true) : Serializable("Batch", 1) {
+		serializableMapMember("samples", samples);
+		samples.setCreateFactory(&sampleFactory);
+		if (columnar)
+			samples.setColumnar();
+		serializableMapMember("after", after);
+		after = 77;
+	}
+
+	void fill(size_t count) {
+		static const char *names[] = { "cpu", "memory", "" };
+		uint32_t random = 0x9E3779B9;
+		size_t i;
+		for (i = 0; i < count; i++)
+		{
+			Sample *sample = new Sample();
+			random = random * 1664525 + 1013904223;
+			sample->time = 1700000000000LL + (int64_t)i * 1000 + (int64_t)(i % 3);
+			sample->value = (int32_t)random;
+			sample->ratio = i / 7.0;
+			sample->flag = (i % 3) == 0;
+			if (i % 4 == 1)
+				sample->maybe.setNull();
+			else
+				sample->maybe = (int32_t)(i * 3);
+			sample->name = std::string(names[i % 3]);
+			(*sample->points).assign(i % 4, (int16_t)-i);
+			(*samples).push_back(JsCPPUtils::SmartPointer<Serializable>(sample));
+		}
+	}
+};
+
+struct Column {
+	size_t pos;
+	uint16_t etype;
+	unsigned char encoding;
+	uint32_t size;
+};
+
+// Offsets of the row count and of every column header of the columnar list
+// at the front of a Batch payload
+static bool columns(const std::vector<unsigned char> &payload, size_t *countPos, std::vector<Column> &out)
+{
+	size_t headerSize;
+	size_t pos;
+	size_t end;
+	uint32_t size;
+	uint16_t etype;
+	out.clear();
+	if (!Serializable::serializablePeekHeader(&payload[0], payload.size(), NULL, NULL, NULL, &headerSize))
+		return false;
+	pos = headerSize;
+	memcpy(&etype, &payload[pos + 4], 2);
+	if (etype != internal::SerializableMemberInfo::EncapType::ETYPE_COLUMNAR)
+		return false;
+	*countPos = pos + 6;
+	pos += 10;
+	memcpy(&size, &payload[pos], 4);
+	pos += 4;
+	end = pos + size;
+	if (!Serializable::serializablePeekHeader(&payload[pos], size, NULL, NULL, NULL, &headerSize))
+		return false;
+	pos += headerSize;
+	while (pos < end)
+	{
+		Column column;
+		column.pos = pos;
+		memcpy(&column.etype, &payload[pos], 2);
+		column.encoding = payload[pos + 2];
+		memcpy(&column.size, &payload[pos + 3], 4);
+		out.push_back(column);
+		pos += 7 + column.size;
+	}
+	return pos == end;
+}
+
+static bool rejected(const std::vector<unsigned char> &payload)
+{
+	Batch target;
+	try {
+		target.deserialize(payload);
+	} catch (Serializable::ParseException&) {
+		return true;
+	}
+	return false;
+}
+
+// Decodes payload into a batch of either kind and encodes it again
+static bool decodesTo(const std::vector<unsigned char> &payload, bool columnar, const std::vector<unsigned char> &expected)
+{
+	Batch target(columnar);
+	std::vector<unsigned char> again;
+	target.deserialize(payload);
+	target.serialize(again);
+	return again == expected;
+}
+
+static void writeWord(std::vector<unsigned char> &payload, size_t pos, uint32_t word)
+{
+	memcpy(&payload[pos], &word, 4);
+}
+
+int main()
+{
+	typedef internal::SerializableMemberInfo::EncapType EncapType;
+	size_t i;
+
+	Batch source;
+	Batch rowSource(false);
+	std::vector<unsigned char> payload;
+	std::vector<unsigned char> rowPayload;
+	std::vector<Column> header;
+	size_t countPos;
+	source.fill(50);
+	rowSource.fill(50);
+	source.serialize(payload);
+	rowSource.serialize(rowPayload);
+
+	// One column per member, each with the encoding its data calls for
+	{
+		CHECK(columns(payload, &countPos, header));
+		CHECK(header.size() == 7);
+		CHECK(header[0].etype == (EncapType::ETYPE_NATIVE | EncapType::ETYPE_SINT | 8));
+		CHECK(header[0].encoding == internal::COLUMN_DELTA);
+		CHECK(header[1].encoding == internal::COLUMN_RAW);
+		CHECK(header[2].etype == (EncapType::ETYPE_NATIVE | EncapType::ETYPE_DOUBLE));
+		CHECK(header[2].encoding == internal::COLUMN_RAW);
+		CHECK(header[4].etype == (EncapType::ETYPE_NULL | EncapType::ETYPE_NATIVE | EncapType::ETYPE_SINT | 4));
+		CHECK(header[4].encoding == internal::COLUMN_DELTA);
+		CHECK(header[5].encoding == internal::COLUMN_ROWS);
+		CHECK(header[6].encoding == internal::COLUMN_ROWS);
+		CHECK(payload.size() < rowPayload.size());
+	}
+
+	// Either encoding decodes into either kind of batch
+	CHECK(decodesTo(payload, true, payload));
+	CHECK(decodesTo(payload, false, rowPayload));
+	CHECK(decodesTo(rowPayload, true, payload));
+
+	// One row, no rows, extreme integer steps and a column of nulls only
+	{
+		Batch small;
+		std::vector<unsigned char> encoded;
+		small.fill(1);
+		small.serialize(encoded);
+		CHECK(decodesTo(encoded, true, encoded));
+
+		Batch empty;
+		empty.serialize(encoded);
+		CHECK(decodesTo(encoded, true, encoded));
+
+		Batch extreme;
+		extreme.fill(9);
+		i = 0;
+		for (std::list<JsCPPUtils::SmartPointer<Serializable> >::iterator iter = (*extreme.samples).begin(); iter != (*extreme.samples).end(); iter++, i++)
+		{
+			Sample *sample = (Sample*)iter->getPtr();
+			sample->time = (i % 2) ? INT64_MIN : INT64_MAX;
+			sample->value = (i % 2) ? INT32_MIN : 0;
+			sample->maybe.setNull();
+		}
+		extreme.serialize(encoded);
+		CHECK(decodesTo(encoded, true, encoded));
+	}
+
+	// A null element or a second class keeps the list row-wise
+	{
+		Batch mixed;
+		std::vector<unsigned char> encoded;
+		std::vector<Column> none;
+		mixed.fill(3);
+		(*mixed.samples).push_back(JsCPPUtils::SmartPointer<Serializable>());
+		mixed.serialize(encoded);
+		CHECK(!columns(encoded, &countPos, none));
+		CHECK(decodesTo(encoded, true, encoded));
+
+		Batch other;
+		other.fill(3);
+		(*other.samples).push_back(JsCPPUtils::SmartPointer<Serializable>(new Other()));
+		other.serialize(encoded);
+		CHECK(!columns(encoded, &countPos, none));
+	}
+
+	// Damaged row counts: one more or one fewer, and one too large to allocate
+	CHECK(columns(payload, &countPos, header));
+	{
+		std::vector<unsigned char> bad(payload);
+		writeWord(bad, countPos, 51);
+		CHECK(rejected(bad));
+		writeWord(bad, countPos, 49);
+		CHECK(rejected(bad));
+		writeWord(bad, countPos, 0xFFFFFFFFU);
+		CHECK(rejected(bad));
+	}
+
+	// Damaged column headers
+	{
+		std::vector<unsigned char> bad(payload);
+		// An encoding that does not exist, and delta on a double column
+		bad[header[0].pos + 2] = 3;
+		CHECK(rejected(bad));
+		bad = payload;
+		bad[header[2].pos + 2] = internal::COLUMN_DELTA;
+		CHECK(rejected(bad));
+		// Column etypes that are not the member's
+		uint16_t etype = EncapType::ETYPE_NATIVE | EncapType::ETYPE_SINT | 8;
+		bad = payload;
+		memcpy(&bad[header[1].pos], &etype, 2);
+		CHECK(rejected(bad));
+		bad = payload;
+		bad[header[4].pos + 1] &= 0x7F;
+		CHECK(rejected(bad));
+		// Column sizes that overrun the column or the list
+		for (i = 0; i < header.size(); i++)
+		{
+			bad = payload;
+			writeWord(bad, header[i].pos + 3, header[i].size + 1);
+			CHECK(rejected(bad));
+			writeWord(bad, header[i].pos + 3, header[i].size - 1);
+			CHECK(rejected(bad));
+		}
+		// The row class header must be plain
+		bad = payload;
+		bad[countPos + 8 + 4] = Serializable::HEADER_FLAG_CHECKSUM;
+		CHECK(rejected(bad));
+	}
+
+	// A delta varint that never ends
+	{
+		std::vector<unsigned char> bad(payload);
+		memset(&bad[header[0].pos + 7], 0x80, header[0].size);
+		CHECK(rejected(bad));
+	}
+
+	// Every truncation
+	for (i = 0; i < payload.size(); i++)
+	{
+		std::vector<unsigned char> truncated(payload.begin(), payload.begin() + i);
+		CHECK(rejected(truncated));
+	}
+
+	printf("SerializableColumnarTest: ok\n");
+	return 0;
+}
@@ -0,0 +1,192 @@
+/*
+* Licensed to the Apache Software Foundation (ASF) under one or more
+* contributor license agreements.  See the NOTICE file distributed with
+* this work for additional information regarding copyright ownership.
+* The ASF licenses this file to You under the Apache License, Version 2.0
+* (the "License"); you may not use this file except in compliance with
+* the License.  You may obtain a copy of the License at
+*
+*    http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+/**
+ * @file	SerializableCopyTest.cpp
+ * @author	Jichan (development@jc-lab.net / http://ablog.jc-lab.net/ )
+ * @date	2026/10/18
+ * @copyright Copyright (C) 2026 jichan.\n
+ *            This software may be modified and distributed under the terms
+ *            of the Apache License 2.0.  See the LICENSE file for details.
+ */
+
+// Copy/move construction with explicit member rebinding, assignment through a
+// base reference, and the objects that must refuse to encode: sliced copies
+// and copies made by an implicit copy constructor.
+// Exits with a non-zero status on the first failed check.
+
+#include "../Serializable.h"
+
+#include <stdio.h>
+
+using namespace JsRPC;
+
+#define CHECK(expr) do { if (!(expr)) { fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #expr); return 1; } } while (0)
+
+class Inner : public Serializable
+{
+public:
+	SType<int32_t> number;
+	Inner() : Serializable("Inner", 1) {
+		serializableMapMember("number", number);
+	}
+};
+
+class Base : public Serializable
+{
+public:
+	SType<std::string> name;
+	SSerializableType<Inner> inner;
+
+	Base() : Serializable("Base", 1) {
+		mapMembers();
+	}
+	Base(const Base &obj) : Serializable(obj), name(obj.name), inner(obj.inner) {
+		rebindMembers();
+	}
+	Base(Base &&obj) : Serializable(std::move(obj)), name(std::move(obj.name)), inner(std::move(obj.inner)) {
+		rebindMembers();
+	}
+	Base &operator=(const Base &obj) = default;
+	Base &operator=(Base &&obj) = default;
+
+protected:
+	Base(const char *className, int64_t serialVersionUID) : Serializable(className, serialVersionUID) {
+		mapMembers();
+	}
+
+private:
+	void mapMembers() {
+		serializableMapMember("name", name);
+		serializableMapMember("inner", inner);
+	}
+	void rebindMembers() {
+		serializableRebindMember(name);
+		serializableRebindMember(inner);
+	}
+};
+
+class Derived : public Base
+{
+public:
+	SType<std::vector<double>> values;
+
+	Derived() : Base("Derived", 1) {
+		serializableMapMember("values", values);
+	}
+	Derived(const Derived &obj) : Base(obj), values(obj.values) {
+		serializableRebindMember(values);
+	}
+	Derived(Derived &&obj) : Base(std::move(obj)), values(std::move(obj.values)) {
+		serializableRebindMember(values);
+	}
+	Derived &operator=(const Derived &obj) = default;
+	Derived &operator=(Derived &&obj) = default;
+};
+
+// Relies on the implicit copy constructor, so its copies are never complete
+class Implicit : public Serializable
+{
+public:
+	SType<int32_t> number;
+	Implicit() : Serializable("Implicit", 1) {
+		serializableMapMember("number", number);
+	}
+};
+
+static bool sameBytes(const Serializable &a, const Serializable &b)
+{
+	std::vector<unsigned char> left;
+	std::vector<unsigned char> right;
+	a.serialize(left);
+	b.serialize(right);
+	return left == right;
+}
+
+int main()
+{
+	Derived source;
+	source.name = std::string("source");
+	(*source.inner).number = 3;
+	(*source.values).assign(100, 1.5);
+
+	// Copy and move construction
+	{
+		Derived copy(source);
+		CHECK(sameBytes(copy, source));
+		*(*copy.inner).number = 4;
+		CHECK(*(*source.inner).number == 3);
+
+		const double *storage = &(*copy.values)[0];
+		Derived moved(std::move(copy));
+		CHECK(&(*moved.values)[0] == storage);
+		CHECK(*(*moved.inner).number == 4);
+		std::vector<unsigned char> payload;
+		moved.serialize(payload);
+		Derived decoded;
+		decoded.deserialize(payload);
+		CHECK(*(*decoded.inner).number == 4);
+	}
+
+	// Implicit and base-reference assignment
+	{
+		Derived target;
+		target = source;
+		CHECK(sameBytes(target, source));
+
+		Derived temporary(source);
+		Derived moved;
+		moved = std::move(temporary);
+		CHECK(sameBytes(moved, source));
+
+		Derived other;
+		Serializable &reference = other;
+		reference = source;
+		CHECK(sameBytes(other, source));
+
+		Inner unrelated;
+		Serializable &wrong = unrelated;
+		try {
+			wrong = source;
+			CHECK(false);
+		} catch (Serializable::UnavailableTypeException&) {
+		}
+	}
+
+	// A sliced copy and an implicit copy have members that were never rebound
+	{
+		std::vector<unsigned char> payload;
+		Base sliced(source);
+		try {
+			sliced.serialize(payload);
+			CHECK(false);
+		} catch (Serializable::UnavailableTypeException&) {
+		}
+
+		Implicit original;
+		original.number = 1;
+		original.serialize(payload);
+		Implicit copy(original);
+		try {
+			copy.deserialize(payload);
+			CHECK(false);
+		} catch (Serializable::ParseException&) {
+		}
+	}
+
+	printf("SerializableCopyTest: ok\n");
+	return 0;
+}
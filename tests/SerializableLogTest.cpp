@@ -0,0 +1,172 @@
+/*
+* Licensed to the Apache Software Foundation (ASF) under one or more
+* contributor license agreements.  See the NOTICE file distributed with
+* this work for additional information regarding copyright ownership.
+* The ASF licenses this file to You under the Apache License, Version 2.0
+* (the "License"); you may not use this file except in compliance with
+* the License.  You may obtain a copy of the License at
+*
+*    http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+/**
+ * @file	SerializableLogTest.cpp
+ * @author	Jichan (development@jc-lab.net / http://ablog.jc-lab.net/ )
+ * @date	2026/10/18
+ * @copyright Copyright (C) 2026 jichan.\n
+ *            This software may be modified and distributed under the terms
+ *            of the Apache License 2.0.  See the LICENSE file for details.
+ */
+
+// Records written, reopened and read back, then a log with a torn record:
+// readers stop in front of it, and a writer reopening the log continues
+// there without any record after it coming back.
+// Exits with a non-zero status on the first failed check.
+
+#include "../Serializable.h"
+#include "../SerializableLog.h"
+
+#include <stdio.h>
+
+using namespace JsRPC;
+
+#define CHECK(expr) do { if (!(expr)) { fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #expr); return 1; } } while (0)
+
+static const char logPath[] = "SerializableLogTest.log";
+static const char indexPath[] = "SerializableLogTest.log.idx";
+
+class Entry : public Serializable
+{
+public:
+	SType<int32_t> number;
+	SType<std::string> text;
+	Entry() : Serializable("Entry", 1) {
+		serializableMapMember("number", number);
+		serializableMapMember("text", text);
+	}
+};
+
+// Numbers of the records in the log, in order
+static std::vector<int32_t> readAll()
+{
+	std::vector<int32_t> numbers;
+	SerializableLogReader reader;
+	Entry entry;
+	reader.open(logPath);
+	while (reader.next(entry))
+		numbers.push_back(*entry.number);
+	return numbers;
+}
+
+static bool sequence(const std::vector<int32_t> &numbers, int32_t count)
+{
+	int32_t i;
+	if (numbers.size() != (size_t)count)
+		return false;
+	for (i = 0; i < count; i++)
+	{
+		if (numbers[i] != i)
+			return false;
+	}
+	return true;
+}
+
+// Flips one payload byte of record number record
+static bool tear(uint64_t record)
+{
+	std::vector<unsigned char> file;
+	unsigned char chunk[4096];
+	size_t n;
+	size_t offset = 16;
+	uint32_t length;
+	FILE *fp = fopen(logPath, "rb");
+	if (!fp)
+		return false;
+	while ((n = fread(chunk, 1, sizeof(chunk), fp)) > 0)
+		file.insert(file.end(), chunk, chunk + n);
+	fclose(fp);
+
+	for (;;)
+	{
+		if (offset + 8 > file.size())
+			return false;
+		memcpy(&length, &file[offset], 4);
+		if (!length)
+			return false;
+		if (!record--)
+			break;
+		offset += (8 + (size_t)length + 7) & ~(size_t)7;
+	}
+	file[offset + 8 + length / 2] ^= 0x20;
+
+	fp = fopen(logPath, "r+b");
+	if (!fp)
+		return false;
+	n = fwrite(&file[0], 1, file.size(), fp);
+	fclose(fp);
+	return n == file.size();
+}
+
+int main()
+{
+	int32_t i;
+	remove(logPath);
+	remove(indexPath);
+
+	// Written, reopened for appending and read back, records of every
+	// padding length
+	{
+		SerializableLogWriter writer(4096, 1024, 8);
+		Entry entry;
+		writer.open(logPath);
+		for (i = 0; i < 20; i++)
+		{
+			entry.number = i;
+			entry.text = std::string((size_t)i, 'x');
+			CHECK(writer.append(entry) == (uint64_t)i);
+		}
+		writer.close();
+		writer.open(logPath);
+		CHECK(writer.recordCount() == 20);
+		entry.number = 20;
+		CHECK(writer.append(entry) == 20);
+	}
+	CHECK(sequence(readAll(), 21));
+
+	// A torn record past the last index entry, as a crash before sync()
+	// leaves it, ends the log with or without the index
+	CHECK(tear(18));
+	CHECK(sequence(readAll(), 18));
+	{
+		SerializableLogReader reader;
+		reader.open(logPath);
+		CHECK(reader.seek(17));
+		CHECK(!reader.seek(18));
+	}
+	remove(indexPath);
+	CHECK(sequence(readAll(), 18));
+
+	// The writer continues at the torn record and clears what followed it. The
+	// new record is as long as the torn one, so without the clearing records
+	// 19 and 20 would be read back behind it.
+	{
+		SerializableLogWriter writer(4096, 1024, 8);
+		Entry entry;
+		writer.open(logPath);
+		CHECK(writer.recordCount() == 18);
+		entry.number = 18;
+		entry.text = std::string(18, 'y');
+		CHECK(writer.append(entry) == 18);
+	}
+	CHECK(sequence(readAll(), 19));
+
+	remove(logPath);
+	remove(indexPath);
+	printf("SerializableLogTest: ok\n");
+	return 0;
+}
@@ -0,0 +1,222 @@
+/*
+* Licensed to the Apache Software Foundation (ASF) under one or more
+* contributor license agreements.  See the NOTICE file distributed with
+* this work for additional information regarding copyright ownership.
+* The ASF licenses this file to You under the Apache License, Version 2.0
+* (the "License"); you may not use this file except in compliance with
+* the License.  You may obtain a copy of the License at
+*
+*    http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+/**
+ * @file	SerializableMalformedTest.cpp
+ * @author	Jichan (development@jc-lab.net / http://ablog.jc-lab.net/ )
+ * @date	2026/10/18
+ * @copyright Copyright (C) 2026 jichan.\n
+ *            This software may be modified and distributed under the terms
+ *            of the Apache License 2.0.  See the LICENSE file for details.
+ */
+
+// Payloads whose member etypes disagree with the declared member types, in
+// plain, columnar and compressed form. Each must be rejected with a
+// ParseException before anything is written into the member.
+// Exits with a non-zero status on the first failed check.
+
+#include "../Serializable.h"
+#include "../BlockCompressor.h"
+
+#include <stdio.h>
+
+using namespace JsRPC;
+
+#define CHECK(expr) do { if (!(expr)) { fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #expr); return 1; } } while (0)
+
+static const char marker[] = "malformed-marker";
+
+class Row : public Serializable
+{
+public:
+	SType<std::string> text;
+	SType<int32_t> number;
+	Row() : Serializable("Row", 1) {
+		serializableMapMember("text", text);
+		serializableMapMember("number", number);
+		text = std::string(marker);
+		number = 7;
+	}
+};
+
+struct RowFactory : public SerializableCreateFactory
+{
+	Serializable *create() {
+		return new Row();
+	}
+};
+static RowFactory rowFactory;
+
+class Plain : public Serializable
+{
+public:
+	SType<std::string> text;
+	SType<std::vector<int32_t>> values;
+	Plain() : Serializable("Plain", 1) {
+		serializableMapMember("text", text);
+		serializableMapMember("values", values);
+		text = std::string(marker);
+		(*values).assign(4, 1);
+	}
+};
+
+class Batch : public Serializable
+{
+public:
+	SType<std::list<JsCPPUtils::SmartPointer<Serializable> > > rows;
+	Batch() : Serializable("Batch", 1) {
+		serializableMapMember("rows", rows);
+		rows.setCreateFactory(&rowFactory);
+		rows.setColumnar();
+		for (int i = 0; i < 3; i++)
+			(*rows).push_back(JsCPPUtils::SmartPointer<Serializable>(new Row()));
+	}
+};
+
+// Offset of the etype of the first string holding marker: the etype, the
+// element etype and the u32 length precede the characters.
+static size_t markerEtype(const std::vector<unsigned char> &payload)
+{
+	size_t length = sizeof(marker) - 1;
+	size_t i;
+	for (i = 8; i + length <= payload.size(); i++)
+	{
+		if (memcmp(&payload[i], marker, length) == 0)
+			return i - 8;
+	}
+	return 0;
+}
+
+static void writeEtype(std::vector<unsigned char> &payload, size_t pos, uint16_t etype)
+{
+	memcpy(&payload[pos], &etype, 2);
+}
+
+// Compresses the member data of a plain payload as one block, the layout
+// serialize() produces for a body below the block size.
+static bool compress(const std::vector<unsigned char> &plain, std::vector<unsigned char> &compressed)
+{
+	size_t headerSize;
+	size_t bodySize;
+	size_t size;
+	uint32_t word;
+	if (!Serializable::serializablePeekHeader(&plain[0], plain.size(), NULL, NULL, NULL, &headerSize))
+		return false;
+	bodySize = plain.size() - headerSize;
+	compressed.assign(plain.begin(), plain.begin() + headerSize);
+	compressed[4] |= Serializable::HEADER_FLAG_COMPRESSED;
+	compressed.resize(headerSize + 8 + internal::BlockCompressor::bound(bodySize));
+	size = internal::BlockCompressor::compress(&plain[headerSize], bodySize, &compressed[headerSize + 8], compressed.size() - headerSize - 8);
+	if (!size)
+		return false;
+	word = (uint32_t)bodySize;
+	memcpy(&compressed[headerSize], &word, 4);
+	word = (uint32_t)size;
+	memcpy(&compressed[headerSize + 4], &word, 4);
+	compressed.resize(headerSize + 8 + size);
+	return true;
+}
+
+template<typename T>
+static bool rejected(const std::vector<unsigned char> &payload)
+{
+	T target;
+	try {
+		target.deserialize(payload);
+	} catch (Serializable::ParseException&) {
+		return true;
+	}
+	return false;
+}
+
+template<typename T>
+static bool decodes(const std::vector<unsigned char> &payload)
+{
+	T target;
+	std::vector<unsigned char> again;
+	target.deserialize(payload);
+	target.serialize(again);
+	return again.size() > 0;
+}
+
+int main()
+{
+	// Etypes a string member must not be decoded as: a native of the same
+	// width, the element etype, and the container etypes
+	static const uint16_t wrong[] = { 0x0101, 0x0081, 0x0002, 0x0003, 0x0004, 0x0005, 0x0006, 0x0248, 0x8002 };
+	size_t i;
+
+	// Plain payload
+	{
+		Plain source;
+		std::vector<unsigned char> payload;
+		source.serialize(payload);
+		size_t pos = markerEtype(payload);
+		CHECK(pos > 0);
+		CHECK(decodes<Plain>(payload));
+		for (i = 0; i < sizeof(wrong) / sizeof(wrong[0]); i++)
+		{
+			std::vector<unsigned char> bad(payload);
+			writeEtype(bad, pos, wrong[i]);
+			CHECK(rejected<Plain>(bad));
+		}
+
+		// Element etypes inside the string and the vector
+		std::vector<unsigned char> bad(payload);
+		writeEtype(bad, pos + 2, 0x0082);
+		CHECK(rejected<Plain>(bad));
+		bad = payload;
+		writeEtype(bad, pos + 8 + sizeof(marker) - 1 + 2, 0x0048);
+		CHECK(rejected<Plain>(bad));
+	}
+
+	// Columnar rows are decoded member by member too
+	{
+		Batch source;
+		std::vector<unsigned char> payload;
+		source.serialize(payload);
+		size_t pos = markerEtype(payload);
+		CHECK(pos > 0);
+		CHECK(decodes<Batch>(payload));
+		for (i = 0; i < sizeof(wrong) / sizeof(wrong[0]); i++)
+		{
+			std::vector<unsigned char> bad(payload);
+			writeEtype(bad, pos, wrong[i]);
+			CHECK(rejected<Batch>(bad));
+		}
+	}
+
+	// Compressed payload, checked after it has been expanded
+	{
+		Plain source;
+		std::vector<unsigned char> payload;
+		std::vector<unsigned char> compressed;
+		source.serialize(payload);
+		size_t pos = markerEtype(payload);
+		CHECK(compress(payload, compressed));
+		CHECK(decodes<Plain>(compressed));
+		for (i = 0; i < sizeof(wrong) / sizeof(wrong[0]); i++)
+		{
+			std::vector<unsigned char> bad(payload);
+			writeEtype(bad, pos, wrong[i]);
+			CHECK(compress(bad, compressed));
+			CHECK(rejected<Plain>(compressed));
+		}
+	}
+
+	printf("SerializableMalformedTest: ok\n");
+	return 0;
+}
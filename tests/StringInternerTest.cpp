@@ -0,0 +1,273 @@
+/*
+* Licensed to the Apache Software Foundation (ASF) under one or more
+* contributor license agreements.  See the NOTICE file distributed with
+* this work for additional information regarding copyright ownership.
+* The ASF licenses this file to You under the Apache License, Version 2.0
+* (the "License"); you may not use this file except in compliance with
+* the License.  You may obtain a copy of the License at
+*
+*    http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+/**
+ * @file	StringInternerTest.cpp
+ * @author	Jichan (development@jc-lab.net / http://ablog.jc-lab.net/ )
+ * @date	2026/10/18
+ * @copyright Copyright (C) 2026 jichan.\n
+ *            This software may be modified and distributed under the terms
+ *            of the Apache License 2.0.  See the LICENSE file for details.
+ */
+
+// Interned payloads decode to what the plain encoding gives, with strings
+// repeated across lists, nested objects and columnar rows, alone and
+// together with compression and checksums. References that point nowhere
+// or expand too far must be rejected.
+// Exits with a non-zero status on the first failed check.
+
+#include "../Serializable.h"
+#include "../StringInterner.h"
+
+#include <stdio.h>
+
+using namespace JsRPC;
+
+#define CHECK(expr) do { if (!(expr)) { fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #expr); return 1; } } while (0)
+
+class Leaf : public Serializable
+{
+public:
+	SType<std::string> name;
+	SType<int32_t> number;
+	Leaf() : Serializable("Leaf", 1) {
+		serializableMapMember("name", name);
+		serializableMapMember("number", number);
+	}
+};
+
+struct LeafFactory : public SerializableCreateFactory
+{
+	Serializable *create() {
+		return new Leaf();
+	}
+};
+static LeafFactory leafFactory;
+
+class Tree : public Serializable
+{
+public:
+	SType<std::string> title;
+	SType<std::wstring> wideTitle;
+	SType<std::list<std::string> > tags;
+	SSerializableType<Leaf> first;
+	SType<std::list<JsCPPUtils::SmartPointer<Serializable> > > leaves;
+	SType<std::list<JsCPPUtils::SmartPointer<Serializable> > > rows;
+	Tree() : Serializable("Tree", 1) {
+		serializableMapMember("title", title);
+		serializableMapMember("wideTitle", wideTitle);
+		serializableMapMember("tags", tags);
+		serializableMapMember("first", first);
+		serializableMapMember("leaves", leaves);
+		leaves.setCreateFactory(&leafFactory);
+		serializableMapMember("rows", rows);
+		rows.setCreateFactory(&leafFactory);
+		rows.setColumnar();
+	}
+
+	void fill() {
+		static const char *names[] = { "north", "south", "", "north-east" };
+		int i;
+		title = std::string("north");
+		wideTitle = std::wstring(L"north");
+		for (i = 0; i < 12; i++)
+			(*tags).push_back(names[i % 4]);
+		(*first).name = std::string("south");
+		(*first).number = -1;
+		for (i = 0; i < 6; i++)
+		{
+			Leaf *leaf = new Leaf();
+			leaf->name = std::string(names[i % 4]);
+			leaf->number = i;
+			(*leaves).push_back(JsCPPUtils::SmartPointer<Serializable>(leaf));
+			leaf = new Leaf();
+			leaf->name = std::string(names[(i + 1) % 4]);
+			leaf->number = i * 10;
+			(*rows).push_back(JsCPPUtils::SmartPointer<Serializable>(leaf));
+		}
+	}
+};
+
+class Tags : public Serializable
+{
+public:
+	SType<std::list<std::string> > tags;
+	Tags() : Serializable("Tags", 1) {
+		serializableMapMember("tags", tags);
+	}
+};
+
+template<typename T>
+static bool rejected(const std::vector<unsigned char> &payload)
+{
+	T target;
+	try {
+		target.deserialize(payload);
+	} catch (Serializable::ParseException&) {
+		return true;
+	}
+	return false;
+}
+
+// Decodes payload and encodes the result plainly
+template<typename T>
+static bool decodesTo(const std::vector<unsigned char> &payload, const std::vector<unsigned char> &plain)
+{
+	T target;
+	std::vector<unsigned char> again;
+	target.deserialize(payload);
+	target.serialize(again);
+	return again == plain;
+}
+
+static void writeWord(std::vector<unsigned char> &payload, size_t pos, uint32_t word)
+{
+	memcpy(&payload[pos], &word, 4);
+}
+
+int main()
+{
+	size_t i;
+
+	// Round trips: interned alone, with checksums on every level, and compressed
+	{
+		Tree source;
+		std::vector<unsigned char> plain;
+		std::vector<unsigned char> interned;
+		std::vector<unsigned char> expanded;
+		SerializeOptions options;
+		source.fill();
+		source.serialize(plain);
+
+		options.internStrings = true;
+		source.serialize(interned, options);
+		CHECK(interned[4] == Serializable::HEADER_FLAG_STRING_TABLE);
+		CHECK(interned.size() < plain.size());
+		CHECK(decodesTo<Tree>(interned, plain));
+		CHECK(Serializable::serializableExpand(&interned[0], interned.size(), expanded));
+		CHECK(expanded == plain);
+
+		options.checksum = true;
+		options.checksumNested = true;
+		source.serialize(interned, options);
+		CHECK(interned[4] == (Serializable::HEADER_FLAG_STRING_TABLE | Serializable::HEADER_FLAG_CHECKSUM));
+		{
+			Tree decoded;
+			std::vector<unsigned char> again;
+			SerializeOptions nested;
+			nested.checksumNested = true;
+			decoded.deserialize(interned);
+			decoded.serialize(again, nested);
+			source.serialize(plain, nested);
+			CHECK(again == plain);
+		}
+
+		options.checksum = false;
+		options.checksumNested = false;
+		options.compressThreshold = 1;
+		source.serialize(plain);
+		source.serialize(interned, options);
+		CHECK(interned[4] == (Serializable::HEADER_FLAG_STRING_TABLE | Serializable::HEADER_FLAG_COMPRESSED));
+		CHECK(decodesTo<Tree>(interned, plain));
+	}
+
+	// Nothing repeats: the payload stays plain
+	{
+		Tags source;
+		std::vector<unsigned char> plain;
+		std::vector<unsigned char> interned;
+		SerializeOptions options;
+		(*source.tags).push_back("one");
+		(*source.tags).push_back("two");
+		(*source.tags).push_back("");
+		(*source.tags).push_back("");
+		source.serialize(plain);
+		options.internStrings = true;
+		source.serialize(interned, options);
+		CHECK(interned == plain);
+	}
+
+	// Malformed references. The payload ends with [5 "alpha"] [4 "beta"] [ref 0].
+	{
+		Tags source;
+		std::vector<unsigned char> interned;
+		std::vector<unsigned char> plain;
+		SerializeOptions options;
+		(*source.tags).push_back("alpha");
+		(*source.tags).push_back("beta");
+		(*source.tags).push_back("alpha");
+		source.serialize(plain);
+		options.internStrings = true;
+		source.serialize(interned, options);
+		size_t last = interned.size() - 4;
+		size_t firstString = last - 8 - 9;
+		CHECK(!memcmp(&interned[firstString + 4], "alpha", 5));
+		CHECK(decodesTo<Tags>(interned, plain));
+
+		// Reference 1 is "beta"; 2 has not been numbered
+		std::vector<unsigned char> bad(interned);
+		writeWord(bad, last, internal::StringInterner::REFERENCE | 1);
+		CHECK(!decodesTo<Tags>(bad, plain));
+		writeWord(bad, last, internal::StringInterner::REFERENCE | 2);
+		CHECK(rejected<Tags>(bad));
+		writeWord(bad, last, internal::StringInterner::REFERENCE | 0x7FFFFFFF);
+		CHECK(rejected<Tags>(bad));
+
+		// A reference before anything has been numbered
+		bad = interned;
+		writeWord(bad, firstString, internal::StringInterner::REFERENCE);
+		CHECK(rejected<Tags>(bad));
+
+		// A reference in a payload that does not use the string table
+		bad = plain;
+		writeWord(bad, bad.size() - 4 - 5, internal::StringInterner::REFERENCE);
+		CHECK(rejected<Tags>(bad));
+
+		// Every truncation
+		for (i = 0; i < interned.size(); i++)
+		{
+			std::vector<unsigned char> truncated(interned.begin(), interned.begin() + i);
+			CHECK(rejected<Tags>(truncated));
+		}
+	}
+
+	// A few kilobytes of references standing for twice the expansion limit
+	{
+		Tags source;
+		std::vector<unsigned char> interned;
+		std::vector<unsigned char> plain;
+		SerializeOptions options;
+		const size_t length = 64 * 1024;
+		const uint32_t references = (uint32_t)(2 * internal::StringInterner::EXPAND_MIN_LIMIT / length);
+		(*source.tags).push_back(std::string(length, 'z'));
+		(*source.tags).push_back(std::string(length, 'z'));
+		source.serialize(plain);
+		options.internStrings = true;
+		source.serialize(interned, options);
+		CHECK(decodesTo<Tags>(interned, plain));
+
+		// Raise the list count and repeat the reference at the end
+		unsigned char reference[4];
+		memcpy(reference, &interned[interned.size() - 4], 4);
+		writeWord(interned, interned.size() - 4 - length - 4 - 4, references + 1);
+		for (i = 1; i < references; i++)
+			interned.insert(interned.end(), reference, reference + 4);
+		CHECK(rejected<Tags>(interned));
+	}
+
+	printf("StringInternerTest: ok\n");
+	return 0;
+}